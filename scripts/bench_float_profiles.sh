@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Builds the interpreter with both float profiles (optimised, without
+# sanitizers) and times a float-heavy script with each.
+#
+# Usage: scripts/bench_float_profiles.sh [script.flv] [runs]
+# Set CC to use a compiler other than clang.
+
+# Exit immediately if a command exits with a non-zero status
+set -e
+
+# Colors and formatting
+RESET="\033[0m"
+BOLD="\033[1m"
+
+SRC_DIR="$(cd "$(dirname "$0")/../src" && pwd)"
+SCRIPT="${1:-$SRC_DIR/benchmarks/floats.flv}"
+RUNS="${2:-3}"
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+for PROFILE in double long; do
+    echo -e "${BOLD}Building the \`$PROFILE\` profile...${RESET}"
+    make -C "$SRC_DIR" -s CC="${CC:-clang}" GITHUB_ACTIONS=true EXTRA_CFLAGS=-O2 \
+        FLOAT_PROFILE="$PROFILE" OBJ_DIR="$BUILD_DIR/obj_$PROFILE" \
+        BIN="$BUILD_DIR/flavor_$PROFILE" >"$BUILD_DIR/build.log" 2>&1 ||
+        { cat "$BUILD_DIR/build.log"; exit 1; }
+done
+
+TIMEFORMAT="%R s"
+
+for PROFILE in double long; do
+    echo ""
+    echo -e "${BOLD}Profile: $PROFILE${RESET}"
+    for ((i = 1; i <= RUNS; i++)); do
+        echo -n "  Run $i: "
+        time "$BUILD_DIR/flavor_$PROFILE" "$SCRIPT" >/dev/null
+    done
+done
@@ -0,0 +1,310 @@
+#include "array.h"
+#include "../shared/data_types.h"
+#include "gc.h"
+#include "parallel.h"
+
+size_t array_element_size(ArrayKind kind) {
+    switch (kind) {
+    case ARRAY_INT:
+        return sizeof(INT_SIZE);
+    case ARRAY_FLOAT:
+        return sizeof(FLOAT_SIZE);
+    case ARRAY_BOOL:
+        return sizeof(bool);
+    default:
+        return sizeof(LiteralValue);
+    }
+}
+
+// Slots start zeroed, so the collector can trace a whole boxed buffer
+static ArrayBuffer *array_buffer_new(ArrayKind kind, size_t capacity) {
+    size_t size = sizeof(ArrayBuffer) + capacity * array_element_size(kind);
+    ArrayBuffer *buffer = gc_alloc(GC_ARRAY_BUFFER, size);
+    memset(buffer, 0, size);
+    buffer->capacity = capacity;
+    buffer->kind = kind;
+    return buffer;
+}
+
+ArrayValue array_new(size_t capacity) {
+    ArrayValue array;
+    array.buffer = capacity ? array_buffer_new(ARRAY_BOXED, capacity) : NULL;
+    array.offset = 0;
+    array.step = 1;
+    array.count = 0;
+    array.owner = 0;
+    return array;
+}
+
+// Typed arrays always have a buffer, since that's where the kind is kept
+ArrayValue array_new_typed(ArrayKind kind, size_t capacity) {
+    ArrayValue array = array_new(0);
+    array.buffer = array_buffer_new(
+        kind, capacity > ARRAY_MIN_CAPACITY ? capacity : ARRAY_MIN_CAPACITY);
+    return array;
+}
+
+/**
+ * @brief Moves an array into its own heap object, so a `LiteralValue` only
+ * holds a pointer to it.
+ *
+ * Every copy of the value shares the box, so changes made through one (like
+ * `xs[^+] = x`) are seen through all of them.
+ */
+ArrayValue *array_box(ArrayValue array) {
+    ArrayValue *box = gc_alloc(GC_ARRAY, sizeof(ArrayValue));
+    *box = array;
+    box->owner = parallel_task_owner();
+    return box;
+}
+
+// Parallel tasks may read any array, but only modify arrays they created
+bool array_writable(const ArrayValue *array) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || array->owner == owner;
+}
+
+ArrayKind array_kind(const ArrayValue *array) {
+    return array->buffer ? array->buffer->kind : ARRAY_BOXED;
+}
+
+bool array_kind_accepts(ArrayKind kind, LiteralValue value) {
+    switch (kind) {
+    case ARRAY_INT:
+        return value.type == TYPE_INTEGER;
+    case ARRAY_FLOAT:
+        return value.type == TYPE_FLOAT;
+    case ARRAY_BOOL:
+        return value.type == TYPE_BOOLEAN;
+    default:
+        return true;
+    }
+}
+
+// Maps a (possibly negative or out of range) slot number into the buffer
+static size_t array_wrap(const ArrayBuffer *buffer, ptrdiff_t slot) {
+    ptrdiff_t capacity = (ptrdiff_t)buffer->capacity;
+    slot %= capacity;
+    return (size_t)(slot < 0 ? slot + capacity : slot);
+}
+
+/**
+ * @brief Returns the slot holding element `index`.
+ *
+ * Buffers are used as ring buffers, so elements wrap around from the last
+ * slot to the first.
+ */
+static size_t array_slot_index(const ArrayValue *array, size_t index) {
+    if (array->step == 1) {
+        size_t slot = array->offset + index;
+        if (slot >= array->buffer->capacity) {
+            slot -= array->buffer->capacity;
+        }
+        return slot;
+    }
+    return array_wrap(array->buffer, (ptrdiff_t)array->offset +
+                                         (ptrdiff_t)index * array->step);
+}
+
+static LiteralValue array_load(const ArrayBuffer *buffer, size_t slot) {
+    LiteralValue value;
+    switch (buffer->kind) {
+    case ARRAY_INT:
+        value.type = TYPE_INTEGER;
+        value.data.integer = ((const INT_SIZE *)buffer->items)[slot];
+        return value;
+    case ARRAY_FLOAT:
+        value.type = TYPE_FLOAT;
+        value.data.floating_point = ((const FLOAT_SIZE *)buffer->items)[slot];
+        return value;
+    case ARRAY_BOOL:
+        value.type = TYPE_BOOLEAN;
+        value.data.boolean = ((const bool *)buffer->items)[slot];
+        return value;
+    default:
+        return buffer->items[slot];
+    }
+}
+
+// `value` must be accepted by the buffer's kind
+static void array_store(ArrayBuffer *buffer, size_t slot, LiteralValue value) {
+    switch (buffer->kind) {
+    case ARRAY_INT:
+        ((INT_SIZE *)buffer->items)[slot] = value.data.integer;
+        break;
+    case ARRAY_FLOAT:
+        ((FLOAT_SIZE *)buffer->items)[slot] = value.data.floating_point;
+        break;
+    case ARRAY_BOOL:
+        ((bool *)buffer->items)[slot] = value.data.boolean;
+        break;
+    default:
+        buffer->items[slot] = value;
+        break;
+    }
+}
+
+LiteralValue array_get(const ArrayValue *array, size_t index) {
+    return array_load(array->buffer, array_slot_index(array, index));
+}
+
+// Returns NULL for typed arrays, whose elements aren't LiteralValues
+LiteralValue *array_slot(ArrayValue *array, size_t index) {
+    if (array->buffer->kind != ARRAY_BOXED) {
+        return NULL;
+    }
+    return &array->buffer->items[array_slot_index(array, index)];
+}
+
+// Typed arrays with step 1 can be processed as plain C arrays
+bool array_is_dense(const ArrayValue *array) {
+    return array->buffer && array->buffer->kind != ARRAY_BOXED &&
+           array->step == 1;
+}
+
+/**
+ * @brief Returns the storage of element `index` of a dense array, and sets
+ * `run` to how many elements (from `index` on) are contiguous. A ring buffer
+ * that wraps around is stored as two runs.
+ */
+const void *array_dense_run(const ArrayValue *array, size_t index,
+                            size_t *run) {
+    size_t slot = array_slot_index(array, index);
+    size_t until_end = array->buffer->capacity - slot;
+    size_t remaining = array->count - index;
+    *run = remaining < until_end ? remaining : until_end;
+    return (const char *)array->buffer->items +
+           slot * array_element_size(array->buffer->kind);
+}
+
+/**
+ * @brief Returns a view of `count` elements starting at `start`, `step` apart.
+ *
+ * No elements are copied. The buffer is marked shared, so whichever of the
+ * base array or the view is written to first gets its own copy.
+ */
+ArrayValue array_slice(const ArrayValue *array, size_t start, ptrdiff_t step,
+                       size_t count) {
+    if (count == 0) {
+        ArrayKind kind = array_kind(array);
+        return kind == ARRAY_BOXED ? array_new(0) : array_new_typed(kind, 0);
+    }
+
+    ArrayValue view = *array;
+    view.offset = array_slot_index(array, start);
+    view.step = array->step * step;
+    view.count = count;
+    view.buffer->shared = true;
+    return view;
+}
+
+// Copies the elements into a new, unshared buffer of at least `capacity`
+static void array_move_to_new_buffer(ArrayValue *array, size_t capacity,
+                                     ArrayKind kind) {
+    if (capacity < ARRAY_MIN_CAPACITY) {
+        capacity = ARRAY_MIN_CAPACITY;
+    }
+
+    ArrayBuffer *buffer = array_buffer_new(kind, capacity);
+    for (size_t i = 0; i < array->count; i++) {
+        array_store(buffer, i, array_get(array, i));
+    }
+
+    // The old buffer is left to the collector since others may share it
+    array->buffer = buffer;
+    array->offset = 0;
+    array->step = 1;
+}
+
+/**
+ * @brief Materialises views & shared buffers so `array` can be written to
+ * without affecting any other array value.
+ */
+void array_make_writable(ArrayValue *array) {
+    if (!array->buffer) {
+        array->buffer = array_buffer_new(ARRAY_BOXED, ARRAY_MIN_CAPACITY);
+        array->offset = 0;
+        array->step = 1;
+    } else if (array->buffer->shared || array->step != 1) {
+        array_move_to_new_buffer(array, array->count, array->buffer->kind);
+    }
+}
+
+// Makes `array` writable & able to hold `value`, with room for `extra` more
+// elements
+static void array_prepare_store(ArrayValue *array, LiteralValue value,
+                                size_t extra) {
+    array_make_writable(array);
+
+    size_t capacity = array->buffer->capacity;
+    if (array->count + extra > capacity) {
+        capacity *= 2;
+    }
+
+    // Transparently fall back to a generic array
+    ArrayKind kind = array->buffer->kind;
+    if (!array_kind_accepts(kind, value)) {
+        kind = ARRAY_BOXED;
+    }
+
+    if (capacity != array->buffer->capacity || kind != array->buffer->kind) {
+        array_move_to_new_buffer(array, capacity, kind);
+    }
+}
+
+void array_set(ArrayValue *array, size_t index, LiteralValue value) {
+    array_prepare_store(array, value, 0);
+    array_store(array->buffer, array_slot_index(array, index), value);
+}
+
+// Both ends have free slots available until the ring is full, so pushing
+// onto either end is amortised O(1)
+void array_push(ArrayValue *array, LiteralValue value) {
+    array_prepare_store(array, value, 1);
+    array_store(array->buffer, array_slot_index(array, array->count), value);
+    array->count++;
+}
+
+void array_prepend(ArrayValue *array, LiteralValue value) {
+    array_prepare_store(array, value, 1);
+    array->offset = array_wrap(array->buffer, (ptrdiff_t)array->offset - 1);
+    array_store(array->buffer, array->offset, value);
+    array->count++;
+}
+
+// Removing from either end only narrows the visible range, so even views
+// don't need copying
+LiteralValue array_pop(ArrayValue *array) {
+    LiteralValue removed = array_get(array, array->count - 1);
+    array->count--;
+    return removed;
+}
+
+LiteralValue array_shift(ArrayValue *array) {
+    LiteralValue removed = array_get(array, 0);
+    array->offset =
+        array_wrap(array->buffer, (ptrdiff_t)array->offset + array->step);
+    array->count--;
+    return removed;
+}
+
+// Arrays of the same typed kind stay typed; anything else becomes generic
+ArrayValue array_concat(const ArrayValue *left, const ArrayValue *right) {
+    ArrayKind kind = array_kind(left);
+    if (left->count == 0) {
+        kind = array_kind(right);
+    } else if (right->count > 0 && array_kind(right) != kind) {
+        kind = ARRAY_BOXED;
+    }
+
+    size_t count = left->count + right->count;
+    ArrayValue result = kind == ARRAY_BOXED ? array_new(count)
+                                            : array_new_typed(kind, count);
+    for (size_t i = 0; i < left->count; i++) {
+        array_store(result.buffer, result.count++, array_get(left, i));
+    }
+    for (size_t i = 0; i < right->count; i++) {
+        array_store(result.buffer, result.count++, array_get(right, i));
+    }
+    return result;
+}
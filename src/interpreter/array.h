@@ -0,0 +1,39 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Smallest buffer allocated for an array that is about to hold elements
+#define ARRAY_MIN_CAPACITY 4
+
+// Creation
+ArrayValue array_new(size_t capacity);
+ArrayValue array_new_typed(ArrayKind kind, size_t capacity);
+ArrayValue *array_box(ArrayValue array);
+bool array_writable(const ArrayValue *array);
+ArrayValue array_concat(const ArrayValue *left, const ArrayValue *right);
+ArrayValue array_slice(const ArrayValue *array, size_t start, ptrdiff_t step,
+                       size_t count);
+
+// Access (indices must already be bounds-checked)
+ArrayKind array_kind(const ArrayValue *array);
+size_t array_element_size(ArrayKind kind);
+bool array_kind_accepts(ArrayKind kind, LiteralValue value);
+LiteralValue array_get(const ArrayValue *array, size_t index);
+LiteralValue *array_slot(ArrayValue *array, size_t index);
+bool array_is_dense(const ArrayValue *array);
+const void *array_dense_run(const ArrayValue *array, size_t index,
+                            size_t *run);
+
+// Mutation (each first gives `array` a buffer it may write to, boxing typed
+// arrays when given a value they can't hold)
+void array_make_writable(ArrayValue *array);
+void array_set(ArrayValue *array, size_t index, LiteralValue value);
+void array_push(ArrayValue *array, LiteralValue value);
+void array_prepend(ArrayValue *array, LiteralValue value);
+LiteralValue array_pop(ArrayValue *array);
+LiteralValue array_shift(ArrayValue *array);
+
+#endif
@@ -0,0 +1,499 @@
+#include "array_ops.h"
+#include "../shared/data_types.h"
+#include "flavor_string.h"
+
+// ==================================================
+// NUMBERS
+// ==================================================
+
+bool literal_is_number(LiteralValue value) {
+    return value.type == TYPE_INTEGER || value.type == TYPE_FLOAT;
+}
+
+static FLOAT_SIZE number_as_float(LiteralValue value) {
+    return value.type == TYPE_INTEGER ? (FLOAT_SIZE)value.data.integer
+                                      : value.data.floating_point;
+}
+
+// Integers stay integers unless combined with a float, as with `+` & `*`
+static LiteralValue combine_numbers(LiteralValue left, LiteralValue right,
+                                    bool multiply) {
+    LiteralValue result;
+    if (left.type == TYPE_INTEGER && right.type == TYPE_INTEGER) {
+        result.type = TYPE_INTEGER;
+        result.data.integer =
+            multiply ? left.data.integer * right.data.integer
+                     : left.data.integer + right.data.integer;
+    } else {
+        FLOAT_SIZE l = number_as_float(left);
+        FLOAT_SIZE r = number_as_float(right);
+        result.type = TYPE_FLOAT;
+        result.data.floating_point = multiply ? l * r : l + r;
+    }
+    return result;
+}
+
+int compare_numbers(LiteralValue left, LiteralValue right) {
+    if (left.type == TYPE_INTEGER && right.type == TYPE_INTEGER) {
+        return (left.data.integer > right.data.integer) -
+               (left.data.integer < right.data.integer);
+    }
+    FLOAT_SIZE l = number_as_float(left);
+    FLOAT_SIZE r = number_as_float(right);
+    return (l > r) - (l < r);
+}
+
+// Matches `==`: numbers compare by value, otherwise types must match
+static bool values_equal(LiteralValue left, LiteralValue right) {
+    if (literal_is_number(left) && literal_is_number(right)) {
+        return compare_numbers(left, right) == 0;
+    }
+    if (left.type != right.type) {
+        return false;
+    }
+    switch (left.type) {
+    case TYPE_BOOLEAN:
+        return left.data.boolean == right.data.boolean;
+    case TYPE_STRING:
+        return fl_string_equals(left.data.string, right.data.string);
+    default:
+        return false;
+    }
+}
+
+static ArrayValue dense_result(ArrayKind kind, size_t count) {
+    ArrayValue result = array_new_typed(kind, count);
+    result.count = count;
+    return result;
+}
+
+// ==================================================
+// KERNELS
+// ==================================================
+
+// Separate accumulators break the dependency between additions, so the
+// compiler can keep several in flight (or vectorise the integer ones)
+static INT_SIZE sum_ints(const INT_SIZE *xs, size_t n) {
+    INT_SIZE s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += xs[i];
+        s1 += xs[i + 1];
+        s2 += xs[i + 2];
+        s3 += xs[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += xs[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+static FLOAT_SIZE sum_floats(const FLOAT_SIZE *xs, size_t n) {
+    FLOAT_SIZE s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += xs[i];
+        s1 += xs[i + 1];
+        s2 += xs[i + 2];
+        s3 += xs[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += xs[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+static INT_SIZE dot_ints(const INT_SIZE *xs, const INT_SIZE *ys, size_t n) {
+    INT_SIZE s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += xs[i] * ys[i];
+        s1 += xs[i + 1] * ys[i + 1];
+        s2 += xs[i + 2] * ys[i + 2];
+        s3 += xs[i + 3] * ys[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += xs[i] * ys[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+static FLOAT_SIZE dot_floats(const FLOAT_SIZE *xs, const FLOAT_SIZE *ys,
+                             size_t n) {
+    FLOAT_SIZE s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += xs[i] * ys[i];
+        s1 += xs[i + 1] * ys[i + 1];
+        s2 += xs[i + 2] * ys[i + 2];
+        s3 += xs[i + 3] * ys[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += xs[i] * ys[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+// ==================================================
+// REDUCTIONS
+// ==================================================
+
+/**
+ * @brief Adds up an array of numbers. The sum is an integer if every element
+ * is one, and a float otherwise (an empty array sums to `0`).
+ */
+bool array_sum(const ArrayValue *array, LiteralValue *out) {
+    ArrayKind kind = array_kind(array);
+    if (array_is_dense(array) && kind != ARRAY_BOOL) {
+        if (kind == ARRAY_INT) {
+            INT_SIZE total = 0;
+            for (size_t i = 0, run; i < array->count; i += run) {
+                const INT_SIZE *xs = array_dense_run(array, i, &run);
+                total += sum_ints(xs, run);
+            }
+            out->type = TYPE_INTEGER;
+            out->data.integer = total;
+        } else {
+            FLOAT_SIZE total = 0;
+            for (size_t i = 0, run; i < array->count; i += run) {
+                const FLOAT_SIZE *xs = array_dense_run(array, i, &run);
+                total += sum_floats(xs, run);
+            }
+            out->type = TYPE_FLOAT;
+            out->data.floating_point = total;
+        }
+        return true;
+    }
+
+    LiteralValue total = {.type = TYPE_INTEGER, .data.integer = 0};
+    for (size_t i = 0; i < array->count; i++) {
+        LiteralValue element = array_get(array, i);
+        if (!literal_is_number(element)) {
+            return false;
+        }
+        total = combine_numbers(total, element, false);
+    }
+    *out = total;
+    return true;
+}
+
+// Finds the smallest (or largest) element of a non-empty array of numbers,
+// keeping its type
+bool array_extreme(const ArrayValue *array, bool want_max, LiteralValue *out) {
+    ArrayKind kind = array_kind(array);
+    if (array_is_dense(array) && kind == ARRAY_INT) {
+        size_t run;
+        INT_SIZE best = *(const INT_SIZE *)array_dense_run(array, 0, &run);
+        for (size_t i = 0; i < array->count; i += run) {
+            const INT_SIZE *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                if (want_max ? xs[j] > best : xs[j] < best) {
+                    best = xs[j];
+                }
+            }
+        }
+        out->type = TYPE_INTEGER;
+        out->data.integer = best;
+        return true;
+    }
+    if (array_is_dense(array) && kind == ARRAY_FLOAT) {
+        size_t run;
+        FLOAT_SIZE best = *(const FLOAT_SIZE *)array_dense_run(array, 0, &run);
+        for (size_t i = 0; i < array->count; i += run) {
+            const FLOAT_SIZE *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                if (want_max ? xs[j] > best : xs[j] < best) {
+                    best = xs[j];
+                }
+            }
+        }
+        out->type = TYPE_FLOAT;
+        out->data.floating_point = best;
+        return true;
+    }
+
+    LiteralValue best = array_get(array, 0);
+    for (size_t i = 0; i < array->count; i++) {
+        LiteralValue element = array_get(array, i);
+        if (!literal_is_number(element)) {
+            return false;
+        }
+        int order = compare_numbers(element, best);
+        if (want_max ? order > 0 : order < 0) {
+            best = element;
+        }
+    }
+    *out = best;
+    return true;
+}
+
+// Both arrays must have the same length
+bool array_dot(const ArrayValue *left, const ArrayValue *right,
+               LiteralValue *out) {
+    ArrayKind kind = array_kind(left);
+    if (array_is_dense(left) && array_is_dense(right) &&
+        kind == array_kind(right) && kind != ARRAY_BOOL) {
+        INT_SIZE int_total = 0;
+        FLOAT_SIZE float_total = 0;
+        for (size_t i = 0, run, right_run; i < left->count; i += run) {
+            const void *xs = array_dense_run(left, i, &run);
+            const void *ys = array_dense_run(right, i, &right_run);
+            if (right_run < run) {
+                run = right_run;
+            }
+            if (kind == ARRAY_INT) {
+                int_total += dot_ints(xs, ys, run);
+            } else {
+                float_total += dot_floats(xs, ys, run);
+            }
+        }
+        if (kind == ARRAY_INT) {
+            out->type = TYPE_INTEGER;
+            out->data.integer = int_total;
+        } else {
+            out->type = TYPE_FLOAT;
+            out->data.floating_point = float_total;
+        }
+        return true;
+    }
+
+    LiteralValue total = {.type = TYPE_INTEGER, .data.integer = 0};
+    for (size_t i = 0; i < left->count; i++) {
+        LiteralValue x = array_get(left, i);
+        LiteralValue y = array_get(right, i);
+        if (!literal_is_number(x) || !literal_is_number(y)) {
+            return false;
+        }
+        total = combine_numbers(total, combine_numbers(x, y, true), false);
+    }
+    *out = total;
+    return true;
+}
+
+// Whether `value` can be compared directly against a dense array's storage
+static bool dense_accepts(const ArrayValue *array, LiteralValue value) {
+    return array_is_dense(array) &&
+           array_kind_accepts(array_kind(array), value);
+}
+
+size_t array_count_equal(const ArrayValue *array, LiteralValue value) {
+    size_t matches = 0;
+    if (dense_accepts(array, value)) {
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const void *xs = array_dense_run(array, i, &run);
+            switch (array_kind(array)) {
+            case ARRAY_INT:
+                for (size_t j = 0; j < run; j++) {
+                    matches +=
+                        ((const INT_SIZE *)xs)[j] == value.data.integer;
+                }
+                break;
+            case ARRAY_FLOAT:
+                for (size_t j = 0; j < run; j++) {
+                    matches += ((const FLOAT_SIZE *)xs)[j] ==
+                               value.data.floating_point;
+                }
+                break;
+            default:
+                for (size_t j = 0; j < run; j++) {
+                    matches += ((const bool *)xs)[j] == value.data.boolean;
+                }
+                break;
+            }
+        }
+        return matches;
+    }
+
+    for (size_t i = 0; i < array->count; i++) {
+        matches += values_equal(array_get(array, i), value);
+    }
+    return matches;
+}
+
+// Returns the index of the first element equal to `value`, or -1
+ptrdiff_t array_index_of(const ArrayValue *array, LiteralValue value) {
+    if (dense_accepts(array, value)) {
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const void *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                bool found;
+                switch (array_kind(array)) {
+                case ARRAY_INT:
+                    found = ((const INT_SIZE *)xs)[j] == value.data.integer;
+                    break;
+                case ARRAY_FLOAT:
+                    found = ((const FLOAT_SIZE *)xs)[j] ==
+                            value.data.floating_point;
+                    break;
+                default:
+                    found = ((const bool *)xs)[j] == value.data.boolean;
+                    break;
+                }
+                if (found) {
+                    return (ptrdiff_t)(i + j);
+                }
+            }
+        }
+        return -1;
+    }
+
+    for (size_t i = 0; i < array->count; i++) {
+        if (values_equal(array_get(array, i), value)) {
+            return (ptrdiff_t)i;
+        }
+    }
+    return -1;
+}
+
+// ==================================================
+// TRANSFORMS
+// ==================================================
+
+/**
+ * @brief Multiplies (or adds) every element by a number. Typed arrays give
+ * typed results: integer arrays stay integers unless `operand` is a float.
+ */
+static bool array_map_number(const ArrayValue *array, LiteralValue operand,
+                             bool multiply, ArrayValue *out) {
+    if (!literal_is_number(operand)) {
+        return false;
+    }
+
+    ArrayKind kind = array_kind(array);
+    if (array_is_dense(array) && kind == ARRAY_INT &&
+        operand.type == TYPE_INTEGER) {
+        *out = dense_result(ARRAY_INT, array->count);
+        INT_SIZE *dst = (INT_SIZE *)out->buffer->items;
+        INT_SIZE k = operand.data.integer;
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const INT_SIZE *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                dst[i + j] = multiply ? xs[j] * k : xs[j] + k;
+            }
+        }
+        return true;
+    }
+    if (array_is_dense(array) && kind != ARRAY_BOOL) {
+        *out = dense_result(ARRAY_FLOAT, array->count);
+        FLOAT_SIZE *dst = (FLOAT_SIZE *)out->buffer->items;
+        FLOAT_SIZE k = number_as_float(operand);
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const void *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                FLOAT_SIZE x = kind == ARRAY_INT
+                                   ? (FLOAT_SIZE)((const INT_SIZE *)xs)[j]
+                                   : ((const FLOAT_SIZE *)xs)[j];
+                dst[i + j] = multiply ? x * k : x + k;
+            }
+        }
+        return true;
+    }
+
+    *out = array_new(array->count);
+    for (size_t i = 0; i < array->count; i++) {
+        LiteralValue element = array_get(array, i);
+        if (!literal_is_number(element)) {
+            return false;
+        }
+        array_push(out, combine_numbers(element, operand, multiply));
+    }
+    return true;
+}
+
+bool array_scale(const ArrayValue *array, LiteralValue factor,
+                 ArrayValue *out) {
+    return array_map_number(array, factor, true, out);
+}
+
+bool array_add_scalar(const ArrayValue *array, LiteralValue addend,
+                      ArrayValue *out) {
+    return array_map_number(array, addend, false, out);
+}
+
+// Both arrays must have the same length
+bool array_add(const ArrayValue *left, const ArrayValue *right,
+               ArrayValue *out) {
+    ArrayKind kind = array_kind(left);
+    if (array_is_dense(left) && array_is_dense(right) &&
+        kind == array_kind(right) && kind != ARRAY_BOOL) {
+        *out = dense_result(kind, left->count);
+        for (size_t i = 0, run, right_run; i < left->count; i += run) {
+            const void *xs = array_dense_run(left, i, &run);
+            const void *ys = array_dense_run(right, i, &right_run);
+            if (right_run < run) {
+                run = right_run;
+            }
+            if (kind == ARRAY_INT) {
+                INT_SIZE *dst = (INT_SIZE *)out->buffer->items + i;
+                for (size_t j = 0; j < run; j++) {
+                    dst[j] = ((const INT_SIZE *)xs)[j] +
+                             ((const INT_SIZE *)ys)[j];
+                }
+            } else {
+                FLOAT_SIZE *dst = (FLOAT_SIZE *)out->buffer->items + i;
+                for (size_t j = 0; j < run; j++) {
+                    dst[j] = ((const FLOAT_SIZE *)xs)[j] +
+                             ((const FLOAT_SIZE *)ys)[j];
+                }
+            }
+        }
+        return true;
+    }
+
+    *out = array_new(left->count);
+    for (size_t i = 0; i < left->count; i++) {
+        LiteralValue x = array_get(left, i);
+        LiteralValue y = array_get(right, i);
+        if (!literal_is_number(x) || !literal_is_number(y)) {
+            return false;
+        }
+        array_push(out, combine_numbers(x, y, false));
+    }
+    return true;
+}
+
+// Limits every element to [low, high] (which must be numbers, low <= high)
+bool array_clamp(const ArrayValue *array, LiteralValue low, LiteralValue high,
+                 ArrayValue *out) {
+    ArrayKind kind = array_kind(array);
+    if (array_is_dense(array) && kind == ARRAY_INT &&
+        low.type == TYPE_INTEGER && high.type == TYPE_INTEGER) {
+        *out = dense_result(ARRAY_INT, array->count);
+        INT_SIZE *dst = (INT_SIZE *)out->buffer->items;
+        INT_SIZE lo = low.data.integer, hi = high.data.integer;
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const INT_SIZE *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                dst[i + j] = xs[j] < lo ? lo : xs[j] > hi ? hi : xs[j];
+            }
+        }
+        return true;
+    }
+    if (array_is_dense(array) && kind == ARRAY_FLOAT) {
+        *out = dense_result(ARRAY_FLOAT, array->count);
+        FLOAT_SIZE *dst = (FLOAT_SIZE *)out->buffer->items;
+        FLOAT_SIZE lo = number_as_float(low), hi = number_as_float(high);
+        for (size_t i = 0, run; i < array->count; i += run) {
+            const FLOAT_SIZE *xs = array_dense_run(array, i, &run);
+            for (size_t j = 0; j < run; j++) {
+                dst[i + j] = xs[j] < lo ? lo : xs[j] > hi ? hi : xs[j];
+            }
+        }
+        return true;
+    }
+
+    *out = array_new(array->count);
+    for (size_t i = 0; i < array->count; i++) {
+        LiteralValue element = array_get(array, i);
+        if (!literal_is_number(element)) {
+            return false;
+        }
+        if (compare_numbers(element, low) < 0) {
+            element = low;
+        } else if (compare_numbers(element, high) > 0) {
+            element = high;
+        }
+        array_push(out, element);
+    }
+    return true;
+}
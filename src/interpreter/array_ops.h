@@ -0,0 +1,35 @@
+#ifndef ARRAY_OPS_H
+#define ARRAY_OPS_H
+
+#include "array.h"
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Native whole-array operations. Dense typed arrays run tight loops over
+// their storage; anything else falls back to checking each element. The
+// functions returning `bool` give false if an element isn't a number.
+
+// Reductions
+bool array_sum(const ArrayValue *array, LiteralValue *out);
+bool array_extreme(const ArrayValue *array, bool want_max, LiteralValue *out);
+bool array_dot(const ArrayValue *left, const ArrayValue *right,
+               LiteralValue *out);
+size_t array_count_equal(const ArrayValue *array, LiteralValue value);
+ptrdiff_t array_index_of(const ArrayValue *array, LiteralValue value);
+
+// Element-wise transforms (each result is a new array)
+bool array_scale(const ArrayValue *array, LiteralValue factor,
+                 ArrayValue *out);
+bool array_add_scalar(const ArrayValue *array, LiteralValue addend,
+                      ArrayValue *out);
+bool array_add(const ArrayValue *left, const ArrayValue *right,
+               ArrayValue *out);
+bool array_clamp(const ArrayValue *array, LiteralValue low, LiteralValue high,
+                 ArrayValue *out);
+
+// Helpers
+bool literal_is_number(LiteralValue value);
+int compare_numbers(LiteralValue left, LiteralValue right);
+
+#endif
@@ -0,0 +1,142 @@
+#include "bindings.h"
+#include "../parser/utils.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// How many places in the loaded program (the script & every module imported
+// so far) bind each name as a variable: declarations, assignments,
+// parameters, loop variables & rescue variables. Declaring a function or a
+// record doesn't count, since that binds the name to itself.
+typedef struct {
+    char *name;
+    size_t count;
+} Binding;
+
+// Open addressing; modules can be imported from parallel tasks, so the table
+// is locked
+static Binding *bindings = NULL;
+static size_t bindings_capacity = 0;
+static size_t bindings_used = 0;
+static pthread_mutex_t bindings_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t bindings_hash(const char *name) {
+    uint64_t hash = 1469598103934665603ULL; // FNV-1a
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+// The slot holding `name`, or the empty one it would go in
+static Binding *bindings_slot(Binding *table, size_t capacity,
+                              const char *name) {
+    size_t i = bindings_hash(name) & (capacity - 1);
+    while (table[i].name && strcmp(table[i].name, name) != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &table[i];
+}
+
+static void bindings_add(const char *name) {
+    if (!name) {
+        return;
+    }
+    if ((bindings_used + 1) * 2 > bindings_capacity) {
+        size_t capacity = bindings_capacity ? bindings_capacity * 2 : 64;
+        Binding *table = calloc(capacity, sizeof(Binding));
+        if (!table) {
+            fatal_error("Memory allocation failed for the binding table.\n");
+        }
+        for (size_t i = 0; i < bindings_capacity; i++) {
+            if (bindings[i].name) {
+                *bindings_slot(table, capacity, bindings[i].name) =
+                    bindings[i];
+            }
+        }
+        free(bindings);
+        bindings = table;
+        bindings_capacity = capacity;
+    }
+
+    Binding *slot = bindings_slot(bindings, bindings_capacity, name);
+    if (!slot->name) {
+        slot->name = safe_strdup(name);
+        bindings_used++;
+    }
+    slot->count++;
+}
+
+static void bindings_collect(ASTNode **slot, void *context) {
+    ASTNode *node = *slot;
+    switch (node->type) {
+    case AST_VAR_DECLARATION:
+        bindings_add(node->var_declaration.variable_name);
+        break;
+    case AST_CONST_DECLARATION:
+        bindings_add(node->const_declaration.constant_name);
+        break;
+    case AST_ASSIGNMENT:
+        if (node->assignment.lhs->type == AST_VARIABLE_REFERENCE) {
+            bindings_add(node->assignment.lhs->variable_name);
+        }
+        break;
+    case AST_FUNCTION_DECLARATION:
+        for (ASTFunctionParameter *param =
+                 node->function_declaration.parameters;
+             param; param = param->next) {
+            bindings_add(param->parameter_name);
+        }
+        break;
+    case AST_FOR_LOOP:
+        bindings_add(node->for_loop.loop_variable);
+        break;
+    case AST_TRY:
+        for (ASTCatchNode *catch_node = node->try_block.catch_blocks;
+             catch_node; catch_node = catch_node->next) {
+            bindings_add(catch_node->error_variable);
+        }
+        break;
+    default:
+        break;
+    }
+    ast_for_each_child(node, bindings_collect, context);
+}
+
+/**
+ * @brief Counts the bindings of a script or module about to be run.
+ *
+ * Call sites cache what a name resolved to, so they're all invalidated.
+ */
+void bindings_add_program(ASTNode *program) {
+    pthread_mutex_lock(&bindings_lock);
+    for (ASTNode *node = program; node; node = node->next) {
+        ASTNode *slot = node;
+        bindings_collect(&slot, NULL);
+    }
+    pthread_mutex_unlock(&bindings_lock);
+    functions_changed();
+}
+
+// How many places bind `name` as a variable (0 if only functions, records &
+// built-ins are called that)
+size_t bindings_count(const char *name) {
+    pthread_mutex_lock(&bindings_lock);
+    size_t count = 0;
+    if (bindings_capacity) {
+        count = bindings_slot(bindings, bindings_capacity, name)->count;
+    }
+    pthread_mutex_unlock(&bindings_lock);
+    return count;
+}
+
+void bindings_shutdown(void) {
+    for (size_t i = 0; i < bindings_capacity; i++) {
+        free(bindings[i].name);
+    }
+    free(bindings);
+    bindings = NULL;
+    bindings_capacity = bindings_used = 0;
+}
@@ -0,0 +1,14 @@
+#ifndef BINDINGS_H
+#define BINDINGS_H
+
+#include "../shared/ast_types.h"
+#include <stddef.h>
+
+// Loading
+void bindings_add_program(ASTNode *program);
+void bindings_shutdown(void);
+
+// Queries
+size_t bindings_count(const char *name);
+
+#endif
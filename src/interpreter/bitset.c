@@ -0,0 +1,112 @@
+#include "bitset.h"
+#include "gc.h"
+#include "parallel.h"
+
+BitsetValue *bitset_new(size_t bits) {
+    size_t words = BITSET_WORDS(bits);
+    BitsetValue *bitset =
+        gc_alloc(GC_BITSET, sizeof(BitsetValue) + words * sizeof(uint64_t));
+    bitset->bits = bits;
+    bitset->owner = parallel_task_owner();
+    memset(bitset->words, 0, words * sizeof(uint64_t));
+    return bitset;
+}
+
+// Parallel tasks may read any bitset, but only modify bitsets they created
+bool bitset_writable(const BitsetValue *bitset) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || bitset->owner == owner;
+}
+
+// ==================================================
+// SINGLE BITS
+// ==================================================
+
+bool bitset_test(const BitsetValue *bitset, size_t position) {
+    return (bitset->words[position / BITSET_WORD_BITS] >>
+            (position % BITSET_WORD_BITS)) &
+           1;
+}
+
+void bitset_assign(BitsetValue *bitset, size_t position, bool value) {
+    uint64_t mask = (uint64_t)1 << (position % BITSET_WORD_BITS);
+    if (value) {
+        bitset->words[position / BITSET_WORD_BITS] |= mask;
+    } else {
+        bitset->words[position / BITSET_WORD_BITS] &= ~mask;
+    }
+}
+
+// ==================================================
+// WHOLE SETS
+// ==================================================
+
+// Compiles to a single instruction where the CPU has one
+size_t popcount_word(uint64_t word) {
+    return (size_t)__builtin_popcountll(word);
+}
+
+// Separate counters let several words be counted at once, as in `sum()`
+size_t bitset_count(const BitsetValue *bitset) {
+    size_t words = BITSET_WORDS(bitset->bits);
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        c0 += popcount_word(bitset->words[i]);
+        c1 += popcount_word(bitset->words[i + 1]);
+        c2 += popcount_word(bitset->words[i + 2]);
+        c3 += popcount_word(bitset->words[i + 3]);
+    }
+    for (; i < words; i++) {
+        c0 += popcount_word(bitset->words[i]);
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+/**
+ * @brief Combines two bitsets of the same size, 64 bits at a time.
+ *
+ * Each loop is a plain pass over contiguous words with no dependencies
+ * between iterations, so the compiler can vectorise it.
+ */
+BitsetValue *bitset_combine(BitsetOp op, const BitsetValue *left,
+                            const BitsetValue *right) {
+    BitsetValue *result = bitset_new(left->bits);
+    size_t words = BITSET_WORDS(left->bits);
+    const uint64_t *a = left->words;
+    const uint64_t *b = right->words;
+    uint64_t *out = result->words;
+
+    switch (op) {
+    case BITSET_AND:
+        for (size_t i = 0; i < words; i++) {
+            out[i] = a[i] & b[i];
+        }
+        break;
+    case BITSET_OR:
+        for (size_t i = 0; i < words; i++) {
+            out[i] = a[i] | b[i];
+        }
+        break;
+    case BITSET_XOR:
+        for (size_t i = 0; i < words; i++) {
+            out[i] = a[i] ^ b[i];
+        }
+        break;
+    }
+    return result;
+}
+
+// Flips every bit, keeping the unused bits of the last word clear
+BitsetValue *bitset_complement(const BitsetValue *bitset) {
+    BitsetValue *result = bitset_new(bitset->bits);
+    size_t words = BITSET_WORDS(bitset->bits);
+    for (size_t i = 0; i < words; i++) {
+        result->words[i] = ~bitset->words[i];
+    }
+    size_t tail = bitset->bits % BITSET_WORD_BITS;
+    if (tail > 0) {
+        result->words[words - 1] &= ((uint64_t)1 << tail) - 1;
+    }
+    return result;
+}
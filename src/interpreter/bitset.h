@@ -0,0 +1,36 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bits per storage word
+#define BITSET_WORD_BITS 64
+
+// Words needed to hold `bits` bits
+#define BITSET_WORDS(bits) (((bits) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+// Whole-set operators
+typedef enum { BITSET_AND, BITSET_OR, BITSET_XOR } BitsetOp;
+
+// Creation (every bit starts clear)
+BitsetValue *bitset_new(size_t bits);
+bool bitset_writable(const BitsetValue *bitset);
+
+// Single bits (positions must already be bounds-checked)
+bool bitset_test(const BitsetValue *bitset, size_t position);
+void bitset_assign(BitsetValue *bitset, size_t position, bool value);
+
+// Whole sets (each result is a new bitset; both operands must be the same
+// size)
+size_t bitset_count(const BitsetValue *bitset);
+BitsetValue *bitset_combine(BitsetOp op, const BitsetValue *left,
+                            const BitsetValue *right);
+BitsetValue *bitset_complement(const BitsetValue *bitset);
+
+// Integers
+size_t popcount_word(uint64_t word);
+
+#endif
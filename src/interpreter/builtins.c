@@ -1,5 +1,26 @@
 #include "builtins.h"
 
+// Appends `text` at `*used`, growing `*out` when it runs out of room
+static bool append_growing(char **out, size_t *used, size_t *size,
+                           const char *text) {
+    size_t length = strlen(text);
+    if (*used + length + 1 > *size) {
+        size_t new_size = *size * 2;
+        while (*used + length + 1 > new_size) {
+            new_size *= 2;
+        }
+        char *grown = realloc(*out, new_size);
+        if (!grown) {
+            return false;
+        }
+        *out = grown;
+        *size = new_size;
+    }
+    memcpy(*out + *used, text, length + 1);
+    *used += length;
+    return true;
+}
+
 char *literal_value_to_string(LiteralValue lv) {
     char buffer[128];
     switch (lv.type) {
@@ -12,32 +33,124 @@ char *literal_value_to_string(LiteralValue lv) {
         return strdup(buffer);
     }
     case TYPE_STRING: {
-        return strdup(lv.data.string);
+        return strdup(lv.data.string->bytes);
     }
     case TYPE_BOOLEAN: {
         return strdup(lv.data.boolean ? "True" : "False");
     }
     case TYPE_ARRAY: {
-        // Estimate needed buffer size: assume roughly 32 chars per element plus
-        // brackets
-        size_t estimate = lv.data.array.count * 32 + 3;
+        // Start from roughly 32 chars per element plus brackets, & grow for
+        // longer elements (like nested arrays)
+        size_t size = lv.data.array->count * 32 + 3;
+        size_t used = 0;
+        char *result = malloc(size);
+        if (!result)
+            return NULL;
+        append_growing(&result, &used, &size, "["); // Always fits
+        for (size_t i = 0; i < lv.data.array->count; i++) {
+            char *elemStr =
+                literal_value_to_string(array_get(lv.data.array, i));
+            bool appended =
+                elemStr && (i == 0 ||
+                            append_growing(&result, &used, &size, ", ")) &&
+                append_growing(&result, &used, &size, elemStr);
+            free(elemStr);
+            if (!appended) {
+                free(result);
+                return NULL;
+            }
+        }
+        if (!append_growing(&result, &used, &size, "]")) {
+            free(result);
+            return NULL;
+        }
+        return result;
+    }
+    case TYPE_BUILDER:
+        return strdup("<Builder>");
+    case TYPE_HEAP:
+        return strdup("<Heap>");
+    case TYPE_BITSET:
+        return strdup("<Bitset>");
+    case TYPE_MATRIX: {
+        // Printed like nested arrays
+        const MatrixValue *matrix = lv.data.matrix;
+        size_t size = matrix->rows * (matrix->cols * 16 + 4) + 3;
+        size_t used = 0;
+        char *result = malloc(size);
+        bool ok = result && append_growing(&result, &used, &size, "[");
+        for (size_t i = 0; ok && i < matrix->rows; i++) {
+            ok = append_growing(&result, &used, &size, i > 0 ? ", [" : "[");
+            for (size_t j = 0; ok && j < matrix->cols; j++) {
+                snprintf(buffer, sizeof(buffer), FLOAT_FORMAT,
+                         matrix->cells[i * matrix->cols + j]);
+                ok = (j == 0 || append_growing(&result, &used, &size, ", ")) &&
+                     append_growing(&result, &used, &size, buffer);
+            }
+            ok = ok && append_growing(&result, &used, &size, "]");
+        }
+        if (!ok || !append_growing(&result, &used, &size, "]")) {
+            free(result);
+            return NULL;
+        }
+        return result;
+    }
+    case TYPE_RECORD: {
+        // Same estimate as maps, per field
+        const RecordValue *record = lv.data.record;
+        size_t estimate = strlen(record->type->name) +
+                          record->type->field_count * 64 + 3;
         char *result = malloc(estimate);
         if (!result)
             return NULL;
-        strcpy(result, "[");
-        for (size_t i = 0; i < lv.data.array.count; i++) {
-            char *elemStr = literal_value_to_string(lv.data.array.elements[i]);
-            if (!elemStr) {
+        snprintf(result, estimate, "%s(", record->type->name);
+        for (size_t i = 0; i < record->type->field_count; i++) {
+            char *field_str = literal_value_to_string(record->fields[i]);
+            if (!field_str) {
                 free(result);
                 return NULL;
             }
-            strncat(result, elemStr, estimate - strlen(result) - 1);
-            free(elemStr);
-            if (i < lv.data.array.count - 1) {
+            if (i > 0) {
+                strncat(result, ", ", estimate - strlen(result) - 1);
+            }
+            strncat(result, record->type->field_names[i],
+                    estimate - strlen(result) - 1);
+            strncat(result, ": ", estimate - strlen(result) - 1);
+            strncat(result, field_str, estimate - strlen(result) - 1);
+            free(field_str);
+        }
+        strncat(result, ")", estimate - strlen(result) - 1);
+        return result;
+    }
+    case TYPE_MAP: {
+        // Same estimate as arrays, per key & value
+        size_t estimate = lv.data.map->count * 64 + 3;
+        char *result = malloc(estimate);
+        if (!result)
+            return NULL;
+        strcpy(result, "{");
+        size_t position = 0;
+        size_t printed = 0;
+        LiteralValue key, value;
+        while (map_next(lv.data.map, &position, &key, &value)) {
+            char *key_str = literal_value_to_string(key);
+            char *value_str = literal_value_to_string(value);
+            if (!key_str || !value_str) {
+                free(key_str);
+                free(value_str);
+                free(result);
+                return NULL;
+            }
+            if (printed++ > 0) {
                 strncat(result, ", ", estimate - strlen(result) - 1);
             }
+            strncat(result, key_str, estimate - strlen(result) - 1);
+            strncat(result, ": ", estimate - strlen(result) - 1);
+            strncat(result, value_str, estimate - strlen(result) - 1);
+            free(key_str);
+            free(value_str);
         }
-        strncat(result, "]", estimate - strlen(result) - 1);
+        strncat(result, "}", estimate - strlen(result) - 1);
         return result;
     }
     default:
@@ -50,60 +163,102 @@ char *literal_value_to_string(LiteralValue lv) {
  * (using literal_value_to_string) and concatenating them (separated by a single
  * space).
  *
- * @param arg_node
- * @param env
+ * @param args     The evaluated arguments.
+ * @param num_args How many there are.
  * @return char*
  */
-char *build_arguments_string(ASTNode *arg_node, Environment *env) {
+char *build_arguments_string(const LiteralValue *args, size_t num_args) {
     char buffer[1024] = {0};
     size_t buffer_index = 0;
 
-    while (arg_node != NULL) {
-        InterpretResult r = interpret_node(arg_node, env);
-        if (r.is_error) {
-            return NULL; // If an error occurs, return NULL.
-        }
+    for (size_t i = 0; i < num_args; i++) {
         // Convert the evaluated argument to string.
-        char *s = literal_value_to_string(r.value);
+        char *s = literal_value_to_string(args[i]);
         if (!s)
             return NULL;
         size_t len = strlen(s);
         if (buffer_index + len + 1 < sizeof(buffer)) {
             strcpy(&buffer[buffer_index], s);
             buffer_index += len;
-            if (arg_node->next != NULL && buffer_index < sizeof(buffer) - 1) {
+            if (i + 1 < num_args && buffer_index < sizeof(buffer) - 1) {
                 buffer[buffer_index++] = ' ';
             }
         }
         free(s);
-        arg_node = arg_node->next;
     }
     return strdup(buffer);
 }
 
 // Helper function to check if a LiteralType matches an ArgType
 bool literal_type_matches_arg_type(LiteralType lit_type, ArgType arg_type) {
-    switch (arg_type) {
-    case ARG_TYPE_INTEGER:
-        return lit_type == TYPE_INTEGER;
-    case ARG_TYPE_FLOAT:
-        return lit_type == TYPE_FLOAT;
-    case ARG_TYPE_STRING:
-        return lit_type == TYPE_STRING;
-    case ARG_TYPE_BOOLEAN:
-        return lit_type == TYPE_BOOLEAN;
-    case ARG_TYPE_ARRAY:
-        return lit_type == TYPE_ARRAY;
-    case ARG_TYPE_NUMERIC:
-        return (lit_type == TYPE_INTEGER) || (lit_type == TYPE_FLOAT);
+    if (arg_type == ARG_TYPE_ANY) {
+        return true;
+    }
+
+    ArgType type;
+    switch (lit_type) {
+    case TYPE_INTEGER:
+        type = ARG_TYPE_INTEGER;
+        break;
+    case TYPE_FLOAT:
+        type = ARG_TYPE_FLOAT;
+        break;
+    case TYPE_STRING:
+        type = ARG_TYPE_STRING;
+        break;
+    case TYPE_BOOLEAN:
+        type = ARG_TYPE_BOOLEAN;
+        break;
+    case TYPE_ARRAY:
+        type = ARG_TYPE_ARRAY;
+        break;
+    case TYPE_FUNCTION:
+        type = ARG_TYPE_FUNCTION;
+        break;
+    case TYPE_BUILDER:
+        type = ARG_TYPE_BUILDER;
+        break;
+    case TYPE_MAP:
+        type = ARG_TYPE_MAP;
+        break;
+    case TYPE_HEAP:
+        type = ARG_TYPE_HEAP;
+        break;
+    case TYPE_MATRIX:
+        type = ARG_TYPE_MATRIX;
+        break;
+    case TYPE_BITSET:
+        type = ARG_TYPE_BITSET;
+        break;
     default:
-        return false; // Unknown ArgType
+        return false; // Records & errors only match any type
     }
+    return (arg_type & type) != 0;
 }
 
 // Function to interpret arguments with single expected type per ArgumentSpec
 InterpretResult interpret_arguments(ASTNode *node, Environment *env,
                                     size_t num_args, ArgumentSpec *specs) {
+    // Earlier arguments must stay reachable while later ones are evaluated
+    LiteralValue *held = calloc(num_args ? num_args : 1, sizeof(LiteralValue));
+    if (!held) {
+        return raise_error("Memory allocation failed for arguments.\n");
+    }
+    size_t root_depth = gc_root_depth();
+
+    InterpretResult res =
+        interpret_arguments_into(node, env, num_args, specs, held);
+
+    // Values handed out through `out_ptr` are used by the builtin before the
+    // next statement boundary, so the roots can be released here
+    gc_restore_roots(root_depth);
+    free(held);
+    return res;
+}
+
+InterpretResult interpret_arguments_into(ASTNode *node, Environment *env,
+                                         size_t num_args, ArgumentSpec *specs,
+                                         LiteralValue *held) {
     ASTNode *arg_node = node;
 
     for (size_t i = 0; i < num_args; i++) {
@@ -118,6 +273,8 @@ InterpretResult interpret_arguments(ASTNode *node, Environment *env,
             return arg_res;
         }
         LiteralValue lv = arg_res.value;
+        held[i] = lv;
+        gc_push_root(&held[i]);
 
         // Reference to the current argument specification
         ArgumentSpec current_spec = specs[i];
@@ -143,13 +300,13 @@ InterpretResult interpret_arguments(ASTNode *node, Environment *env,
                 }
                 break;
             case ARG_TYPE_STRING:
-                *((char **)current_spec.out_ptr) = lv.data.string;
+                *((char **)current_spec.out_ptr) = lv.data.string->bytes;
                 break;
             case ARG_TYPE_BOOLEAN:
                 *((bool *)current_spec.out_ptr) = lv.data.boolean;
                 break;
             case ARG_TYPE_ARRAY:
-                *((ArrayValue **)current_spec.out_ptr) = &lv.data.array;
+                *((ArrayValue *)current_spec.out_ptr) = *lv.data.array;
                 break;
             default:
                 return raise_error("Unknown argument type for argument %zu.\n",
@@ -243,11 +400,14 @@ void print_formatted_string(const char *str) {
 }
 
 // Built-in `input()` function with optional arguments for a prompt
-InterpretResult builtin_input(ASTNode *node, Environment *env) {
+InterpretResult builtin_input(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)env; // unused
+
     // If a prompt argument is provided, build and print it.
-    if (node->function_call.arguments != NULL) {
-        char *prompt =
-            build_arguments_string(node->function_call.arguments, env);
+    size_t num_args = helper_count_arguments(node);
+    if (num_args > 0) {
+        char *prompt = build_arguments_string(args, num_args);
         if (prompt) {
             printf("%s", prompt);
             fflush(stdout);
@@ -285,54 +445,34 @@ InterpretResult builtin_input(ASTNode *node, Environment *env) {
 
     LiteralValue result;
     result.type = TYPE_STRING;
-    result.data.string = strdup(input_buffer);
+    result.data.string = fl_string_from_bytes(input_buffer, input_length);
     free(input_buffer);
 
-    if (!result.data.string) {
-        fprintf(stderr, "Error: Failed to duplicate input string.\n");
-        LiteralValue lv = {.type = TYPE_ERROR};
-        return make_result(lv, false, false);
-    }
-    debug_print_int("Input received: `%s`\n", result.data.string);
+    debug_print_int("Input received: `%s`\n", result.data.string->bytes);
     return make_result(result, false, false);
 }
 
+// A numeric argument, as a float
+static FLOAT_SIZE helper_number(LiteralValue value) {
+    return value.type == TYPE_INTEGER ? (FLOAT_SIZE)value.data.integer
+                                      : value.data.floating_point;
+}
+
 // Built-in `random()` function with 0, 1, or 2 numeric arguments
-InterpretResult builtin_random(ASTNode *node, Environment *env) {
+InterpretResult builtin_random(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
     FLOAT_SIZE min = 0.0L; // default min
     FLOAT_SIZE max = 1.0L; // default max
 
-    // Determine how many arguments were passed
-    ASTNode *arg_node = node->function_call.arguments;
-    size_t num_args = 0;
-    ASTNode *temp = arg_node;
-    while (temp) {
-        num_args++;
-        temp = temp->next;
-    }
-    if (num_args > 2) {
-        return raise_error("`random()` takes at most 2 numeric arguments "
-                           "(integer or float), but %zu provided.\n",
-                           num_args);
-    }
+    (void)env; // unused
+
+    // Determine how many arguments were passed (at most 2)
+    size_t num_args = helper_count_arguments(node);
     if (num_args == 1) {
-        ArgumentSpec specs[1];
-        specs[0].type = ARG_TYPE_NUMERIC;
-        specs[0].out_ptr = &max;
-        InterpretResult args_res = interpret_arguments(arg_node, env, 1, specs);
-        if (args_res.is_error) {
-            return args_res;
-        }
+        max = helper_number(args[0]);
     } else if (num_args == 2) {
-        ArgumentSpec specs[2];
-        specs[0].type = ARG_TYPE_NUMERIC;
-        specs[0].out_ptr = &min;
-        specs[1].type = ARG_TYPE_NUMERIC;
-        specs[1].out_ptr = &max;
-        InterpretResult args_res = interpret_arguments(arg_node, env, 2, specs);
-        if (args_res.is_error) {
-            return args_res;
-        }
+        min = helper_number(args[0]);
+        max = helper_number(args[1]);
     }
 
     if (min > max) {
@@ -341,7 +481,10 @@ InterpretResult builtin_random(ASTNode *node, Environment *env) {
         max = temp_val;
     }
 
+    // rand() isn't thread-safe, & parallel tasks may call `random()`
+    static pthread_mutex_t random_lock = PTHREAD_MUTEX_INITIALIZER;
     static bool seeded = false;
+    pthread_mutex_lock(&random_lock);
     if (!seeded) {
 #ifdef _WIN32
         srand((unsigned int)(time(NULL) ^ GetTickCount()));
@@ -354,6 +497,7 @@ InterpretResult builtin_random(ASTNode *node, Environment *env) {
     }
 
     FLOAT_SIZE random_fraction = ((FLOAT_SIZE)rand() / (FLOAT_SIZE)RAND_MAX);
+    pthread_mutex_unlock(&random_lock);
     FLOAT_SIZE random_number = min + random_fraction * (max - min);
 
     debug_print_int("Random number generated (min: " FLOAT_FORMAT
@@ -366,48 +510,12 @@ InterpretResult builtin_random(ASTNode *node, Environment *env) {
     return make_result(result, false, false);
 }
 
-void print_literal_value(LiteralValue lv) {
-    switch (lv.type) {
-    case TYPE_FLOAT:
-        if ((INT_SIZE)lv.data.floating_point == lv.data.floating_point) {
-            printf("%.1Lf", lv.data.floating_point);
-        } else {
-            printf(FLOAT_FORMAT, lv.data.floating_point);
-        }
-        break;
-    case TYPE_INTEGER:
-        printf(INT_FORMAT, lv.data.integer);
-        break;
-    case TYPE_STRING:
-        printf("\"%s\"", lv.data.string);
-        break;
-    case TYPE_BOOLEAN:
-        printf("%s", lv.data.boolean ? "True" : "False");
-        break;
-    case TYPE_ARRAY:
-        printf("[");
-        for (size_t i = 0; i < lv.data.array.count; i++) {
-            print_literal_value(lv.data.array.elements[i]);
-            if (i < lv.data.array.count - 1) {
-                printf(", ");
-            }
-        }
-        printf("]");
-        break;
-    case TYPE_FUNCTION:
-        printf("<Function %s>", lv.data.function_name);
-        break;
-    case TYPE_ERROR:
-        printf("<Error>");
-        break;
-    default:
-        printf("<Unknown>");
-    }
-}
-
 // Built-in `serve()` function for printing with optional newline control
-InterpretResult builtin_output(ASTNode *node, Environment *env) {
-    char *output = build_arguments_string(node->function_call.arguments, env);
+InterpretResult builtin_output(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)env; // unused
+
+    char *output = build_arguments_string(args, helper_count_arguments(node));
     if (output) {
         printf("%s\n", output);
         free(output);
@@ -417,17 +525,19 @@ InterpretResult builtin_output(ASTNode *node, Environment *env) {
 }
 
 // Built-in `burn()` function to raise errors
-InterpretResult builtin_error(ASTNode *node, Environment *env) {
-    ASTNode *arg_node = node->function_call.arguments;
+InterpretResult builtin_error(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)env; // unused
+
+    size_t num_args = helper_count_arguments(node);
     char error_message[512] = "Error raised by burn(): ";
 
-    while (arg_node != NULL) {
-        InterpretResult r = interpret_node(arg_node, env);
-        LiteralValue lv = r.value;
+    for (size_t i = 0; i < num_args; i++) {
+        LiteralValue lv = args[i];
 
         switch (lv.type) {
         case TYPE_STRING:
-            strncat(error_message, lv.data.string,
+            strncat(error_message, lv.data.string->bytes,
                     sizeof(error_message) - strlen(error_message) - 1);
             break;
         case TYPE_FLOAT: {
@@ -459,19 +569,19 @@ InterpretResult builtin_error(ASTNode *node, Environment *env) {
             break;
         }
 
-        if (arg_node->next != NULL) {
+        if (i + 1 < num_args) {
             strncat(error_message, " ",
                     sizeof(error_message) - strlen(error_message) - 1);
         }
-
-        arg_node = arg_node->next;
     }
 
     // Propagate the exception
     return raise_error("%s", error_message);
 }
 
-InterpretResult builtin_cast(ASTNode *node, Environment *env) {
+InterpretResult builtin_cast(ASTNode *node, Environment *env,
+                             LiteralValue *no_args) {
+    (void)no_args; // evaluates its own argument
     if (node->type != AST_FUNCTION_CALL) {
         return raise_error(
             "`builtin_cast()` expects an `AST_FUNCTION_CALL` node.\n");
@@ -489,21 +599,8 @@ InterpretResult builtin_cast(ASTNode *node, Environment *env) {
         return raise_error("No cast type provided to `builtin_cast()`.\n");
     }
 
-    ASTNode *arg_node = node->function_call.arguments;
-    if (!arg_node) {
-        free(cast_type);
-        return raise_error(
-            "No expression provided for cast in `builtin_cast()`.\n");
-    }
-
-    // Ensure there's only one argument
-    if (arg_node->next != NULL) {
-        free(cast_type);
-        return raise_error("`%s` cast function takes exactly one argument.\n",
-                           cast_type);
-    }
-
-    ASTNode *expr = arg_node;
+    // The registry ensures there's exactly one argument
+    ASTNode *expr = node->function_call.arguments;
 
     // Interpret the expression to be casted
     InterpretResult expr_result = interpret_node(expr, env);
@@ -529,31 +626,26 @@ InterpretResult builtin_cast(ASTNode *node, Environment *env) {
         switch (original.type) {
         case TYPE_INTEGER:
             snprintf(buffer, sizeof(buffer), INT_FORMAT, original.data.integer);
-            cast_val.data.string = strdup(buffer);
+            cast_val.data.string = fl_string_new(buffer);
             break;
         case TYPE_FLOAT:
             snprintf(buffer, sizeof(buffer), FLOAT_FORMAT,
                      original.data.floating_point);
-            cast_val.data.string = strdup(buffer);
+            cast_val.data.string = fl_string_new(buffer);
             break;
         case TYPE_BOOLEAN:
             cast_val.data.string =
-                strdup(original.data.boolean ? "True" : "False");
+                fl_string_new(original.data.boolean ? "True" : "False");
             break;
         case TYPE_STRING:
-            cast_val.data.string = strdup(original.data.string);
+            // Strings are immutable, so the cast can share the original
+            cast_val.data.string = original.data.string;
             break;
         default:
             free(cast_type);
             return raise_error("Unsupported type for string cast.\n");
         }
 
-        if (!cast_val.data.string) {
-            free(cast_type);
-            return raise_error(
-                "Memory allocation failed during string cast.\n");
-        }
-
         result_res.value = cast_val;
     } else if (strcmp(cast_type, "int") == 0) {
         LiteralValue cast_val;
@@ -562,10 +654,10 @@ InterpretResult builtin_cast(ASTNode *node, Environment *env) {
         switch (original.type) {
         case TYPE_STRING: {
             INT_SIZE temp;
-            if (!is_valid_int(original.data.string, &temp)) {
+            if (!is_valid_int(original.data.string->bytes, &temp)) {
                 free(cast_type);
                 return raise_error("Cannot cast string \"%s\" to int.\n",
-                                   original.data.string);
+                                   original.data.string->bytes);
             }
             cast_val.data.integer = temp;
             break;
@@ -592,10 +684,10 @@ InterpretResult builtin_cast(ASTNode *node, Environment *env) {
         switch (original.type) {
         case TYPE_STRING: {
             FLOAT_SIZE temp;
-            if (!is_valid_float(original.data.string, &temp)) {
+            if (!is_valid_float(original.data.string->bytes, &temp)) {
                 free(cast_type);
                 return raise_error("Cannot cast string \"%s\" to float.\n",
-                                   original.data.string);
+                                   original.data.string->bytes);
             }
             cast_val.data.floating_point = temp;
             break;
@@ -616,15 +708,21 @@ InterpretResult builtin_cast(ASTNode *node, Environment *env) {
 
         result_res.value = cast_val;
     } else {
+        InterpretResult error =
+            raise_error("Unsupported cast type: `%s`\n", cast_type);
         free(cast_type);
-        return raise_error("Unsupported cast type: `%s`\n", cast_type);
+        return error;
     }
 
     free(cast_type);
     return result_res;
 }
 
-InterpretResult builtin_time(void) {
+InterpretResult builtin_time(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // no arguments
+    (void)env;  // unused
+    (void)args;
     time_t current_time = time(NULL);
 
     if (current_time == -1) {
@@ -701,19 +799,11 @@ char *process_escape_sequences(const char *input) {
     return processed;
 }
 
-InterpretResult builtin_file_read(ASTNode *node, Environment *env) {
-    char *filepath;
-
-    ArgumentSpec specs[1];
-    specs[0].type = ARG_TYPE_STRING;
-    specs[0].out_ptr = &filepath;
-
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 1, specs);
-    if (args_res.is_error) {
-        LiteralValue lv = (LiteralValue){.type = TYPE_ERROR};
-        return make_result(lv, false, false);
-    }
+InterpretResult builtin_file_read(ASTNode *node, Environment *env,
+                                  LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    const char *filepath = args[0].data.string->bytes;
 
     FILE *file = fopen(filepath, "r");
     if (file == NULL) {
@@ -765,28 +855,15 @@ InterpretResult builtin_file_read(ASTNode *node, Environment *env) {
     free(buffer);
     fclose(file);
 
-    LiteralValue lv = {.type = TYPE_STRING, .data.string = file_contents};
+    LiteralValue lv = {.type = TYPE_STRING,
+                       .data.string = fl_string_from_bytes(file_contents, content_size)};
+    free(file_contents);
     return make_result(lv, false, false);
 }
 
-InterpretResult helper_file_writer(ASTNode *node, Environment *env,
-                                   bool append) {
-    char *filepath;
-    char *content;
-
-    ArgumentSpec specs[2];
-    specs[0].type = ARG_TYPE_STRING;
-    specs[0].out_ptr = &filepath;
-
-    specs[1].type = ARG_TYPE_STRING;
-    specs[1].out_ptr = &content;
-
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 2, specs);
-    if (args_res.is_error) {
-        LiteralValue lv = (LiteralValue){.type = TYPE_ERROR};
-        return make_result(lv, false, false);
-    }
+InterpretResult helper_file_writer(LiteralValue *args, bool append) {
+    const char *filepath = args[0].data.string->bytes;
+    const char *content = args[1].data.string->bytes;
 
     // Process the content to handle escape sequences
     char *processed_content = process_escape_sequences(content);
@@ -818,12 +895,18 @@ InterpretResult helper_file_writer(ASTNode *node, Environment *env,
     return make_result(lv, false, false);
 }
 
-InterpretResult builtin_file_write(ASTNode *node, Environment *env) {
-    return helper_file_writer(node, env, false);
+InterpretResult builtin_file_write(ASTNode *node, Environment *env,
+                                   LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_file_writer(args, false);
 }
 
-InterpretResult builtin_file_append(ASTNode *node, Environment *env) {
-    return helper_file_writer(node, env, true);
+InterpretResult builtin_file_append(ASTNode *node, Environment *env,
+                                    LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_file_writer(args, true);
 }
 
 /**
@@ -831,32 +914,14 @@ InterpretResult builtin_file_append(ASTNode *node, Environment *env) {
  *
  * @param node The AST node representing the function call.
  * @param env  The current environment.
+ * @param args The evaluated arguments.
  * @return InterpretResult containing the length as an integer or an error.
  */
-InterpretResult builtin_length(ASTNode *node, Environment *env) {
-    // Ensure the function call has exactly one argument
-    size_t num_args = 0;
-    ASTNode *arg_node = node->function_call.arguments;
-    ASTNode *temp = arg_node;
-    while (temp) {
-        num_args++;
-        temp = temp->next;
-    }
-
-    if (num_args != 1) {
-        return raise_error("`length()` expects exactly one argument, but "
-                           "%zu were given.\n",
-                           num_args);
-    }
-
-    // Interpret the single argument
-    InterpretResult arg_res = interpret_node(arg_node, env);
-    if (arg_res.is_error) {
-        // Propagate the error
-        return arg_res;
-    }
-
-    LiteralValue lv = arg_res.value;
+InterpretResult builtin_length(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue lv = args[0];
 
     // Initialize the result
     LiteralValue result;
@@ -864,14 +929,19 @@ InterpretResult builtin_length(ASTNode *node, Environment *env) {
 
     // Determine the type of the argument and calculate length accordingly
     if (lv.type == TYPE_STRING) {
-        result.data.integer = (INT_SIZE)strlen(lv.data.string);
+        result.data.integer = (INT_SIZE)lv.data.string->length;
     } else if (lv.type == TYPE_ARRAY) {
-        result.data.integer = (INT_SIZE)lv.data.array.count;
-    } else {
-        // Unsupported type
-        return raise_error("`length()` expects an array or a string as an "
-                           "argument, but received type `%d`.\n",
-                           lv.type);
+        result.data.integer = (INT_SIZE)lv.data.array->count;
+    } else if (lv.type == TYPE_BUILDER) {
+        result.data.integer = (INT_SIZE)lv.data.builder->buffer->length;
+    } else if (lv.type == TYPE_MAP) {
+        result.data.integer = (INT_SIZE)lv.data.map->count;
+    } else if (lv.type == TYPE_HEAP) {
+        result.data.integer = (INT_SIZE)lv.data.heap->count;
+    } else if (lv.type == TYPE_MATRIX) {
+        result.data.integer = (INT_SIZE)lv.data.matrix->rows;
+    } else { // TYPE_BITSET
+        result.data.integer = (INT_SIZE)lv.data.bitset->bits;
     }
 
     // Return the length as a LiteralValue
@@ -879,118 +949,1502 @@ InterpretResult builtin_length(ASTNode *node, Environment *env) {
 }
 
 /**
- * @brief Built-in function to sleep (pause execution) for a given time (in
- * milliseconds).
+ * @brief Built-in function to create an empty string builder.
  *
  * @param node The AST node representing the function call.
  * @param env  The current environment.
- * @return InterpretResult with a default value.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new builder.
  */
-InterpretResult builtin_sleep(ASTNode *node, Environment *env) {
-    // Define expected arguments: exactly one integer (> 0).
-    INT_SIZE ms;
+InterpretResult builtin_builder(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // no arguments
+    (void)env;  // unused
+    (void)args;
 
-    ArgumentSpec specs[1];
-    specs[0].type = ARG_TYPE_INTEGER;
-    specs[0].out_ptr = &ms;
-
-    // Interpret arguments
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 1, specs);
-    if (args_res.is_error) {
-        return args_res;
-    }
+    LiteralValue result;
+    result.type = TYPE_BUILDER;
+    result.data.builder = fl_builder_new();
+    return make_result(result, false, false);
+}
 
-    // Validate the argument
-    if (ms <= 0) {
-        return raise_error("`sleep` requires a positive integer argument "
-                           "representing milliseconds.\n");
+/**
+ * @brief Built-in function to append values to a string builder. Strings are
+ * appended as-is; anything else as `serve()` would print it.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The builder, so calls can be chained.
+ */
+InterpretResult builtin_append(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)env; // unused
+    size_t num_args = helper_count_arguments(node);
+    StringBuilder *builder = args[0].data.builder;
+
+    for (size_t i = 1; i < num_args; i++) {
+        if (args[i].type == TYPE_STRING) {
+            builder->buffer =
+                fl_string_append(builder->buffer, args[i].data.string->bytes,
+                                 args[i].data.string->length);
+        } else {
+            char *text = literal_value_to_string(args[i]);
+            if (!text) {
+                return raise_error(
+                    "Failed to convert a value passed to `append()`.\n");
+            }
+            builder->buffer =
+                fl_string_append(builder->buffer, text, strlen(text));
+            free(text);
+        }
     }
 
-// Perform the sleep based on the platform
-#ifdef _WIN32
-    Sleep((DWORD)ms); // sleep takes milliseconds on Windows
-#else
-    if (ms > (INT_MAX / 1000)) {
-        return raise_error("`sleep` argument is too large.\n");
-    }
+    return make_result(args[0], false, false);
+}
 
-    useconds_t us = (useconds_t)(ms * 1000); // usleep needs microseconds
-    usleep(us);
-#endif
+/**
+ * @brief Built-in function to get a string builder's contents.
+ *
+ * The builder's buffer is handed out as-is (no copy); it's frozen, so the
+ * builder moves to a new buffer if it's appended to afterwards.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The built string.
+ */
+InterpretResult builtin_build(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    FlavorString *contents = args[0].data.builder->buffer;
+    fl_string_freeze(contents);
 
-    LiteralValue result = create_default_value();
+    LiteralValue result;
+    result.type = TYPE_STRING;
+    result.data.string = contents;
     return make_result(result, false, false);
 }
 
-InterpretResult builtin_cimport(ASTNode *node, Environment *env) {
-    // Expect exactly two arguments: library path & function name
-    char *lib_path, *func_name;
-    ArgumentSpec specs[2] = {{.type = ARG_TYPE_STRING, .out_ptr = &lib_path},
-                             {.type = ARG_TYPE_STRING, .out_ptr = &func_name}};
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 2, specs);
-    if (args_res.is_error) {
-        return args_res;
+InterpretResult helper_typed_array(LiteralValue arg, ArrayKind kind,
+                                   const char *name) {
+    LiteralValue result;
+    result.type = TYPE_ARRAY;
+
+    // A length gives that many zeroed elements
+    if (arg.type == TYPE_INTEGER) {
+        if (arg.data.integer < 0) {
+            return raise_error("`%s()` expects a non-negative length.\n",
+                               name);
+        }
+        size_t count = (size_t)arg.data.integer;
+        result.data.array = array_box(array_new_typed(kind, count));
+        result.data.array->count = count;
+        return make_result(result, false, false);
     }
 
-    // If lib_path is not absolute path, prepend script directory
-    if (lib_path[0] != '/' && env->script_dir != NULL) {
-        size_t base_len = strlen(env->script_dir);
-        size_t lib_len = strlen(lib_path);
-        // Allocate enough room for "script_dir/lib_path" plus NULL terminator.
-        char *full_path = malloc(base_len + lib_len + 2);
-        if (!full_path) {
-            return raise_error("Memory allocation failed while constructing "
-                               "the full library path.");
+    // An array is copied, converting integers to floats for `float_array()`
+    const ArrayValue *source = arg.data.array;
+    result.data.array = array_box(array_new_typed(kind, source->count));
+    for (size_t i = 0; i < source->count; i++) {
+        LiteralValue element = array_get(source, i);
+        if (kind == ARRAY_FLOAT && element.type == TYPE_INTEGER) {
+            element.type = TYPE_FLOAT;
+            element.data.floating_point = (FLOAT_SIZE)element.data.integer;
         }
-        strcpy(full_path, env->script_dir);
-        // Ensure env->script_dir ends with a slash
-        if (env->script_dir[base_len - 1] != '/') {
-            strcat(full_path, "/");
+        if (!array_kind_accepts(kind, element)) {
+            return raise_error("`%s()` can't hold the element at index %zu "
+                               "(type `%s`).\n",
+                               name, i, literal_type_to_string(element.type));
         }
-        strcat(full_path, lib_path);
-        lib_path = full_path; // Now use this full path for dlopen()
+        array_push(result.data.array, element);
     }
+    return make_result(result, false, false);
+}
 
-    // Declare function pointer variable
-    FlavorLangCFunc func_ptr = NULL;
+/**
+ * @brief Built-in functions to create typed arrays, which store their
+ * elements unboxed. Each takes either a length (giving zeroed elements) or an
+ * array to convert.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new array.
+ */
+InterpretResult builtin_int_array(ASTNode *node, Environment *env,
+                                  LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_typed_array(args[0], ARRAY_INT, "int_array");
+}
 
-#if defined(__unix__) || defined(__APPLE__)
-    char full_lib_path[PATH_MAX];
-    // If lib_path is not absolute, prepend env->script_dir.
-    if (lib_path[0] != '/') {
-        snprintf(full_lib_path, sizeof(full_lib_path), "%s/%s", env->script_dir,
-                 lib_path);
-    } else {
-        strncpy(full_lib_path, lib_path, sizeof(full_lib_path));
-        full_lib_path[sizeof(full_lib_path) - 1] = '\0';
-    }
+InterpretResult builtin_float_array(ASTNode *node, Environment *env,
+                                    LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_typed_array(args[0], ARRAY_FLOAT, "float_array");
+}
 
-    // Now open the shared library using the full path.
-    void *handle = dlopen(full_lib_path, RTLD_LAZY);
-    if (!handle) {
-        return raise_error("dlopen error: %s", dlerror());
+InterpretResult builtin_bool_array(ASTNode *node, Environment *env,
+                                   LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_typed_array(args[0], ARRAY_BOOL, "bool_array");
+}
+
+/**
+ * @brief Interprets exactly `num_args` arguments for a builtin, keeping the
+ * earlier ones rooted while the later ones run.
+ *
+ * @param node     The AST node representing the function call.
+ * @param env      The current environment.
+ * @param name     The builtin's name, for error messages.
+ * @param num_args The number of arguments expected.
+ * @param args     Receives the argument values.
+ * @return InterpretResult An error, if the arguments don't fit.
+ */
+InterpretResult helper_evaluate_arguments(ASTNode *node, Environment *env,
+                                          const char *name, size_t num_args,
+                                          LiteralValue *args) {
+    ASTNode *arg_node = node->function_call.arguments;
+    size_t depth = gc_root_depth();
+
+    // Later arguments may call functions, so earlier ones must stay rooted
+    size_t count = 0;
+    for (; arg_node && count < num_args; arg_node = arg_node->next) {
+        InterpretResult r = interpret_node(arg_node, env);
+        if (r.is_error) {
+            gc_restore_roots(depth);
+            return r;
+        }
+        args[count] = r.value;
+        gc_push_root(&args[count]);
+        count++;
     }
-    // Clear any existing errors.
-    dlerror();
-    func_ptr = (FlavorLangCFunc)dlsym(handle, func_name);
-    char *error_msg = dlerror();
-    if (error_msg != NULL) {
-        dlclose(handle);
-        return raise_error("dlsym error: %s", error_msg);
+    gc_restore_roots(depth);
+
+    if (arg_node || count != num_args) {
+        return raise_error("`%s()` expects exactly %zu argument%s.\n", name,
+                           num_args, num_args == 1 ? "" : "s");
     }
-#else
-    return raise_error("`cimport` is not implemented on this platform.\n");
-#endif
 
-    // Create new `Function` record for external function
-    Function cfunc;
-    cfunc.name = safe_strdup(func_name);
-    cfunc.parameters = NULL;
-    cfunc.body = NULL;       // No AST body — it’s external
-    cfunc.is_builtin = true; // Mark as builtin/external
-    cfunc.c_function = func_ptr;
+    return make_result(create_default_value(), false, false);
+}
+
+// Like `helper_evaluate_arguments()`, but the first argument must be an array
+InterpretResult helper_array_arguments(ASTNode *node, Environment *env,
+                                       const char *name, size_t num_args,
+                                       LiteralValue *args) {
+    InterpretResult args_res =
+        helper_evaluate_arguments(node, env, name, num_args, args);
+    if (args_res.is_error) {
+        return args_res;
+    }
+    if (args[0].type != TYPE_ARRAY) {
+        return raise_error("`%s()` expects an array as its first argument.\n",
+                           name);
+    }
+    return args_res;
+}
+
+/**
+ * @brief Built-in function to add up an array of numbers.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The sum: an integer if every element is one.
+ */
+InterpretResult builtin_sum(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result;
+    if (!array_sum(args[0].data.array, &result)) {
+        return raise_error("`sum()` expects an array of numbers.\n");
+    }
+    return make_result(result, false, false);
+}
+
+InterpretResult helper_array_extreme(LiteralValue *args, bool want_max) {
+    const char *name = want_max ? "max" : "min";
+    if (args[0].data.array->count == 0) {
+        return raise_error("`%s()` of an empty array.\n", name);
+    }
+
+    LiteralValue result;
+    if (!array_extreme(args[0].data.array, want_max, &result)) {
+        return raise_error("`%s()` expects an array of numbers.\n", name);
+    }
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in functions to find the smallest & largest element of a
+ * non-empty array of numbers.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The element.
+ */
+InterpretResult builtin_min(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_array_extreme(args, false);
+}
+
+InterpretResult builtin_max(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_array_extreme(args, true);
+}
+
+/**
+ * @brief Built-in function to average a non-empty array of numbers.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The mean, as a float.
+ */
+InterpretResult builtin_mean(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (args[0].data.array->count == 0) {
+        return raise_error("`mean()` of an empty array.\n");
+    }
+
+    LiteralValue total;
+    if (!array_sum(args[0].data.array, &total)) {
+        return raise_error("`mean()` expects an array of numbers.\n");
+    }
+
+    LiteralValue result;
+    result.type = TYPE_FLOAT;
+    result.data.floating_point =
+        (total.type == TYPE_INTEGER ? (FLOAT_SIZE)total.data.integer
+                                    : total.data.floating_point) /
+        (FLOAT_SIZE)args[0].data.array->count;
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to compute the dot product of two arrays of
+ * numbers with the same length.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The dot product.
+ */
+InterpretResult builtin_dot(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (args[1].data.array->count != args[0].data.array->count) {
+        return raise_error(
+            "`dot()` expects two arrays with the same length.\n");
+    }
+
+    LiteralValue result;
+    if (!array_dot(args[0].data.array, args[1].data.array, &result)) {
+        return raise_error("`dot()` expects arrays of numbers.\n");
+    }
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to count the elements of an array equal (as with
+ * `==`) to a value.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The count.
+ */
+InterpretResult builtin_count_eq(ASTNode *node, Environment *env,
+                                 LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result;
+    result.type = TYPE_INTEGER;
+    result.data.integer =
+        (INT_SIZE)array_count_equal(args[0].data.array, args[1]);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to find the first element of an array equal (as
+ * with `==`) to a value.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The element's index, or -1 if there isn't one.
+ */
+InterpretResult builtin_index_of(ASTNode *node, Environment *env,
+                                 LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result;
+    result.type = TYPE_INTEGER;
+    result.data.integer =
+        (INT_SIZE)array_index_of(args[0].data.array, args[1]);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to multiply every element of an array by a
+ * number.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new array.
+ */
+InterpretResult builtin_scale(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    ArrayValue scaled;
+    if (!array_scale(args[0].data.array, args[1], &scaled)) {
+        return raise_error(
+            "`scale()` expects an array of numbers and a number.\n");
+    }
+    LiteralValue result = {.type = TYPE_ARRAY, .data.array = array_box(scaled)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to add a number, or the elements of another array
+ * with the same length, to every element of an array.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new array.
+ */
+InterpretResult builtin_add(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    ArrayValue sums;
+    if (args[1].type == TYPE_ARRAY) {
+        if (args[1].data.array->count != args[0].data.array->count) {
+            return raise_error(
+                "`add()` expects two arrays with the same length.\n");
+        }
+        if (!array_add(args[0].data.array, args[1].data.array, &sums)) {
+            return raise_error("`add()` expects arrays of numbers.\n");
+        }
+    } else if (!array_add_scalar(args[0].data.array, args[1], &sums)) {
+        return raise_error(
+            "`add()` expects an array of numbers and a number or array.\n");
+    }
+    LiteralValue result = {.type = TYPE_ARRAY, .data.array = array_box(sums)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to limit every element of an array of numbers to
+ * a range.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new array.
+ */
+InterpretResult builtin_clamp(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (compare_numbers(args[1], args[2]) > 0) {
+        return raise_error("`clamp()` expects numeric bounds with the lower "
+                           "one first.\n");
+    }
+
+    ArrayValue clamped;
+    if (!array_clamp(args[0].data.array, args[1], args[2], &clamped)) {
+        return raise_error("`clamp()` expects an array of numbers.\n");
+    }
+    LiteralValue result = {.type = TYPE_ARRAY,
+                           .data.array = array_box(clamped)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Resolves the function passed to a built-in like `sort_by()`, which
+ * must be a user-defined function.
+ *
+ * @param value The function argument.
+ * @param env   The current environment.
+ * @param name  The builtin's name, for error messages.
+ * @param out   Receives a copy of the function (as the function table may
+ *              grow while it's being called).
+ * @return InterpretResult An error, if it isn't a user-defined function.
+ */
+InterpretResult helper_user_function(LiteralValue value, Environment *env,
+                                     const char *name, Function *out) {
+    if (value.type != TYPE_FUNCTION) {
+        return raise_error(
+            "`%s()` expects a function as its second argument.\n", name);
+    }
+    Function *func = get_function(env, value.data.function_name);
+    if (!func || func->is_builtin) {
+        return raise_error("`%s()` expects a user-defined function.\n", name);
+    }
+
+    *out = *func;
+    return make_result(value, false, false);
+}
+
+// Shared state of a `parallel_map()`, `parallel_filter()` or
+// `parallel_reduce()` call
+typedef struct {
+    Function function;
+    Environment *env;
+    const ArrayValue *source;
+    LiteralValue *results;    // map: one per element; reduce: one per chunk
+    bool *keep;               // filter: one per element
+    LiteralValue accumulator; // reduce: combined result
+
+    // The first failure stops the remaining chunks
+    pthread_mutex_t lock;
+    bool failed;
+    InterpretResult error;
+} ParallelCall;
+
+static void parallel_call_fail(ParallelCall *call, InterpretResult error) {
+    pthread_mutex_lock(&call->lock);
+    if (!call->failed) {
+        call->error = error;
+        __atomic_store_n(&call->failed, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&call->lock);
+}
+
+static bool parallel_call_failed(ParallelCall *call) {
+    return __atomic_load_n(&call->failed, __ATOMIC_ACQUIRE);
+}
+
+static void parallel_map_task(void *context, size_t chunk, size_t begin,
+                              size_t end) {
+    (void)chunk;
+    ParallelCall *call = context;
+    for (size_t i = begin; i < end && !parallel_call_failed(call); i++) {
+        LiteralValue element = array_get(call->source, i);
+        InterpretResult r =
+            call_function_with_values(&call->function, &element, 1, call->env);
+        if (r.is_error) {
+            parallel_call_fail(call, r);
+            return;
+        }
+        call->results[i] = r.value;
+    }
+}
+
+static void parallel_filter_task(void *context, size_t chunk, size_t begin,
+                                 size_t end) {
+    (void)chunk;
+    ParallelCall *call = context;
+    for (size_t i = begin; i < end && !parallel_call_failed(call); i++) {
+        LiteralValue element = array_get(call->source, i);
+        InterpretResult r =
+            call_function_with_values(&call->function, &element, 1, call->env);
+        if (!r.is_error && r.value.type != TYPE_BOOLEAN) {
+            r = raise_error("`parallel_filter()` expects the function to "
+                            "return a boolean.\n");
+        }
+        if (r.is_error) {
+            parallel_call_fail(call, r);
+            return;
+        }
+        call->keep[i] = r.value.data.boolean;
+    }
+}
+
+// Folds one chunk, starting from its first element
+static void parallel_reduce_task(void *context, size_t chunk, size_t begin,
+                                 size_t end) {
+    ParallelCall *call = context;
+    LiteralValue pair[2];
+    pair[0] = array_get(call->source, begin);
+    for (size_t i = begin + 1; i < end && !parallel_call_failed(call); i++) {
+        pair[1] = array_get(call->source, i);
+        InterpretResult r =
+            call_function_with_values(&call->function, pair, 2, call->env);
+        if (r.is_error) {
+            parallel_call_fail(call, r);
+            return;
+        }
+        pair[0] = r.value;
+    }
+    call->results[chunk] = pair[0];
+}
+
+// Folds the chunks' results into the accumulator, in order
+static void parallel_combine_task(void *context, size_t chunk, size_t begin,
+                                  size_t end) {
+    (void)chunk;
+    (void)begin;
+    (void)end;
+    ParallelCall *call = context;
+    size_t chunks = (size_t)call->source->count;
+    for (size_t c = 0; c < chunks; c++) {
+        LiteralValue pair[2] = {call->accumulator, call->results[c]};
+        InterpretResult r =
+            call_function_with_values(&call->function, pair, 2, call->env);
+        if (r.is_error) {
+            parallel_call_fail(call, r);
+            return;
+        }
+        call->accumulator = r.value;
+    }
+}
+
+InterpretResult helper_parallel_call(ASTNode *node, Environment *env,
+                                     const char *name, size_t num_args,
+                                     LiteralValue *args, ParallelCall *call) {
+    InterpretResult args_res =
+        helper_array_arguments(node, env, name, num_args, args);
+    if (args_res.is_error) {
+        return args_res;
+    }
+    InterpretResult fn_res =
+        helper_user_function(args[1], env, name, &call->function);
+    if (fn_res.is_error) {
+        return fn_res;
+    }
+
+    call->env = env;
+    call->source = args[0].data.array;
+    call->results = NULL;
+    call->keep = NULL;
+    call->failed = false;
+    pthread_mutex_init(&call->lock, NULL);
+    return fn_res;
+}
+
+/**
+ * @brief Built-in function to call a function on every element of an array,
+ * spreading the calls across threads.
+ *
+ * The function may read, but not assign to, variables from outside it.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @return InterpretResult The results, in the same order as the elements.
+ */
+InterpretResult builtin_parallel_map(ASTNode *node, Environment *env,
+                                     LiteralValue *no_args) {
+    (void)no_args; // evaluates its own arguments
+    LiteralValue args[2];
+    ParallelCall call;
+    InterpretResult call_res =
+        helper_parallel_call(node, env, "parallel_map", 2, args, &call);
+    if (call_res.is_error) {
+        return call_res;
+    }
+
+    // Both stay rooted in case the calls run on this thread
+    size_t count = call.source->count;
+    LiteralValue result = {.type = TYPE_ARRAY,
+                           .data.array = array_box(array_new(count))};
+    result.data.array->count = count;
+    call.results = count ? result.data.array->buffer->items : NULL;
+    gc_push_root(&args[0]);
+    gc_push_root(&result);
+
+    parallel_for(count, parallel_chunk_size(count), parallel_map_task, &call,
+                 env);
+
+    gc_pop_roots(2);
+    pthread_mutex_destroy(&call.lock);
+    if (call.failed) {
+        return call.error;
+    }
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to keep the elements of an array for which a
+ * function returns `True`, spreading the calls across threads.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @return InterpretResult The kept elements, in their original order.
+ */
+InterpretResult builtin_parallel_filter(ASTNode *node, Environment *env,
+                                        LiteralValue *no_args) {
+    (void)no_args; // evaluates its own arguments
+    LiteralValue args[2];
+    ParallelCall call;
+    InterpretResult call_res =
+        helper_parallel_call(node, env, "parallel_filter", 2, args, &call);
+    if (call_res.is_error) {
+        return call_res;
+    }
+
+    size_t count = call.source->count;
+    call.keep = calloc(count ? count : 1, sizeof(bool));
+    if (!call.keep) {
+        fatal_error("Memory allocation failed in `parallel_filter()`.\n");
+    }
+    gc_push_root(&args[0]);
+
+    parallel_for(count, parallel_chunk_size(count), parallel_filter_task,
+                 &call, env);
+
+    gc_pop_roots(1);
+    pthread_mutex_destroy(&call.lock);
+    if (call.failed) {
+        free(call.keep);
+        return call.error;
+    }
+
+    ArrayKind kind = array_kind(call.source);
+    LiteralValue result;
+    result.type = TYPE_ARRAY;
+    result.data.array = array_box(kind == ARRAY_BOXED ? array_new(0)
+                                                      : array_new_typed(kind, 0));
+    for (size_t i = 0; i < count; i++) {
+        if (call.keep[i]) {
+            array_push(result.data.array, array_get(call.source, i));
+        }
+    }
+    free(call.keep);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to combine the elements of an array with a
+ * two-argument function, starting from an initial value.
+ *
+ * Chunks of the array are folded in parallel, then their results are folded
+ * into the initial value in order, so the function must be associative
+ * (e.g. adding numbers or joining arrays).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @return InterpretResult The combined value.
+ */
+InterpretResult builtin_parallel_reduce(ASTNode *node, Environment *env,
+                                        LiteralValue *no_args) {
+    (void)no_args; // evaluates its own arguments
+    LiteralValue args[3];
+    ParallelCall call;
+    InterpretResult call_res =
+        helper_parallel_call(node, env, "parallel_reduce", 3, args, &call);
+    if (call_res.is_error) {
+        return call_res;
+    }
+
+    size_t count = call.source->count;
+    size_t chunk_size = parallel_chunk_size(count);
+    size_t chunks = (count + chunk_size - 1) / chunk_size;
+    LiteralValue partials = {.type = TYPE_ARRAY,
+                             .data.array = array_box(array_new(chunks))};
+    partials.data.array->count = chunks;
+    call.results = chunks ? partials.data.array->buffer->items : NULL;
+    call.accumulator = args[2];
+    gc_push_root(&args[0]);
+    gc_push_root(&partials);
+    gc_push_root(&call.accumulator);
+
+    parallel_for(count, chunk_size, parallel_reduce_task, &call, env);
+
+    // The combining step also runs as a task, so the same variables are
+    // read-only throughout
+    if (!call.failed) {
+        call.source = partials.data.array;
+        parallel_for(1, 1, parallel_combine_task, &call, env);
+    }
+
+    gc_pop_roots(3);
+    pthread_mutex_destroy(&call.lock);
+    if (call.failed) {
+        return call.error;
+    }
+    return make_result(call.accumulator, false, false);
+}
+
+/**
+ * @brief Built-in function to sort an array of numbers or strings in
+ * ascending order.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The sorted copy.
+ */
+InterpretResult builtin_sort(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    ArrayValue sorted;
+    if (!array_sort(args[0].data.array, &sorted)) {
+        return raise_error("`sort()` expects an array of numbers or an array "
+                           "of strings.\n");
+    }
+    LiteralValue result = {.type = TYPE_ARRAY, .data.array = array_box(sorted)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to sort an array by the key a function returns
+ * for each element. The function is called once per element, and elements
+ * with equal keys keep their order.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The sorted copy.
+ */
+InterpretResult builtin_sort_by(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // unused
+    Function key_fn;
+    InterpretResult fn_res =
+        helper_user_function(args[1], env, "sort_by", &key_fn);
+    if (fn_res.is_error) {
+        return fn_res;
+    }
+
+    // Sorts its own box, so the key function can't change what is sorted
+    args[0].data.array = array_box(*args[0].data.array);
+    const ArrayValue *array = args[0].data.array;
+    LiteralValue keys = {.type = TYPE_ARRAY,
+                         .data.array = array_box(array_new(array->count))};
+    gc_push_root(&args[0]);
+    gc_push_root(&keys);
+    for (size_t i = 0; i < array->count; i++) {
+        LiteralValue element = array_get(array, i);
+        InterpretResult key_res =
+            call_function_with_values(&key_fn, &element, 1, env);
+        if (key_res.is_error) {
+            gc_pop_roots(2);
+            return key_res;
+        }
+        array_push(keys.data.array, key_res.value);
+    }
+
+    ArrayValue sorted_array;
+    bool sorted = array_sort_by_keys(array, keys.data.array, &sorted_array);
+    gc_pop_roots(2);
+    if (!sorted) {
+        return raise_error("`sort_by()` keys must be all numbers or all "
+                           "strings.\n");
+    }
+    LiteralValue result = {.type = TYPE_ARRAY,
+                           .data.array = array_box(sorted_array)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to memoize a user-defined function: from now on,
+ * each result it returns for numbers, booleans or strings is remembered, &
+ * calling it again with the same arguments returns the result without
+ * running it. Only the `capacity` (optional) most recently used results are
+ * kept. Memoizing a function again starts its table afresh.
+ *
+ * The function must be pure (see `memo_check_pure()`), so remembered results
+ * stay right.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The function.
+ */
+InterpretResult builtin_memoize(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    size_t num_args = helper_count_arguments(node);
+    Function *func = get_function(env, args[0].data.function_name);
+    if (!func || func->is_builtin || func->record) {
+        return raise_error("`memoize()` expects a user-defined function.\n");
+    }
+
+    size_t capacity = MEMO_DEFAULT_CAPACITY;
+    if (num_args == 2) {
+        if (args[1].data.integer <= 0) {
+            return raise_error("`memoize()` expects a positive number of "
+                               "results to keep.\n");
+        }
+        capacity = (size_t)args[1].data.integer;
+    }
+
+    // Functions are shared by every task of a parallel loop
+    if (parallel_in_task()) {
+        return raise_error("`memoize()` can't be called inside a parallel "
+                           "loop.\n");
+    }
+
+    char reason[256];
+    if (!memo_check_pure(func, env, reason, sizeof(reason))) {
+        return raise_error("`memoize()` can't memoize `%s()`, as %s.\n",
+                           func->name, reason);
+    }
+
+    memo_free(func->memo);
+    func->memo = memo_new(capacity);
+    return make_result(args[0], false, false);
+}
+
+// Adds a `memo_stats()` entry, keeping its key reachable while it's added
+static void memo_stats_set(LiteralValue *stats, const char *name,
+                           LiteralValue value) {
+    LiteralValue key = {.type = TYPE_STRING, .data.string = fl_string_new(name)};
+    gc_push_root(&key);
+    map_set(stats->data.map, key, value);
+    gc_pop_roots(1);
+}
+
+/**
+ * @brief Built-in function to report how well a memoized function's table is
+ * doing.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult A map of `hits`, `misses`, `evictions`, `size`,
+ * `capacity` & `hit_rate` (the share of lookups that were hits).
+ */
+InterpretResult builtin_memo_stats(ASTNode *node, Environment *env,
+                                   LiteralValue *args) {
+    (void)node; // unused
+    Function *func = get_function(env, args[0].data.function_name);
+    if (!func || !func->memo) {
+        return raise_error("`memo_stats()` expects a memoized function.\n");
+    }
+
+    const MemoTable *memo = func->memo;
+    size_t lookups = memo->hits + memo->misses;
+    const struct {
+        const char *name;
+        size_t value;
+    } counts[] = {{"hits", memo->hits},
+                  {"misses", memo->misses},
+                  {"evictions", memo->evictions},
+                  {"size", memo->count},
+                  {"capacity", memo->capacity}};
+
+    LiteralValue stats = {.type = TYPE_MAP, .data.map = map_new(6)};
+    gc_push_root(&stats);
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        LiteralValue count = {.type = TYPE_INTEGER,
+                              .data.integer = (long long)counts[i].value};
+        memo_stats_set(&stats, counts[i].name, count);
+    }
+    LiteralValue hit_rate = {
+        .type = TYPE_FLOAT,
+        .data.floating_point =
+            lookups ? (FLOAT_SIZE)memo->hits / (FLOAT_SIZE)lookups : 0};
+    memo_stats_set(&stats, "hit_rate", hit_rate);
+    gc_pop_roots(1);
+
+    return make_result(stats, false, false);
+}
+
+/**
+ * @brief Built-in function to check whether a map holds a key.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult True if the key is present.
+ */
+InterpretResult builtin_has(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue value;
+    LiteralValue result = {.type = TYPE_BOOLEAN,
+                           .data.boolean =
+                               map_get(args[0].data.map, args[1], &value)};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to look up a key in a map, with a fallback value.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The key's value, or the fallback if it's missing.
+ */
+InterpretResult builtin_get(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue value;
+    if (!map_get(args[0].data.map, args[1], &value)) {
+        value = args[2];
+    }
+    return make_result(value, false, false);
+}
+
+/**
+ * @brief Built-in function to remove a key from a map.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult True if the key was present.
+ */
+InterpretResult builtin_remove(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (!map_writable(args[0].data.map)) {
+        return raise_error("Cannot modify a map in a parallel task; maps "
+                           "created outside the task are read-only.\n");
+    }
+
+    LiteralValue result = {.type = TYPE_BOOLEAN,
+                           .data.boolean =
+                               map_remove(args[0].data.map, args[1])};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to list a map's keys, in insertion order.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult An array of the keys.
+ */
+InterpretResult builtin_keys(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result = {.type = TYPE_ARRAY,
+                           .data.array = array_box(map_keys(args[0].data.map))};
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to list a map's values, in insertion order.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult An array of the values.
+ */
+InterpretResult builtin_values(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result = {.type = TYPE_ARRAY,
+                           .data.array =
+                               array_box(map_values(args[0].data.map))};
+    return make_result(result, false, false);
+}
+
+// Counts a call's arguments without evaluating them
+size_t helper_count_arguments(ASTNode *node) {
+    size_t count = 0;
+    for (ASTNode *arg = node->function_call.arguments; arg; arg = arg->next) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Built-in function to create an empty heap (priority queue). With no
+ * arguments, numbers or strings come out smallest first; otherwise the
+ * argument is a function `before(a, b)` returning True if `a` should come
+ * out before `b`.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new heap.
+ */
+InterpretResult builtin_heap(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    size_t num_args = helper_count_arguments(node);
+    FlavorString *comparator = NULL;
+    if (num_args == 1) {
+        Function func;
+        InterpretResult fn_res =
+            helper_user_function(args[0], env, "heap", &func);
+        if (fn_res.is_error) {
+            return fn_res;
+        }
+        comparator = fl_string_new(args[0].data.function_name);
+    }
+
+    LiteralValue result = {.type = TYPE_HEAP};
+    LiteralValue held = {.type = TYPE_STRING, .data.string = comparator};
+    gc_push_root(&held);
+    result.data.heap = heap_new(comparator);
+    gc_pop_roots(1);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to add a value to a heap, optionally with a
+ * separate priority (by default, the value is its own priority).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The heap, so calls can be chained.
+ */
+InterpretResult builtin_push(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    size_t num_args = helper_count_arguments(node);
+    if (!heap_writable(args[0].data.heap)) {
+        return raise_error("Cannot modify a heap in a parallel task; heaps "
+                           "created outside the task are read-only.\n");
+    }
+
+    LiteralValue priority = num_args == 3 ? args[2] : args[1];
+    InterpretResult r = heap_push(args[0].data.heap, priority, args[1], env);
+    if (r.is_error) {
+        return r;
+    }
+    return make_result(args[0], false, false);
+}
+
+/**
+ * @brief Built-in function to remove & return the value that comes out of a
+ * heap first.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The removed value.
+ */
+InterpretResult builtin_pop(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    if (!heap_writable(args[0].data.heap)) {
+        return raise_error("Cannot modify a heap in a parallel task; heaps "
+                           "created outside the task are read-only.\n");
+    }
+    if (args[0].data.heap->count == 0) {
+        return raise_error("`pop()` called on an empty heap.\n");
+    }
+
+    return heap_pop(args[0].data.heap, env);
+}
+
+/**
+ * @brief Built-in function to get the value that would come out of a heap
+ * next, without removing it.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The heap's first value.
+ */
+InterpretResult builtin_peek(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (args[0].data.heap->count == 0) {
+        return raise_error("`peek()` called on an empty heap.\n");
+    }
+    return make_result(args[0].data.heap->entries[0].value, false, false);
+}
+
+// Copies column `index` of a matrix into a float array
+InterpretResult helper_matrix_column(const MatrixValue *matrix,
+                                     LiteralValue index) {
+    if (index.type != TYPE_INTEGER) {
+        return raise_error("`column()` expects a column index as its second "
+                           "argument.\n");
+    }
+    INT_SIZE col = index.data.integer;
+    if (col < 0) {
+        col += (INT_SIZE)matrix->cols;
+    }
+    if (col < 0 || (size_t)col >= matrix->cols) {
+        return raise_error("Matrix column `" INT_FORMAT "` out of bounds.\n",
+                           index.data.integer);
+    }
+    LiteralValue result = {.type = TYPE_ARRAY};
+    result.data.array = array_box(matrix_column(matrix, (size_t)col));
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to gather one field of every record in an array
+ * into an array of its own (a struct-of-arrays view). Integer, float &
+ * boolean fields give typed arrays, ready for the array built-ins. Given a
+ * matrix & an index instead, it copies that column of the matrix.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The field's values, in the array's order.
+ */
+InterpretResult builtin_column(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (args[0].type == TYPE_MATRIX) {
+        return helper_matrix_column(args[0].data.matrix, args[1]);
+    }
+    if (args[1].type != TYPE_STRING) {
+        return raise_error("`column()` expects a field name as its second "
+                           "argument.\n");
+    }
+
+    const ArrayValue *records = args[0].data.array;
+    const char *field = args[1].data.string->bytes;
+
+    // The first record's field decides the column's storage; other values
+    // box it as usual
+    ArrayKind kind = ARRAY_BOXED;
+    const RecordType *type = NULL;
+    size_t slot = 0;
+    LiteralValue result = {.type = TYPE_ARRAY};
+    gc_push_root(&args[0]);
+    gc_push_root(&args[1]);
+    for (size_t i = 0; i < records->count; i++) {
+        LiteralValue element = array_get(records, i);
+        if (element.type != TYPE_RECORD) {
+            gc_pop_roots(2);
+            return raise_error("`column()` expects an array of records.\n");
+        }
+        const RecordValue *record = element.data.record;
+        if (record->type != type) {
+            type = record->type;
+            if (!record_find_named_slot(type, field, &slot)) {
+                gc_pop_roots(2);
+                return raise_error("Record `%s` has no field `%s`.\n",
+                                   type->name, field);
+            }
+        }
+
+        if (i == 0) {
+            LiteralValue first = record->fields[slot];
+            kind = first.type == TYPE_INTEGER   ? ARRAY_INT
+                   : first.type == TYPE_FLOAT   ? ARRAY_FLOAT
+                   : first.type == TYPE_BOOLEAN ? ARRAY_BOOL
+                                                : ARRAY_BOXED;
+            result.data.array =
+                array_box(array_new_typed(kind, records->count));
+        }
+        array_push(result.data.array, record->fields[slot]);
+    }
+    gc_pop_roots(2);
+
+    if (records->count == 0) {
+        result.data.array = array_box(array_new(0));
+    }
+    return make_result(result, false, false);
+}
+
+// Converts a number to a matrix element, returning false for anything else
+bool helper_matrix_element(LiteralValue value, FLOAT_SIZE *out) {
+    if (value.type == TYPE_INTEGER) {
+        *out = (FLOAT_SIZE)value.data.integer;
+        return true;
+    }
+    if (value.type == TYPE_FLOAT) {
+        *out = value.data.floating_point;
+        return true;
+    }
+    return false;
+}
+
+// Builds a matrix from an array of equally long arrays of numbers
+InterpretResult helper_matrix_from_rows(const ArrayValue *rows) {
+    size_t cols = 0;
+    for (size_t i = 0; i < rows->count; i++) {
+        LiteralValue row = array_get(rows, i);
+        if (row.type != TYPE_ARRAY) {
+            return raise_error("`matrix()` expects an array of rows (arrays "
+                               "of numbers).\n");
+        }
+        if (i == 0) {
+            cols = row.data.array->count;
+        } else if (row.data.array->count != cols) {
+            return raise_error("Every row given to `matrix()` must have the "
+                               "same length.\n");
+        }
+    }
+
+    LiteralValue result = {.type = TYPE_MATRIX};
+    result.data.matrix = matrix_new(rows->count, cols);
+    for (size_t i = 0; i < rows->count; i++) {
+        LiteralValue row = array_get(rows, i);
+        for (size_t j = 0; j < cols; j++) {
+            if (!helper_matrix_element(array_get(row.data.array, j),
+                                       &result.data.matrix->cells[i * cols +
+                                                                  j])) {
+                return raise_error("Matrix elements must be numbers.\n");
+            }
+        }
+    }
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to create a matrix, either from an array of rows
+ * (`matrix([[1, 2], [3, 4]])`) or from its size & an optional fill value
+ * (`matrix(rows, cols, fill)`, which defaults to 0).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new matrix.
+ */
+InterpretResult builtin_matrix(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)env; // unused
+    size_t num_args = helper_count_arguments(node);
+    if (num_args == 1) {
+        if (args[0].type != TYPE_ARRAY) {
+            return raise_error("`matrix()` expects an array of rows (arrays "
+                               "of numbers).\n");
+        }
+        return helper_matrix_from_rows(args[0].data.array);
+    }
+
+    if (args[0].type != TYPE_INTEGER || args[1].type != TYPE_INTEGER ||
+        args[0].data.integer < 0 || args[1].data.integer < 0) {
+        return raise_error("`matrix()` expects non-negative integer row & "
+                           "column counts.\n");
+    }
+    FLOAT_SIZE fill = num_args == 3 ? helper_number(args[2]) : 0;
+
+    LiteralValue result = {.type = TYPE_MATRIX};
+    result.data.matrix =
+        matrix_new((size_t)args[0].data.integer, (size_t)args[1].data.integer);
+    if (fill != 0) {
+        size_t cells = result.data.matrix->rows * result.data.matrix->cols;
+        for (size_t i = 0; i < cells; i++) {
+            result.data.matrix->cells[i] = fill;
+        }
+    }
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to get a matrix's size.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult An integer array: `[rows, columns]`.
+ */
+InterpretResult builtin_shape(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result = {.type = TYPE_ARRAY};
+    result.data.array = array_box(array_new_typed(ARRAY_INT, 2));
+    LiteralValue size = {.type = TYPE_INTEGER};
+    size.data.integer = (INT_SIZE)args[0].data.matrix->rows;
+    array_push(result.data.array, size);
+    size.data.integer = (INT_SIZE)args[0].data.matrix->cols;
+    array_push(result.data.array, size);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to multiply two matrices. Large products are
+ * shared between the worker threads (see `--threads`).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The product.
+ */
+InterpretResult builtin_matmul(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    const MatrixValue *a = args[0].data.matrix;
+    const MatrixValue *b = args[1].data.matrix;
+    if (a->cols != b->rows) {
+        return raise_error("`matmul()` needs the first matrix's columns to "
+                           "match the second's rows (%zux%zu and "
+                           "%zux%zu).\n",
+                           a->rows, a->cols, b->rows, b->cols);
+    }
+
+    LiteralValue result = {.type = TYPE_MATRIX};
+    result.data.matrix = matrix_multiply(a, b);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to transpose a matrix.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult A new matrix, with rows & columns swapped.
+ */
+InterpretResult builtin_transpose(ASTNode *node, Environment *env,
+                                  LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result = {.type = TYPE_MATRIX};
+    result.data.matrix = matrix_transpose(args[0].data.matrix);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Reduces every row of a matrix for `row_sum()`, `row_mean()`,
+ * `row_min()` & `row_max()`.
+ *
+ * @return InterpretResult A float array with one value per row.
+ */
+InterpretResult helper_matrix_reduction(LiteralValue *args, const char *name,
+                                        MatrixReduction reduction) {
+    const MatrixValue *matrix = args[0].data.matrix;
+    if (reduction != MATRIX_SUM && matrix->cols == 0 && matrix->rows > 0) {
+        return raise_error("`%s()` of a matrix without columns.\n", name);
+    }
+
+    LiteralValue result = {.type = TYPE_ARRAY};
+    result.data.array = array_box(matrix_reduce_rows(matrix, reduction));
+    return make_result(result, false, false);
+}
+
+InterpretResult builtin_row_sum(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_matrix_reduction(args, "row_sum", MATRIX_SUM);
+}
+
+InterpretResult builtin_row_mean(ASTNode *node, Environment *env,
+                                 LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_matrix_reduction(args, "row_mean", MATRIX_MEAN);
+}
+
+InterpretResult builtin_row_min(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_matrix_reduction(args, "row_min", MATRIX_MIN);
+}
+
+InterpretResult builtin_row_max(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    return helper_matrix_reduction(args, "row_max", MATRIX_MAX);
+}
+
+/**
+ * @brief Built-in function to sleep (pause execution) for a given time (in
+ * milliseconds).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult with a default value.
+ */
+InterpretResult builtin_sleep(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    INT_SIZE ms = args[0].data.integer;
+
+    // Validate the argument
+    if (ms <= 0) {
+        return raise_error("`sleep` requires a positive integer argument "
+                           "representing milliseconds.\n");
+    }
+
+// Perform the sleep based on the platform
+#ifdef _WIN32
+    Sleep((DWORD)ms); // sleep takes milliseconds on Windows
+#else
+    if (ms > (INT_MAX / 1000)) {
+        return raise_error("`sleep` argument is too large.\n");
+    }
+
+    useconds_t us = (useconds_t)(ms * 1000); // usleep needs microseconds
+    usleep(us);
+#endif
+
+    LiteralValue result = create_default_value();
+    return make_result(result, false, false);
+}
+
+InterpretResult builtin_cimport(ASTNode *node, Environment *env,
+                                LiteralValue *args) {
+    (void)node; // unused
+    const char *lib_path = args[0].data.string->bytes;
+    const char *func_name = args[1].data.string->bytes;
+
+    // If lib_path is not absolute path, prepend script directory
+    char *full_path = NULL;
+    if (lib_path[0] != '/' && env->script_dir != NULL) {
+        size_t base_len = strlen(env->script_dir);
+        size_t lib_len = strlen(lib_path);
+        // Allocate enough room for "script_dir/lib_path" plus NULL terminator.
+        full_path = malloc(base_len + lib_len + 2);
+        if (!full_path) {
+            return raise_error("Memory allocation failed while constructing "
+                               "the full library path.");
+        }
+        strcpy(full_path, env->script_dir);
+        // Ensure env->script_dir ends with a slash
+        if (env->script_dir[base_len - 1] != '/') {
+            strcat(full_path, "/");
+        }
+        strcat(full_path, lib_path);
+        lib_path = full_path; // Now use this full path for dlopen()
+    }
+
+    // Declare function pointer variable
+    FlavorLangCFunc func_ptr = NULL;
+
+#if defined(__unix__) || defined(__APPLE__)
+    char full_lib_path[PATH_MAX];
+    // If lib_path is not absolute, prepend env->script_dir.
+    if (lib_path[0] != '/') {
+        snprintf(full_lib_path, sizeof(full_lib_path), "%s/%s", env->script_dir,
+                 lib_path);
+    } else {
+        strncpy(full_lib_path, lib_path, sizeof(full_lib_path));
+        full_lib_path[sizeof(full_lib_path) - 1] = '\0';
+    }
+
+    // Now open the shared library using the full path.
+    void *handle = dlopen(full_lib_path, RTLD_LAZY);
+    if (!handle) {
+        return raise_error("dlopen error: %s", dlerror());
+    }
+    // Clear any existing errors.
+    dlerror();
+    func_ptr = (FlavorLangCFunc)dlsym(handle, func_name);
+    char *error_msg = dlerror();
+    if (error_msg != NULL) {
+        dlclose(handle);
+        return raise_error("dlsym error: %s", error_msg);
+    }
+#else
+    return raise_error("`cimport` is not implemented on this platform.\n");
+#endif
+
+    // Create new `Function` record for external function
+    Function cfunc;
+    cfunc.name = safe_strdup(func_name);
+    cfunc.parameters = NULL;
+    cfunc.body = NULL;       // No AST body — it’s external
+    cfunc.is_builtin = true; // Mark as builtin/external
+    cfunc.c_function = func_ptr;
+    cfunc.builtin = NULL; // plugins check their own arguments
+    cfunc.record = NULL;
 
     add_function(env, cfunc);
 
@@ -1005,10 +2459,7 @@ InterpretResult builtin_cimport(ASTNode *node, Environment *env) {
     add_variable(env, var);
 
     // Clean up the allocated full_path if it was used
-    if (env->script_dir != NULL && lib_path != NULL &&
-        lib_path != node->function_call.arguments->literal.value.string) {
-        free(lib_path);
-    }
+    free(full_path);
 
     // Return a default value (0)
     LiteralValue ret;
@@ -1017,75 +2468,47 @@ InterpretResult builtin_cimport(ASTNode *node, Environment *env) {
     return make_result(ret, false, false);
 }
 
-InterpretResult builtin_floor(ASTNode *node, Environment *env) {
-    // Expect exactly one numeric argument
-    FLOAT_SIZE value;
-    ArgumentSpec specs[1];
-    specs[0].type = ARG_TYPE_NUMERIC;
-    specs[0].out_ptr = &value;
-
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 1, specs);
-    if (args_res.is_error) {
-        return args_res;
-    }
+InterpretResult builtin_floor(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    FLOAT_SIZE value = helper_number(args[0]);
 
     LiteralValue result;
     result.type = TYPE_INTEGER;
-    result.data.integer = floor(value);
+    result.data.integer = FLOAT_FLOOR(value);
     return make_result(result, false, false);
 }
 
-InterpretResult builtin_ceil(ASTNode *node, Environment *env) {
-    FLOAT_SIZE value;
-    ArgumentSpec specs[1];
-    specs[0].type = ARG_TYPE_NUMERIC;
-    specs[0].out_ptr = &value;
-
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 1, specs);
-    if (args_res.is_error) {
-        return args_res;
-    }
+InterpretResult builtin_ceil(ASTNode *node, Environment *env,
+                             LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    FLOAT_SIZE value = helper_number(args[0]);
 
     LiteralValue result;
     result.type = TYPE_INTEGER;
-    result.data.integer = ceil(value);
+    result.data.integer = FLOAT_CEIL(value);
     return make_result(result, false, false);
 }
 
-InterpretResult builtin_round(ASTNode *node, Environment *env) {
-    FLOAT_SIZE value;
-    ArgumentSpec specs[1];
-    specs[0].type = ARG_TYPE_NUMERIC;
-    specs[0].out_ptr = &value;
-
-    InterpretResult args_res =
-        interpret_arguments(node->function_call.arguments, env, 1, specs);
-    if (args_res.is_error) {
-        return args_res;
-    }
+InterpretResult builtin_round(ASTNode *node, Environment *env,
+                              LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    FLOAT_SIZE value = helper_number(args[0]);
 
     LiteralValue result;
     result.type = TYPE_INTEGER;
-    result.data.integer = round(value);
+    result.data.integer = FLOAT_ROUND(value);
     return make_result(result, false, false);
 }
 
-InterpretResult builtin_abs(ASTNode *node, Environment *env) {
-    // Get the first argument node
-    ASTNode *arg = node->function_call.arguments;
-    if (!arg) {
-        return raise_error("abs() requires one numeric argument.\n");
-    }
-
-    // Interpret the argument without forcing a conversion
-    InterpretResult arg_res = interpret_node(arg, env);
-    if (arg_res.is_error) {
-        return arg_res;
-    }
-
-    LiteralValue original = arg_res.value;
+InterpretResult builtin_abs(ASTNode *node, Environment *env,
+                            LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue original = args[0];
     LiteralValue result;
 
     // Check the type of the argument and compute absolute accordingly
@@ -1094,12 +2517,285 @@ InterpretResult builtin_abs(ASTNode *node, Environment *env) {
         result.data.integer = (original.data.integer < 0)
                                   ? -original.data.integer
                                   : original.data.integer;
-    } else if (original.type == TYPE_FLOAT) {
+    } else { // TYPE_FLOAT
         result.type = TYPE_FLOAT;
-        result.data.floating_point = fabs(original.data.floating_point);
-    } else {
-        return raise_error("abs() requires a numeric argument.\n");
+        result.data.floating_point = FLOAT_ABS(original.data.floating_point);
+    }
+
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to create a bitset of `n` bits, all cleared
+ * (`bitset(n)`).
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The new bitset.
+ */
+InterpretResult builtin_bitset(ASTNode *node, Environment *env,
+                               LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    if (args[0].data.integer < 0) {
+        return raise_error("`bitset()` expects a non-negative number of "
+                           "bits.\n");
     }
 
+    LiteralValue result = {.type = TYPE_BITSET};
+    result.data.bitset = bitset_new((size_t)args[0].data.integer);
+    return make_result(result, false, false);
+}
+
+/**
+ * @brief Built-in function to count the set bits of a bitset or of an
+ * integer's two's complement form.
+ *
+ * @param node The AST node representing the function call.
+ * @param env  The current environment.
+ * @param args The evaluated arguments.
+ * @return InterpretResult The number of set bits.
+ */
+InterpretResult builtin_popcount(ASTNode *node, Environment *env,
+                                 LiteralValue *args) {
+    (void)node; // unused
+    (void)env;  // unused
+    LiteralValue result = {.type = TYPE_INTEGER};
+    if (args[0].type == TYPE_BITSET) {
+        result.data.integer = (INT_SIZE)bitset_count(args[0].data.bitset);
+    } else { // TYPE_INTEGER
+        result.data.integer =
+            (INT_SIZE)popcount_word((uint64_t)args[0].data.integer);
+    }
     return make_result(result, false, false);
 }
+
+/**
+ * @brief The standard library's built-in functions. `init_environment()`
+ * registers each one in the global environment with its spec bound
+ * (`Function.builtin`), so `call_builtin()` can check a call's arguments
+ * before a single indirect call runs it.
+ */
+const BuiltinSpec builtin_specs[] = {
+    // Type conversion
+    {"string", builtin_cast, 1, 1, "one value to convert", .lazy = true},
+    {"float", builtin_cast, 1, 1, "one value to convert", .lazy = true},
+    {"int", builtin_cast, 1, 1, "one value to convert", .lazy = true},
+
+    // Input/output & errors
+    {"sample", builtin_input, 0, BUILTIN_VARIADIC, "a prompt",
+     .types = {ARG_TYPE_ANY}},
+    {"serve", builtin_output, 0, BUILTIN_VARIADIC, "the values to print",
+     .types = {ARG_TYPE_ANY}},
+    {"burn", builtin_error, 0, BUILTIN_VARIADIC, "an error message",
+     .types = {ARG_TYPE_ANY}},
+
+    // Numbers & time
+    {"random", builtin_random, 0, 2,
+     "no arguments, a maximum, or a minimum & a maximum",
+     .types = {ARG_TYPE_NUMERIC, ARG_TYPE_NUMERIC}},
+    {"floor", builtin_floor, 1, 1, "one number", .types = {ARG_TYPE_NUMERIC}},
+    {"ceil", builtin_ceil, 1, 1, "one number", .types = {ARG_TYPE_NUMERIC}},
+    {"round", builtin_round, 1, 1, "one number", .types = {ARG_TYPE_NUMERIC}},
+    {"abs", builtin_abs, 1, 1, "one number", .types = {ARG_TYPE_NUMERIC}},
+    {"get_time", builtin_time, 0, 0, "no arguments", .types = {ARG_TYPE_ANY}},
+    {"sleep", builtin_sleep, 1, 1, "a number of milliseconds",
+     .types = {ARG_TYPE_INTEGER}},
+
+    // Files & plugins
+    {"taste_file", builtin_file_read, 1, 1, "a file path",
+     .types = {ARG_TYPE_STRING}},
+    {"plate_file", builtin_file_write, 2, 2, "a file path & the contents",
+     .types = {ARG_TYPE_STRING, ARG_TYPE_STRING}},
+    {"garnish_file", builtin_file_append, 2, 2, "a file path & the contents",
+     .types = {ARG_TYPE_STRING, ARG_TYPE_STRING}},
+    {"cimport", builtin_cimport, 2, 2, "a library path & a function name",
+     .types = {ARG_TYPE_STRING, ARG_TYPE_STRING}},
+
+    // Strings & collections
+    {"length", builtin_length, 1, 1,
+     "an array, a map, a heap, a matrix, a bitset, a builder or a string",
+     .types = {ARG_TYPE_ARRAY | ARG_TYPE_MAP | ARG_TYPE_HEAP |
+               ARG_TYPE_MATRIX | ARG_TYPE_BITSET | ARG_TYPE_BUILDER |
+               ARG_TYPE_STRING}},
+    {"builder", builtin_builder, 0, 0, "no arguments",
+     .types = {ARG_TYPE_ANY}},
+    {"append", builtin_append, 1, BUILTIN_VARIADIC,
+     "a builder followed by the values to append",
+     .types = {ARG_TYPE_BUILDER}},
+    {"build", builtin_build, 1, 1, "a builder", .types = {ARG_TYPE_BUILDER}},
+
+    // Typed arrays & array operations
+    {"int_array", builtin_int_array, 1, 1, "a length or an array",
+     .types = {ARG_TYPE_INTEGER | ARG_TYPE_ARRAY}},
+    {"float_array", builtin_float_array, 1, 1, "a length or an array",
+     .types = {ARG_TYPE_INTEGER | ARG_TYPE_ARRAY}},
+    {"bool_array", builtin_bool_array, 1, 1, "a length or an array",
+     .types = {ARG_TYPE_INTEGER | ARG_TYPE_ARRAY}},
+    {"sum", builtin_sum, 1, 1, "an array", .types = {ARG_TYPE_ARRAY}},
+    {"min", builtin_min, 1, 1, "an array", .types = {ARG_TYPE_ARRAY}},
+    {"max", builtin_max, 1, 1, "an array", .types = {ARG_TYPE_ARRAY}},
+    {"mean", builtin_mean, 1, 1, "an array", .types = {ARG_TYPE_ARRAY}},
+    {"dot", builtin_dot, 2, 2, "two arrays",
+     .types = {ARG_TYPE_ARRAY, ARG_TYPE_ARRAY}},
+    {"count_eq", builtin_count_eq, 2, 2, "an array & a value",
+     .types = {ARG_TYPE_ARRAY}},
+    {"index_of", builtin_index_of, 2, 2, "an array & a value",
+     .types = {ARG_TYPE_ARRAY}},
+    {"scale", builtin_scale, 2, 2, "an array & a number",
+     .types = {ARG_TYPE_ARRAY, ARG_TYPE_NUMERIC}},
+    {"add", builtin_add, 2, 2, "an array & a number or array",
+     .types = {ARG_TYPE_ARRAY, ARG_TYPE_NUMERIC | ARG_TYPE_ARRAY}},
+    {"clamp", builtin_clamp, 3, 3, "an array, a lower & an upper bound",
+     .types = {ARG_TYPE_ARRAY, ARG_TYPE_NUMERIC, ARG_TYPE_NUMERIC}},
+    {"sort", builtin_sort, 1, 1, "an array", .types = {ARG_TYPE_ARRAY}},
+    {"sort_by", builtin_sort_by, 2, 2, "an array & a key function",
+     .types = {ARG_TYPE_ARRAY, ARG_TYPE_FUNCTION}},
+    {"memoize", builtin_memoize, 1, 2,
+     "a function & optionally how many results to keep",
+     .types = {ARG_TYPE_FUNCTION, ARG_TYPE_INTEGER}},
+    {"memo_stats", builtin_memo_stats, 1, 1, "a memoized function",
+     .types = {ARG_TYPE_FUNCTION}},
+    {"column", builtin_column, 2, 2,
+     "an array of records & a field name, or a matrix & a column index",
+     .types = {ARG_TYPE_ARRAY | ARG_TYPE_MATRIX,
+               ARG_TYPE_STRING | ARG_TYPE_INTEGER}},
+
+    // Parallel operations
+    {"parallel_map", builtin_parallel_map, 2, 2, "an array & a function",
+     .lazy = true},
+    {"parallel_filter", builtin_parallel_filter, 2, 2,
+     "an array & a function", .lazy = true},
+    {"parallel_reduce", builtin_parallel_reduce, 3, 3,
+     "an array, a function & an initial value", .lazy = true},
+
+    // Maps & heaps
+    {"has", builtin_has, 2, 2, "a map & a key", .types = {ARG_TYPE_MAP}},
+    {"get", builtin_get, 3, 3, "a map, a key & a default value",
+     .types = {ARG_TYPE_MAP}},
+    {"remove", builtin_remove, 2, 2, "a map & a key",
+     .types = {ARG_TYPE_MAP}},
+    {"keys", builtin_keys, 1, 1, "a map", .types = {ARG_TYPE_MAP}},
+    {"values", builtin_values, 1, 1, "a map", .types = {ARG_TYPE_MAP}},
+    {"heap", builtin_heap, 0, 1, "no arguments or a comparator",
+     .types = {ARG_TYPE_FUNCTION}},
+    {"push", builtin_push, 2, 3, "a heap, a value & optionally its priority",
+     .types = {ARG_TYPE_HEAP}},
+    {"pop", builtin_pop, 1, 1, "a heap", .types = {ARG_TYPE_HEAP}},
+    {"peek", builtin_peek, 1, 1, "a heap", .types = {ARG_TYPE_HEAP}},
+
+    // Matrices & bitsets
+    {"matrix", builtin_matrix, 1, 3,
+     "an array of rows, or a row count, a column count & optionally a "
+     "fill value",
+     .types = {ARG_TYPE_ARRAY | ARG_TYPE_INTEGER, ARG_TYPE_INTEGER,
+               ARG_TYPE_NUMERIC}},
+    {"shape", builtin_shape, 1, 1, "a matrix", .types = {ARG_TYPE_MATRIX}},
+    {"matmul", builtin_matmul, 2, 2, "two matrices",
+     .types = {ARG_TYPE_MATRIX, ARG_TYPE_MATRIX}},
+    {"transpose", builtin_transpose, 1, 1, "a matrix",
+     .types = {ARG_TYPE_MATRIX}},
+    {"row_sum", builtin_row_sum, 1, 1, "a matrix", .types = {ARG_TYPE_MATRIX}},
+    {"row_mean", builtin_row_mean, 1, 1, "a matrix",
+     .types = {ARG_TYPE_MATRIX}},
+    {"row_min", builtin_row_min, 1, 1, "a matrix", .types = {ARG_TYPE_MATRIX}},
+    {"row_max", builtin_row_max, 1, 1, "a matrix", .types = {ARG_TYPE_MATRIX}},
+    {"bitset", builtin_bitset, 1, 1, "a number of bits",
+     .types = {ARG_TYPE_INTEGER}},
+    {"popcount", builtin_popcount, 1, 1, "a bitset or an integer",
+     .types = {ARG_TYPE_BITSET | ARG_TYPE_INTEGER}}};
+
+const size_t builtin_spec_count =
+    sizeof(builtin_specs) / sizeof(builtin_specs[0]);
+
+/**
+ * @brief Checks a call's arguments against a built-in's spec: how many there
+ * are, &, once they've been evaluated (`args` isn't NULL), their types.
+ */
+InterpretResult check_builtin_arguments(const BuiltinSpec *spec,
+                                        size_t num_args,
+                                        const LiteralValue *args) {
+    if (num_args < spec->min_args || num_args > spec->max_args) {
+        return raise_error("`%s()` expects %s, but got %zu argument%s.\n",
+                           spec->name, spec->arguments, num_args,
+                           num_args == 1 ? "" : "s");
+    }
+
+    for (size_t i = 0; args && i < num_args && i < BUILTIN_TYPED_ARGS; i++) {
+        if (!literal_type_matches_arg_type(args[i].type, spec->types[i])) {
+            return raise_error("`%s()` expects %s, but argument %zu has type "
+                               "`%s`.\n",
+                               spec->name, spec->arguments, i + 1,
+                               literal_type_to_string(args[i].type));
+        }
+    }
+    return make_result(create_default_value(), false, false);
+}
+
+/**
+ * @brief Runs a built-in on a call. Its arguments are evaluated once, in
+ * order, & checked against its spec before it's given them, unless it
+ * evaluates its own.
+ */
+InterpretResult call_builtin(const BuiltinSpec *spec, ASTNode *node,
+                             Environment *env) {
+    size_t num_args = helper_count_arguments(node);
+    InterpretResult res = check_builtin_arguments(spec, num_args, NULL);
+    if (res.is_error) {
+        return res;
+    }
+    if (spec->lazy) {
+        return spec->function(node, env, NULL);
+    }
+
+    LiteralValue local_args[BUILTIN_TYPED_ARGS];
+    LiteralValue *args = local_args;
+    if (num_args > BUILTIN_TYPED_ARGS) {
+        args = malloc(num_args * sizeof(LiteralValue));
+        if (!args) {
+            return raise_error("Memory allocation failed for arguments.\n");
+        }
+    }
+
+    // The arguments stay rooted until the built-in is done with them, as
+    // later ones (& the built-in itself) may run functions
+    size_t depth = gc_root_depth();
+    size_t count = 0;
+    for (ASTNode *arg = node->function_call.arguments; arg && !res.is_error;
+         arg = arg->next) {
+        res = interpret_node(arg, env);
+        args[count] = res.value;
+        gc_push_root(&args[count]);
+        count++;
+    }
+    if (!res.is_error) {
+        res = check_builtin_arguments(spec, num_args, args);
+    }
+    if (!res.is_error) {
+        res = spec->function(node, env, args);
+    }
+    gc_restore_roots(depth);
+
+    if (args != local_args) {
+        free(args);
+    }
+    return res;
+}
+
+// Built-ins that call user-defined functions (which run with the caller's
+// variables in scope, like any call)
+static const char *const callback_builtins[] = {
+    "sort_by", "parallel_map", "parallel_filter", "parallel_reduce",
+    "push",    "pop",
+};
+
+bool is_callback_builtin(const char *name) {
+    for (size_t i = 0;
+         i < sizeof(callback_builtins) / sizeof(*callback_builtins); i++) {
+        if (strcmp(callback_builtins[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -4,10 +4,20 @@
 #include "../debug/debug.h"
 #include "../interpreter/interpreter.h"
 #include "../shared/ast_types.h"
+#include "array_ops.h"
+#include "bitset.h"
+#include "heap.h"
+#include "map.h"
+#include "matrix.h"
+#include "memo.h"
+#include "parallel.h"
+#include "record.h"
+#include "sort.h"
 #include "interpreter_types.h"
 #include "utils.h"
 #include <ctype.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,14 +35,6 @@
 #include <sys/time.h>
 #endif
 
-typedef enum {
-    ARG_TYPE_INTEGER,
-    ARG_TYPE_FLOAT,
-    ARG_TYPE_STRING,
-    ARG_TYPE_BOOLEAN,
-    ARG_TYPE_ARRAY,
-    ARG_TYPE_NUMERIC // Either float or int
-} ArgType;
 typedef struct {
     size_t num_types; // number of acceptable types
     ArgType type;     // expected argument type
@@ -40,32 +42,147 @@ typedef struct {
 } ArgumentSpec;
 
 // Built-in functions for the standard library
-InterpretResult builtin_input(ASTNode *node, Environment *env);
-InterpretResult builtin_random(ASTNode *node, Environment *env);
-InterpretResult builtin_output(ASTNode *node, Environment *env);
-InterpretResult builtin_error(ASTNode *node, Environment *env);
-InterpretResult builtin_cast(ASTNode *node, Environment *env);
-InterpretResult builtin_time(void);
-InterpretResult builtin_file_read(ASTNode *node, Environment *env);
-InterpretResult builtin_file_write(ASTNode *node, Environment *env);
-InterpretResult builtin_file_append(ASTNode *node, Environment *env);
-InterpretResult builtin_length(ASTNode *node, Environment *env);
-InterpretResult builtin_sleep(ASTNode *node, Environment *env);
-InterpretResult builtin_cimport(ASTNode *node, Environment *env);
-InterpretResult builtin_floor(ASTNode *node, Environment *env);
-InterpretResult builtin_ceil(ASTNode *node, Environment *env);
-InterpretResult builtin_round(ASTNode *node, Environment *env);
-InterpretResult builtin_abs(ASTNode *node, Environment *env);
+InterpretResult builtin_input(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_random(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_output(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_error(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_cast(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_time(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_file_read(ASTNode *node, Environment *env,
+                                  LiteralValue *args);
+InterpretResult builtin_file_write(ASTNode *node, Environment *env,
+                                   LiteralValue *args);
+InterpretResult builtin_file_append(ASTNode *node, Environment *env,
+                                    LiteralValue *args);
+InterpretResult builtin_length(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_sleep(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_cimport(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_floor(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_ceil(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_round(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_abs(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_builder(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_append(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_build(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_int_array(ASTNode *node, Environment *env,
+                                  LiteralValue *args);
+InterpretResult builtin_float_array(ASTNode *node, Environment *env,
+                                    LiteralValue *args);
+InterpretResult builtin_bool_array(ASTNode *node, Environment *env,
+                                   LiteralValue *args);
+InterpretResult builtin_sum(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_min(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_max(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_mean(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_dot(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_count_eq(ASTNode *node, Environment *env,
+                                 LiteralValue *args);
+InterpretResult builtin_index_of(ASTNode *node, Environment *env,
+                                 LiteralValue *args);
+InterpretResult builtin_scale(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_add(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_clamp(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_sort(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_sort_by(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_memoize(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_memo_stats(ASTNode *node, Environment *env,
+                                   LiteralValue *args);
+InterpretResult builtin_parallel_map(ASTNode *node, Environment *env,
+                                     LiteralValue *args);
+InterpretResult builtin_parallel_filter(ASTNode *node, Environment *env,
+                                        LiteralValue *args);
+InterpretResult builtin_parallel_reduce(ASTNode *node, Environment *env,
+                                        LiteralValue *args);
+InterpretResult builtin_has(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_get(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_remove(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_keys(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_values(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_heap(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_push(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_pop(ASTNode *node, Environment *env,
+                            LiteralValue *args);
+InterpretResult builtin_peek(ASTNode *node, Environment *env,
+                             LiteralValue *args);
+InterpretResult builtin_column(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_matrix(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_shape(ASTNode *node, Environment *env,
+                              LiteralValue *args);
+InterpretResult builtin_matmul(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_transpose(ASTNode *node, Environment *env,
+                                  LiteralValue *args);
+InterpretResult builtin_row_sum(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_row_mean(ASTNode *node, Environment *env,
+                                 LiteralValue *args);
+InterpretResult builtin_row_min(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_row_max(ASTNode *node, Environment *env,
+                                LiteralValue *args);
+InterpretResult builtin_bitset(ASTNode *node, Environment *env,
+                               LiteralValue *args);
+InterpretResult builtin_popcount(ASTNode *node, Environment *env,
+                                 LiteralValue *args);
+
+// Registry
+extern const BuiltinSpec builtin_specs[];
+extern const size_t builtin_spec_count;
+InterpretResult check_builtin_arguments(const BuiltinSpec *spec,
+                                        size_t num_args,
+                                        const LiteralValue *args);
+InterpretResult call_builtin(const BuiltinSpec *spec, ASTNode *node,
+                             Environment *env);
+bool is_callback_builtin(const char *name);
 
 // Helpers
+size_t helper_count_arguments(ASTNode *node);
 char *literal_value_to_string(LiteralValue lv);
 bool literal_type_matches_arg_type(LiteralType lit_type, ArgType arg_type);
 InterpretResult interpret_arguments(ASTNode *node, Environment *env,
                                     size_t num_args, ArgumentSpec *specs);
+InterpretResult interpret_arguments_into(ASTNode *node, Environment *env,
+                                         size_t num_args, ArgumentSpec *specs,
+                                         LiteralValue *held);
 void print_formatted_string(const char *str);
 bool is_valid_int(const char *str, INT_SIZE *out_value);
 bool is_valid_float(const char *str, FLOAT_SIZE *out_value);
 char *process_escape_sequences(const char *input);
-void print_literal_value(LiteralValue lv);
 
 #endif
@@ -0,0 +1,127 @@
+#include "call_stack.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/resource.h>
+
+// Configuration
+static size_t max_depth = CALL_STACK_DEFAULT_DEPTH;
+
+// The thread's current call nesting & the lowest stack address a call may
+// start at (0 if the thread's stack size isn't known)
+static _Thread_local size_t call_depth = 0;
+static _Thread_local uintptr_t stack_floor = 0;
+
+void call_stack_configure(size_t depth) {
+    max_depth = depth ? depth : CALL_STACK_DEFAULT_DEPTH;
+}
+
+// Bytes of stack each interpreter thread gets (rounded up to 64 KiB, as some
+// platforms want whole pages)
+size_t call_stack_size(void) {
+    size_t size = CALL_STACK_BASE_BYTES;
+    if (max_depth > (SIZE_MAX - size) / CALL_STACK_FRAME_BYTES) {
+        return SIZE_MAX & ~(size_t)0xFFFF;
+    }
+    size += max_depth * CALL_STACK_FRAME_BYTES;
+    return (size + 0xFFFF) & ~(size_t)0xFFFF;
+}
+
+// ==================================================
+// THREADS
+// ==================================================
+
+typedef struct {
+    void *(*function)(void *);
+    void *arg;
+} CallStackStart;
+
+static void *call_stack_thread(void *arg) {
+    CallStackStart *start = arg;
+    call_stack_attach();
+    return start->function(start->arg);
+}
+
+/**
+ * @brief Runs `function(arg)` on a new thread whose stack is big enough for
+ * the configured call depth, & waits for it to finish.
+ *
+ * @return bool False if no such thread could be started (nothing has run).
+ */
+bool call_stack_run(void *(*function)(void *), void *arg) {
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0) {
+        return false;
+    }
+
+    CallStackStart start = {.function = function, .arg = arg};
+    pthread_t thread;
+    bool started =
+        pthread_attr_setstacksize(&attr, call_stack_size()) == 0 &&
+        pthread_create(&thread, &attr, call_stack_thread, &start) == 0;
+    pthread_attr_destroy(&attr);
+
+    if (started) {
+        pthread_join(thread, NULL);
+    }
+    return started;
+}
+
+// Records where the current thread's stack ends, given its size
+static void call_stack_attach_size(size_t size) {
+    uintptr_t top = (uintptr_t)__builtin_frame_address(0);
+    size_t reserve = CALL_STACK_RESERVE_BYTES;
+    if (reserve > size / 2) {
+        reserve = size / 2;
+    }
+    call_depth = 0;
+    stack_floor = top - size + reserve;
+}
+
+// Records where the current thread's stack ends. Must be called near the
+// top of a thread started with a `call_stack_size()` stack.
+void call_stack_attach(void) { call_stack_attach_size(call_stack_size()); }
+
+// Records where the main thread's stack ends, for when the script has to run
+// on it: its size is the stack limit (`CALL_STACK_BASE_BYTES` if there's
+// none)
+void call_stack_attach_main(void) {
+    size_t size = CALL_STACK_BASE_BYTES;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 &&
+        limit.rlim_cur != RLIM_INFINITY) {
+        size = (size_t)limit.rlim_cur;
+    }
+    call_stack_attach_size(size);
+}
+
+// ==================================================
+// CALLS
+// ==================================================
+
+// Starts a call, unless it would go past the depth limit or the end of the
+// stack; each successful call must be matched by `call_stack_leave()`
+bool call_stack_enter(void) {
+    if (call_depth >= max_depth) {
+        return false;
+    }
+    if (stack_floor && (uintptr_t)__builtin_frame_address(0) < stack_floor) {
+        return false;
+    }
+    call_depth++;
+    return true;
+}
+
+void call_stack_leave(void) { call_depth--; }
+
+// The error for a call that `call_stack_enter()` refused
+InterpretResult call_stack_overflow(void) {
+    if (call_depth >= max_depth) {
+        return raise_error("Stack overflow: more than %zu nested calls (see "
+                           "`--max-depth`).\n",
+                           max_depth);
+    }
+    return raise_error("Stack overflow: out of stack space after %zu nested "
+                       "calls.\n",
+                       call_depth);
+}
@@ -0,0 +1,44 @@
+#ifndef CALL_STACK_H
+#define CALL_STACK_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Deepest nesting of FlavorLang function calls allowed by default
+#define CALL_STACK_DEFAULT_DEPTH 100000
+
+// C stack reserved per nested call (a call passes through several
+// `interpret()` frames), plus a fixed amount for everything else. Sanitizers
+// pad every frame, so they need much more.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define CALL_STACK_FRAME_BYTES (16 * 1024)
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define CALL_STACK_FRAME_BYTES (16 * 1024)
+#endif
+#endif
+#ifndef CALL_STACK_FRAME_BYTES
+#define CALL_STACK_FRAME_BYTES 4096
+#endif
+#define CALL_STACK_BASE_BYTES (8 * 1024 * 1024)
+
+// Stack left unused below the overflow check, for whatever runs between
+// calls (built-ins, reporting the error, ...)
+#define CALL_STACK_RESERVE_BYTES (512 * 1024)
+
+// Configuration
+void call_stack_configure(size_t max_depth);
+size_t call_stack_size(void);
+
+// Threads
+bool call_stack_run(void *(*function)(void *), void *arg);
+void call_stack_attach(void);
+void call_stack_attach_main(void);
+
+// Calls
+bool call_stack_enter(void);
+void call_stack_leave(void);
+InterpretResult call_stack_overflow(void);
+
+#endif
@@ -0,0 +1,174 @@
+#include "flavor_string.h"
+#include "gc.h"
+#include <stdint.h>
+
+// Single characters (e.g. from `s[i]` in a loop) are common enough to share
+static FlavorString *fl_single_chars[256];
+
+// Parallel tasks may race to create the same entry; the loser's copy is
+// simply never used
+static FlavorString *fl_string_from_char(unsigned char c) {
+    FlavorString *cached =
+        __atomic_load_n(&fl_single_chars[c], __ATOMIC_ACQUIRE);
+    if (!cached) {
+        FlavorString *str =
+            gc_alloc_permanent(GC_STRING, sizeof(FlavorString) + 2);
+        str->length = 1;
+        str->capacity = 1;
+        str->hash = 0;
+        str->frozen = true;
+        str->bytes[0] = (char)c;
+        str->bytes[1] = '\0';
+        if (!__atomic_compare_exchange_n(&fl_single_chars[c], &cached, str,
+                                         false, __ATOMIC_ACQ_REL,
+                                         __ATOMIC_ACQUIRE)) {
+            return cached;
+        }
+        cached = str;
+    }
+    return cached;
+}
+
+FlavorString *fl_string_from_bytes(const char *bytes, size_t length) {
+    if (length == 1) {
+        return fl_string_from_char((unsigned char)bytes[0]);
+    }
+
+    FlavorString *str = gc_alloc_string(length);
+    memcpy(str->bytes, bytes, length);
+    return str;
+}
+
+FlavorString *fl_string_new(const char *cstr) {
+    return fl_string_from_bytes(cstr, strlen(cstr));
+}
+
+FlavorString *fl_string_concat(const char *left, size_t left_length,
+                               const char *right, size_t right_length) {
+    FlavorString *str = gc_alloc_string(left_length + right_length);
+    memcpy(str->bytes, left, left_length);
+    memcpy(str->bytes + left_length, right, right_length);
+    return str;
+}
+
+// Smallest buffer handed out when a string starts growing
+#define FL_STRING_MIN_CAPACITY 32
+
+FlavorString *fl_string_with_capacity(size_t capacity) {
+    FlavorString *str = gc_alloc_string(capacity);
+    str->length = 0;
+    str->bytes[0] = '\0';
+    str->frozen = false;
+    return str;
+}
+
+/**
+ * @brief Appends bytes to a string, returning the string to use from now on.
+ *
+ * An unfrozen string with enough spare capacity is extended in place;
+ * otherwise the contents move to a new, unfrozen buffer with at least double
+ * the capacity, so repeated appends cost amortised O(1) per byte. Frozen
+ * strings are never modified.
+ */
+FlavorString *fl_string_append(FlavorString *str, const char *bytes,
+                               size_t length) {
+    size_t needed = str->length + length;
+    if (fl_string_is_frozen(str) || needed > str->capacity) {
+        size_t capacity = str->capacity * 2;
+        if (capacity < needed) {
+            capacity = needed;
+        }
+        if (capacity < FL_STRING_MIN_CAPACITY) {
+            capacity = FL_STRING_MIN_CAPACITY;
+        }
+
+        FlavorString *grown = fl_string_with_capacity(capacity);
+        memcpy(grown->bytes, str->bytes, str->length);
+        grown->length = str->length;
+        str = grown;
+    }
+
+    memcpy(str->bytes + str->length, bytes, length);
+    str->length = needed;
+    str->bytes[needed] = '\0';
+    str->hash = 0;
+    return str;
+}
+
+StringBuilder *fl_builder_new(void) {
+    StringBuilder *builder = gc_alloc(GC_BUILDER, sizeof(StringBuilder));
+    builder->buffer = fl_string_with_capacity(FL_STRING_MIN_CAPACITY);
+    return builder;
+}
+
+/**
+ * @brief Stops a string from being appended to in place, once it may be
+ * shared.
+ *
+ * Parallel tasks freeze strings they read from outer variables, so the flag
+ * is written atomically (a relaxed store is enough: it only ever goes from
+ * false to true, & strings being appended to are never shared).
+ */
+void fl_string_freeze(FlavorString *str) {
+    if (!__atomic_load_n(&str->frozen, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&str->frozen, true, __ATOMIC_RELAXED);
+    }
+}
+
+bool fl_string_is_frozen(const FlavorString *str) {
+    return __atomic_load_n(&str->frozen, __ATOMIC_RELAXED);
+}
+
+const char *fl_string_cstr(const FlavorString *str) { return str->bytes; }
+
+size_t fl_string_length(const FlavorString *str) { return str->length; }
+
+/**
+ * @brief Returns the string's FNV-1a hash, computing & caching it on first
+ * use.
+ *
+ * Tasks sharing a string may cache its hash at the same time; they all
+ * store the same value, so relaxed atomics are enough.
+ */
+size_t fl_string_hash(FlavorString *str) {
+    size_t cached = __atomic_load_n(&str->hash, __ATOMIC_RELAXED);
+    if (cached != 0) {
+        return cached;
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < str->length; i++) {
+        hash ^= (unsigned char)str->bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    // Zero is reserved for "not computed yet"
+    cached = hash ? (size_t)hash : 1;
+    __atomic_store_n(&str->hash, cached, __ATOMIC_RELAXED);
+    return cached;
+}
+
+bool fl_string_equals(FlavorString *a, FlavorString *b) {
+    if (a == b) {
+        return true;
+    }
+    if (!a || !b || a->length != b->length) {
+        return false;
+    }
+
+    // Once both hashes are cached, most mismatches never touch the bytes
+    if (fl_string_hash(a) != fl_string_hash(b)) {
+        return false;
+    }
+    return memcmp(a->bytes, b->bytes, a->length) == 0;
+}
+
+// Orders strings bytewise, with a prefix before any longer string
+int fl_string_compare(const FlavorString *a, const FlavorString *b) {
+    size_t shorter = a->length < b->length ? a->length : b->length;
+    int order = memcmp(a->bytes, b->bytes, shorter);
+    if (order != 0) {
+        return order;
+    }
+    return (a->length > b->length) - (a->length < b->length);
+}
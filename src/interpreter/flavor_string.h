@@ -0,0 +1,31 @@
+#ifndef FLAVOR_STRING_H
+#define FLAVOR_STRING_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Creation (strings live on the GC heap & are never modified afterwards)
+FlavorString *fl_string_new(const char *cstr);
+FlavorString *fl_string_from_bytes(const char *bytes, size_t length);
+FlavorString *fl_string_concat(const char *left, size_t left_length,
+                               const char *right, size_t right_length);
+
+// Building (appending reuses spare capacity of an unfrozen string)
+FlavorString *fl_string_with_capacity(size_t capacity);
+FlavorString *fl_string_append(FlavorString *str, const char *bytes,
+                               size_t length);
+StringBuilder *fl_builder_new(void);
+void fl_string_freeze(FlavorString *str);
+bool fl_string_is_frozen(const FlavorString *str);
+
+// Access (also the intended way for plugins to read string values)
+const char *fl_string_cstr(const FlavorString *str);
+size_t fl_string_length(const FlavorString *str);
+
+// Comparison
+size_t fl_string_hash(FlavorString *str);
+bool fl_string_equals(FlavorString *a, FlavorString *b);
+int fl_string_compare(const FlavorString *a, const FlavorString *b);
+
+#endif
@@ -0,0 +1,233 @@
+#include "free_names.h"
+#include "../parser/utils.h"
+#include "builtins.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    FreeNames *result;
+    Environment *env;    // Where called functions are looked up
+    const char **locals; // Names the function being scanned binds itself
+                         // start at `local_base`
+    size_t local_base;
+    size_t local_count;
+    size_t local_capacity;
+    Function **scanned; // Functions already scanned (or being scanned)
+    size_t scanned_count;
+    size_t scanned_capacity;
+} FreeNameScan;
+
+static void free_names_push(const char ***list, size_t *count,
+                            size_t *capacity, const char *name) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 8;
+        const char **grown =
+            realloc((void *)*list, new_capacity * sizeof(const char *));
+        if (!grown) {
+            fatal_error("Memory allocation failed while scanning a function's "
+                        "free names.\n");
+        }
+        *list = grown;
+        *capacity = new_capacity;
+    }
+    (*list)[(*count)++] = name;
+}
+
+static bool free_names_find(const char *const *list, size_t count,
+                            const char *name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(list[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool scan_is_local(const FreeNameScan *scan, const char *name) {
+    return free_names_find(scan->locals + scan->local_base,
+                           scan->local_count - scan->local_base, name);
+}
+
+// Records a name the function looks up without binding it itself
+static void scan_add_free(FreeNameScan *scan, const char *name) {
+    FreeNames *result = scan->result;
+    if (name && !scan_is_local(scan, name) &&
+        !free_names_find(result->names, result->count, name)) {
+        free_names_push(&result->names, &result->count, &result->capacity,
+                        name);
+    }
+}
+
+static void scan_add_local(FreeNameScan *scan, const char *name) {
+    if (name) {
+        free_names_push(&scan->locals, &scan->local_count,
+                        &scan->local_capacity, name);
+    }
+}
+
+// Collects the names a function's body declares
+static void scan_collect_locals(ASTNode **slot, void *context) {
+    FreeNameScan *scan = context;
+    ASTNode *node = *slot;
+    switch (node->type) {
+    case AST_VAR_DECLARATION:
+        scan_add_local(scan, node->var_declaration.variable_name);
+        break;
+    case AST_CONST_DECLARATION:
+        scan_add_local(scan, node->const_declaration.constant_name);
+        break;
+    case AST_FOR_LOOP:
+        scan_add_local(scan, node->for_loop.loop_variable);
+        break;
+    case AST_TRY:
+        for (ASTCatchNode *catch_node = node->try_block.catch_blocks;
+             catch_node; catch_node = catch_node->next) {
+            scan_add_local(scan, catch_node->error_variable);
+        }
+        break;
+    default:
+        break;
+    }
+    ast_for_each_child(node, scan_collect_locals, context);
+}
+
+static void scan_function(FreeNameScan *scan, Function *func);
+
+// A function called (or passed on) by name is scanned too, as it runs with
+// the scanned function's callers still in scope
+static void scan_callee(FreeNameScan *scan, const char *name) {
+    Function *callee = get_function(scan->env, name);
+    if (!callee || callee->record) {
+        return;
+    }
+    if (callee->is_builtin) {
+        // Built-ins that call back run functions nothing here names
+        if (!callee->builtin || is_callback_builtin(callee->name)) {
+            scan->result->unknown = true;
+        }
+        return;
+    }
+    scan_function(scan, callee);
+}
+
+static void scan_node(ASTNode **slot, void *context) {
+    FreeNameScan *scan = context;
+    ASTNode *node = *slot;
+    if (scan->result->unknown) {
+        return;
+    }
+
+    switch (node->type) {
+    case AST_VARIABLE_REFERENCE:
+        if (!scan_is_local(scan, node->variable_name)) {
+            scan_add_free(scan, node->variable_name);
+            scan_callee(scan, node->variable_name);
+        }
+        break;
+    case AST_FUNCTION_CALL: {
+        ASTNode *ref = node->function_call.function_ref;
+        if (ref->type != AST_VARIABLE_REFERENCE ||
+            scan_is_local(scan, ref->variable_name)) {
+            scan->result->unknown = true; // Any function could be called
+            return;
+        }
+        break;
+    }
+    case AST_FOR_LOOP:
+        for (ASTReduction *reduction = node->for_loop.reductions; reduction;
+             reduction = reduction->next) {
+            scan_add_free(scan, reduction->variable_name);
+        }
+        break;
+    case AST_IMPORT:
+        scan->result->unknown = true;
+        return;
+    default:
+        break;
+    }
+
+    ast_for_each_child(node, scan_node, context);
+}
+
+static void scan_function(FreeNameScan *scan, Function *func) {
+    for (size_t i = 0; i < scan->scanned_count; i++) {
+        if (scan->scanned[i] == func) {
+            return; // Recursion, or already scanned
+        }
+    }
+    if (scan->scanned_count == scan->scanned_capacity) {
+        size_t capacity =
+            scan->scanned_capacity ? scan->scanned_capacity * 2 : 8;
+        Function **scanned =
+            realloc(scan->scanned, capacity * sizeof(Function *));
+        if (!scanned) {
+            fatal_error("Memory allocation failed while scanning a function's "
+                        "free names.\n");
+        }
+        scan->scanned = scanned;
+        scan->scanned_capacity = capacity;
+    }
+    scan->scanned[scan->scanned_count++] = func;
+
+    // Each function binds its own names
+    size_t outer_base = scan->local_base;
+    size_t outer_count = scan->local_count;
+    scan->local_base = outer_count;
+    for (ASTFunctionParameter *param = func->parameters; param;
+         param = param->next) {
+        scan_add_local(scan, param->parameter_name);
+    }
+    for (ASTNode *stmt = func->body; stmt; stmt = stmt->next) {
+        ASTNode *slot = stmt;
+        scan_collect_locals(&slot, scan);
+    }
+
+    for (ASTNode *stmt = func->body; stmt && !scan->result->unknown;
+         stmt = stmt->next) {
+        ASTNode *slot = stmt;
+        scan_node(&slot, scan);
+    }
+    scan->local_base = outer_base;
+    scan->local_count = outer_count;
+}
+
+/**
+ * @brief Works out which names `func` may look up in its callers' scopes:
+ * the variables & functions it, or any function it calls, uses without
+ * binding them itself.
+ *
+ * Functions it calls are found from `env`, as the call would. A name bound
+ * anywhere in a function (a parameter, or declared in its body) counts as
+ * its own, & the names of nested functions' parameters count as free, so
+ * the result may hold more names than are really looked up, but never
+ * fewer. If it calls a function it gets from a variable, a built-in that
+ * calls back or imports a module, there's no telling, so it's `unknown`.
+ *
+ * @return FreeNames* The names (free with `free_names_free()`).
+ */
+FreeNames *free_names_scan(Function *func, Environment *env) {
+    FreeNames *result = calloc(1, sizeof(FreeNames));
+    if (!result) {
+        fatal_error("Memory allocation failed while scanning a function's "
+                    "free names.\n");
+    }
+    result->version = function_version();
+
+    FreeNameScan scan = {.result = result, .env = env};
+    scan_function(&scan, func);
+    free((void *)scan.locals);
+    free(scan.scanned);
+    return result;
+}
+
+void free_names_free(FreeNames *names) {
+    if (names) {
+        free((void *)names->names);
+        free(names);
+    }
+}
+
+bool free_names_contains(const FreeNames *names, const char *name) {
+    return free_names_find(names->names, names->count, name);
+}
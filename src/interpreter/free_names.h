@@ -0,0 +1,25 @@
+#ifndef FREE_NAMES_H
+#define FREE_NAMES_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// The names a function, or any function it calls, may look up in its
+// callers' scopes
+typedef struct FreeNames {
+    const char **names; // Point into the functions' ASTs
+    size_t count;
+    size_t capacity;
+    bool unknown;   // It may also run code that can't be known in advance
+    size_t version; // `function_version()` when it was worked out
+} FreeNames;
+
+// Scanning
+FreeNames *free_names_scan(Function *func, Environment *env);
+void free_names_free(FreeNames *names);
+
+// Queries
+bool free_names_contains(const FreeNames *names, const char *name);
+
+#endif
@@ -0,0 +1,462 @@
+#include "gc.h"
+#include "utils.h"
+#include <pthread.h>
+#include <time.h>
+
+// Every collectable block starts with this header. The payload follows at
+// `GC_HEADER_SIZE`, which keeps it aligned for any element type.
+typedef struct GCObject {
+    struct GCObject *next;
+    size_t size; // payload size in bytes
+    GCObjectKind kind;
+    bool marked;
+} GCObject;
+
+#define GC_ALIGNMENT 16
+#define GC_HEADER_SIZE                                                         \
+    ((sizeof(GCObject) + GC_ALIGNMENT - 1) & ~(size_t)(GC_ALIGNMENT - 1))
+
+#define GC_HEADER(payload) ((GCObject *)((char *)(payload)-GC_HEADER_SIZE))
+#define GC_PAYLOAD(object) ((void *)((char *)(object) + GC_HEADER_SIZE))
+
+// Heap
+static GCObject *gc_objects = NULL;
+static GCObject *gc_permanent_objects = NULL; // never swept
+static size_t gc_heap_bytes = 0;
+static size_t gc_initial_threshold = GC_DEFAULT_THRESHOLD;
+static size_t gc_threshold = GC_DEFAULT_THRESHOLD;
+static bool gc_stats_enabled = false;
+static GCStats gc_stats = {0};
+
+// While parallel tasks run, allocation is locked & collection is paused
+static bool gc_parallel = false;
+static pthread_mutex_t gc_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Live environments (global, module, call frames & rescue scopes). Each
+// thread tracks its own; worker threads' lists are empty whenever the
+// collector runs.
+static _Thread_local Environment **gc_environments = NULL;
+static _Thread_local size_t gc_environment_count = 0;
+static _Thread_local size_t gc_environment_capacity = 0;
+
+// Interpreter temporaries held in C locals across nested evaluation
+static _Thread_local LiteralValue **gc_roots = NULL;
+static _Thread_local size_t gc_root_count = 0;
+static _Thread_local size_t gc_root_capacity = 0;
+
+void gc_configure(size_t threshold_bytes, bool print_stats) {
+    gc_initial_threshold = threshold_bytes;
+    gc_threshold = threshold_bytes;
+    gc_stats_enabled = print_stats;
+}
+
+// ==================================================
+// ALLOCATION
+// ==================================================
+
+void *gc_alloc(GCObjectKind kind, size_t size) {
+    GCObject *object = malloc(GC_HEADER_SIZE + size);
+    if (!object) {
+        fatal_error("Memory allocation failed for a %zu byte heap object.\n",
+                    size);
+    }
+    object->kind = kind;
+    object->size = size;
+    object->marked = false;
+
+    if (gc_parallel) {
+        pthread_mutex_lock(&gc_lock);
+    }
+    object->next = gc_objects;
+    gc_objects = object;
+
+    gc_heap_bytes += GC_HEADER_SIZE + size;
+    gc_stats.objects_allocated++;
+    gc_stats.bytes_allocated += GC_HEADER_SIZE + size;
+    if (gc_heap_bytes > gc_stats.peak_heap_bytes) {
+        gc_stats.peak_heap_bytes = gc_heap_bytes;
+    }
+    if (gc_parallel) {
+        pthread_mutex_unlock(&gc_lock);
+    }
+
+    return GC_PAYLOAD(object);
+}
+
+FlavorString *gc_alloc_string(size_t length) {
+    FlavorString *str = gc_alloc(GC_STRING, sizeof(FlavorString) + length + 1);
+    str->length = length;
+    str->capacity = length;
+    str->hash = 0;
+    str->frozen = true;
+    str->bytes[length] = '\0';
+    return str;
+}
+
+/**
+ * @brief Allocates an object that is never collected (for values cached by
+ * the interpreter itself, like single-character strings).
+ */
+void *gc_alloc_permanent(GCObjectKind kind, size_t size) {
+    GCObject *object = malloc(GC_HEADER_SIZE + size);
+    if (!object) {
+        fatal_error("Memory allocation failed for a %zu byte heap object.\n",
+                    size);
+    }
+    object->kind = kind;
+    object->size = size;
+    object->marked = false;
+
+    if (gc_parallel) {
+        pthread_mutex_lock(&gc_lock);
+    }
+    object->next = gc_permanent_objects;
+    gc_permanent_objects = object;
+    if (gc_parallel) {
+        pthread_mutex_unlock(&gc_lock);
+    }
+    return GC_PAYLOAD(object);
+}
+
+// ==================================================
+// ROOTS
+// ==================================================
+
+void gc_register_environment(Environment *env) {
+    if (gc_environment_count == gc_environment_capacity) {
+        size_t new_capacity =
+            gc_environment_capacity ? gc_environment_capacity * 2 : 16;
+        Environment **grown =
+            realloc(gc_environments, new_capacity * sizeof(Environment *));
+        if (!grown) {
+            fatal_error("Memory allocation failed for GC environment roots.\n");
+        }
+        gc_environments = grown;
+        gc_environment_capacity = new_capacity;
+    }
+    gc_environments[gc_environment_count++] = env;
+}
+
+void gc_unregister_environment(Environment *env) {
+    // Scopes are almost always released in LIFO order, so search from the top
+    for (size_t i = gc_environment_count; i > 0; i--) {
+        if (gc_environments[i - 1] == env) {
+            memmove(&gc_environments[i - 1], &gc_environments[i],
+                    (gc_environment_count - i) * sizeof(Environment *));
+            gc_environment_count--;
+            return;
+        }
+    }
+}
+
+void gc_push_root(LiteralValue *slot) {
+    if (gc_root_count == gc_root_capacity) {
+        size_t new_capacity = gc_root_capacity ? gc_root_capacity * 2 : 64;
+        LiteralValue **grown =
+            realloc(gc_roots, new_capacity * sizeof(LiteralValue *));
+        if (!grown) {
+            fatal_error("Memory allocation failed for GC temporary roots.\n");
+        }
+        gc_roots = grown;
+        gc_root_capacity = new_capacity;
+    }
+    gc_roots[gc_root_count++] = slot;
+}
+
+void gc_pop_roots(size_t count) {
+    gc_root_count = count > gc_root_count ? 0 : gc_root_count - count;
+}
+
+size_t gc_root_depth(void) { return gc_root_count; }
+
+void gc_restore_roots(size_t depth) {
+    if (depth < gc_root_count) {
+        gc_root_count = depth;
+    }
+}
+
+// Frees the calling (worker) thread's root lists
+void gc_release_thread(void) {
+    free(gc_environments);
+    gc_environments = NULL;
+    gc_environment_count = gc_environment_capacity = 0;
+
+    free(gc_roots);
+    gc_roots = NULL;
+    gc_root_count = gc_root_capacity = 0;
+}
+
+// ==================================================
+// PARALLEL REGIONS
+// ==================================================
+
+// Only called by the main thread, while no tasks are running
+void gc_begin_parallel(void) { gc_parallel = true; }
+
+void gc_end_parallel(void) { gc_parallel = false; }
+
+// ==================================================
+// COLLECTION
+// ==================================================
+
+// Containers whose elements still have to be marked. Tracing them from this
+// stack rather than recursively keeps deep structures (long linked lists,
+// say) from overflowing the C stack.
+static LiteralValue *gc_mark_stack = NULL;
+static size_t gc_mark_count = 0;
+static size_t gc_mark_capacity = 0;
+
+static void gc_push_mark(const LiteralValue *value) {
+    if (gc_mark_count == gc_mark_capacity) {
+        size_t new_capacity = gc_mark_capacity ? gc_mark_capacity * 2 : 256;
+        LiteralValue *grown =
+            realloc(gc_mark_stack, new_capacity * sizeof(LiteralValue));
+        if (!grown) {
+            fatal_error("Memory allocation failed for the GC mark stack.\n");
+        }
+        gc_mark_stack = grown;
+        gc_mark_capacity = new_capacity;
+    }
+    gc_mark_stack[gc_mark_count++] = *value;
+}
+
+// Marks a value's own blocks, queueing it if it holds other values
+static void gc_mark_value(const LiteralValue *value) {
+    GCObject *object;
+    switch (value->type) {
+    case TYPE_STRING:
+    case TYPE_ERROR:
+        if (value->data.string) {
+            GC_HEADER(value->data.string)->marked = true;
+        }
+        break;
+    case TYPE_ARRAY: {
+        const ArrayValue *array = value->data.array;
+        object = GC_HEADER(array);
+        if (object->marked) {
+            break;
+        }
+        object->marked = true;
+        if (!array->buffer || GC_HEADER(array->buffer)->marked) {
+            break;
+        }
+        GC_HEADER(array->buffer)->marked = true;
+
+        // Typed buffers hold plain numbers & booleans, so there's nothing
+        // to trace
+        if (array->buffer->kind == ARRAY_BOXED) {
+            gc_push_mark(value);
+        }
+        break;
+    }
+    case TYPE_BUILDER:
+        GC_HEADER(value->data.builder)->marked = true;
+        if (value->data.builder->buffer) {
+            GC_HEADER(value->data.builder->buffer)->marked = true;
+        }
+        break;
+    case TYPE_MAP: {
+        MapValue *map = value->data.map;
+        object = GC_HEADER(map);
+        if (object->marked) {
+            break;
+        }
+        object->marked = true;
+        GC_HEADER(map->entries)->marked = true;
+        GC_HEADER(map->slots)->marked = true;
+        gc_push_mark(value);
+        break;
+    }
+    case TYPE_HEAP: {
+        HeapValue *heap = value->data.heap;
+        object = GC_HEADER(heap);
+        if (object->marked) {
+            break;
+        }
+        object->marked = true;
+        if (heap->entries) {
+            GC_HEADER(heap->entries)->marked = true;
+        }
+        if (heap->comparator) {
+            GC_HEADER(heap->comparator)->marked = true;
+        }
+        gc_push_mark(value);
+        break;
+    }
+    case TYPE_RECORD:
+        object = GC_HEADER(value->data.record);
+        if (!object->marked) {
+            object->marked = true;
+            gc_push_mark(value);
+        }
+        break;
+    case TYPE_MATRIX:
+        GC_HEADER(value->data.matrix)->marked = true;
+        break;
+    case TYPE_BITSET:
+        GC_HEADER(value->data.bitset)->marked = true;
+        break;
+    default:
+        break;
+    }
+}
+
+// Marks the values held by a queued container
+static void gc_trace_value(const LiteralValue *value) {
+    switch (value->type) {
+    case TYPE_ARRAY: {
+        // Aliases & slice views see different parts of a buffer, so every
+        // slot is traced (unused ones are zeroed)
+        const ArrayBuffer *buffer = value->data.array->buffer;
+        for (size_t i = 0; i < buffer->capacity; i++) {
+            gc_mark_value(&buffer->items[i]);
+        }
+        break;
+    }
+    case TYPE_MAP: {
+        // Removed entries are cleared, so they can be traced like the rest
+        const MapValue *map = value->data.map;
+        for (size_t i = 0; i < map->used; i++) {
+            gc_mark_value(&map->entries[i].key);
+            gc_mark_value(&map->entries[i].value);
+        }
+        break;
+    }
+    case TYPE_HEAP: {
+        const HeapValue *heap = value->data.heap;
+        for (size_t i = 0; i < heap->count; i++) {
+            gc_mark_value(&heap->entries[i].priority);
+            gc_mark_value(&heap->entries[i].value);
+        }
+        break;
+    }
+    case TYPE_RECORD: {
+        const RecordValue *record = value->data.record;
+        for (size_t i = 0; i < record->type->field_count; i++) {
+            gc_mark_value(&record->fields[i]);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void gc_mark_roots(void) {
+    for (size_t i = 0; i < gc_environment_count; i++) {
+        Environment *env = gc_environments[i];
+        for (size_t j = 0; j < env->variable_count; j++) {
+            gc_mark_value(&env->variables[j].value);
+        }
+    }
+
+    for (size_t i = 0; i < gc_root_count; i++) {
+        gc_mark_value(gc_roots[i]);
+    }
+
+    while (gc_mark_count > 0) {
+        LiteralValue container = gc_mark_stack[--gc_mark_count];
+        gc_trace_value(&container);
+    }
+}
+
+static void gc_sweep(void) {
+    GCObject **link = &gc_objects;
+    while (*link) {
+        GCObject *object = *link;
+        if (object->marked) {
+            object->marked = false;
+            link = &object->next;
+        } else {
+            *link = object->next;
+            gc_heap_bytes -= GC_HEADER_SIZE + object->size;
+            gc_stats.objects_freed++;
+            gc_stats.bytes_freed += GC_HEADER_SIZE + object->size;
+            free(object);
+        }
+    }
+}
+
+void gc_collect(void) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    gc_mark_roots();
+    gc_sweep();
+
+    // Grow the threshold with the surviving heap so collection cost stays
+    // proportional to allocation (a zero threshold collects at every
+    // safepoint, which is handy for stress testing)
+    if (gc_initial_threshold > 0) {
+        size_t next = gc_heap_bytes * GC_GROWTH_FACTOR;
+        gc_threshold = next > gc_initial_threshold ? next : gc_initial_threshold;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    gc_stats.collections++;
+    gc_stats.pause_ms += (double)(end.tv_sec - start.tv_sec) * 1e3 +
+                         (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+
+    debug_print_int("GC: collection #%zu, %zu bytes live\n",
+                    gc_stats.collections, gc_heap_bytes);
+}
+
+/**
+ * @brief Collects if the heap has outgrown the current threshold.
+ *
+ * Only called between statements, where every value the interpreter still
+ * needs is reachable from a registered environment or a pushed root. Does
+ * nothing while parallel tasks are running.
+ */
+void gc_safepoint(void) {
+    if (!gc_parallel && gc_heap_bytes >= gc_threshold) {
+        gc_collect();
+    }
+}
+
+GCStats gc_get_stats(void) { return gc_stats; }
+
+size_t gc_heap_size(void) { return gc_heap_bytes; }
+
+void gc_print_stats(FILE *out) {
+    fprintf(out, "GC stats:\n");
+    fprintf(out, "  collections:      %zu\n", gc_stats.collections);
+    fprintf(out, "  allocated:        %zu bytes (%zu objects)\n",
+            gc_stats.bytes_allocated, gc_stats.objects_allocated);
+    fprintf(out, "  freed:            %zu bytes (%zu objects)\n",
+            gc_stats.bytes_freed, gc_stats.objects_freed);
+    fprintf(out, "  peak heap:        %zu bytes\n", gc_stats.peak_heap_bytes);
+    fprintf(out, "  live at exit:     %zu bytes\n", gc_heap_bytes);
+    fprintf(out, "  threshold:        %zu bytes\n", gc_threshold);
+    fprintf(out, "  total pause:      %.3f ms\n", gc_stats.pause_ms);
+}
+
+// Print stats (if requested) & release every remaining heap object
+void gc_shutdown(void) {
+    if (gc_stats_enabled) {
+        gc_print_stats(stderr);
+    }
+
+    GCObject *object = gc_objects;
+    while (object) {
+        GCObject *next = object->next;
+        free(object);
+        object = next;
+    }
+    gc_objects = NULL;
+    gc_heap_bytes = 0;
+
+    object = gc_permanent_objects;
+    while (object) {
+        GCObject *next = object->next;
+        free(object);
+        object = next;
+    }
+    gc_permanent_objects = NULL;
+
+    free(gc_mark_stack);
+    gc_mark_stack = NULL;
+    gc_mark_count = gc_mark_capacity = 0;
+
+    gc_release_thread();
+}
@@ -0,0 +1,66 @@
+#ifndef GC_H
+#define GC_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Heap size (in bytes) that triggers the first collection
+#define GC_DEFAULT_THRESHOLD (1024 * 1024)
+
+// After a collection, the next threshold is the live heap times this factor
+#define GC_GROWTH_FACTOR 2
+
+typedef enum {
+    GC_STRING,
+    GC_ARRAY,
+    GC_ARRAY_BUFFER,
+    GC_BUILDER,
+    GC_MAP,
+    GC_HEAP,
+    GC_RECORD,
+    GC_MATRIX,
+    GC_BITSET
+} GCObjectKind;
+
+// Counters reported by `--gc-stats`
+typedef struct {
+    size_t collections;
+    size_t objects_allocated;
+    size_t bytes_allocated;
+    size_t objects_freed;
+    size_t bytes_freed;
+    size_t peak_heap_bytes;
+    double pause_ms;
+} GCStats;
+
+// Configuration
+void gc_configure(size_t threshold_bytes, bool print_stats);
+
+// Allocation (all runtime strings & array buffers go through these)
+void *gc_alloc(GCObjectKind kind, size_t size);
+FlavorString *gc_alloc_string(size_t length);
+void *gc_alloc_permanent(GCObjectKind kind, size_t size);
+
+// Roots
+void gc_register_environment(Environment *env);
+void gc_unregister_environment(Environment *env);
+void gc_push_root(LiteralValue *slot);
+void gc_pop_roots(size_t count);
+size_t gc_root_depth(void);
+void gc_restore_roots(size_t depth);
+void gc_release_thread(void);
+
+// Parallel regions
+void gc_begin_parallel(void);
+void gc_end_parallel(void);
+
+// Collection
+void gc_safepoint(void);
+void gc_collect(void);
+GCStats gc_get_stats(void);
+size_t gc_heap_size(void);
+void gc_print_stats(FILE *out);
+void gc_shutdown(void);
+
+#endif
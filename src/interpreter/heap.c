@@ -0,0 +1,244 @@
+#include "heap.h"
+#include "array_ops.h"
+#include "flavor_string.h"
+#include "gc.h"
+#include "interpreter.h"
+#include "parallel.h"
+#include "utils.h"
+
+HeapValue *heap_new(FlavorString *comparator) {
+    HeapValue *heap = gc_alloc(GC_HEAP, sizeof(HeapValue));
+    heap->count = 0;
+    heap->capacity = 0;
+    heap->entries = NULL;
+    heap->comparator = comparator;
+    heap->owner = parallel_task_owner();
+    return heap;
+}
+
+// Parallel tasks may read any heap, but only modify heaps they created
+bool heap_writable(const HeapValue *heap) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || heap->owner == owner;
+}
+
+// ==================================================
+// ORDERING
+// ==================================================
+
+// Resolves a heap's comparator once per operation (NULL if it has none)
+static InterpretResult heap_comparator(const HeapValue *heap, Environment *env,
+                                       Function *out, Function **comparator) {
+    LiteralValue none = create_default_value();
+    *comparator = NULL;
+    if (!heap->comparator) {
+        return make_result(none, false, false);
+    }
+
+    Function *func = get_function(env, heap->comparator->bytes);
+    if (!func || func->is_builtin) {
+        return raise_error("Heap comparator `%s` is not a user-defined "
+                           "function in this scope.\n",
+                           heap->comparator->bytes);
+    }
+    *out = *func;
+    *comparator = out;
+    return make_result(none, false, false);
+}
+
+/**
+ * @brief Decides whether priority `a` comes out of a heap before `b`.
+ *
+ * Without a comparator, numbers & strings come out in ascending order.
+ * Otherwise the comparator is called as `comparator(a, b)` & must return a
+ * boolean.
+ */
+static InterpretResult heap_before(Function *comparator, LiteralValue a,
+                                   LiteralValue b, Environment *env,
+                                   bool *before) {
+    if (comparator) {
+        LiteralValue pair[2] = {a, b};
+        InterpretResult r =
+            call_function_with_values(comparator, pair, 2, env);
+        if (r.is_error) {
+            return r;
+        }
+        if (r.value.type != TYPE_BOOLEAN) {
+            return raise_error("A heap's comparator must return a boolean.\n");
+        }
+        *before = r.value.data.boolean;
+        return r;
+    }
+
+    LiteralValue result = {.type = TYPE_BOOLEAN};
+    if (a.type == TYPE_INTEGER && b.type == TYPE_INTEGER) {
+        *before = a.data.integer < b.data.integer;
+    } else if (literal_is_number(a) && literal_is_number(b)) {
+        FLOAT_SIZE l = a.type == TYPE_INTEGER ? (FLOAT_SIZE)a.data.integer
+                                              : a.data.floating_point;
+        FLOAT_SIZE r = b.type == TYPE_INTEGER ? (FLOAT_SIZE)b.data.integer
+                                              : b.data.floating_point;
+        *before = l < r;
+    } else if (a.type == TYPE_STRING && b.type == TYPE_STRING) {
+        *before = fl_string_compare(a.data.string, b.data.string) < 0;
+    } else {
+        return raise_error("Heap priorities must be all numbers or all "
+                           "strings, unless the heap has a comparator.\n");
+    }
+    result.data.boolean = *before;
+    return make_result(result, false, false);
+}
+
+// ==================================================
+// SIFTING
+// ==================================================
+
+// Entries are swapped rather than moved through a hole, so every entry stays
+// in the heap (& reachable by the collector) while comparators run
+
+static void heap_swap(HeapValue *heap, size_t i, size_t j) {
+    HeapEntry entry = heap->entries[i];
+    heap->entries[i] = heap->entries[j];
+    heap->entries[j] = entry;
+}
+
+static InterpretResult heap_sift_up(HeapValue *heap, size_t index,
+                                    Function *comparator, Environment *env) {
+    InterpretResult r = make_result(create_default_value(), false, false);
+    while (index > 0) {
+        size_t parent = (index - 1) / HEAP_ARITY;
+        bool before;
+        r = heap_before(comparator, heap->entries[index].priority,
+                        heap->entries[parent].priority, env, &before);
+        if (r.is_error || !before) {
+            break;
+        }
+        heap_swap(heap, index, parent);
+        index = parent;
+    }
+    return r;
+}
+
+static InterpretResult heap_sift_down(HeapValue *heap, size_t index,
+                                      Function *comparator, Environment *env) {
+    InterpretResult r = make_result(create_default_value(), false, false);
+    for (;;) {
+        size_t first = index * HEAP_ARITY + 1;
+        if (first >= heap->count) {
+            break;
+        }
+
+        // Find the child that comes out first
+        size_t best = first;
+        size_t last = first + HEAP_ARITY;
+        for (size_t child = first + 1; child < last && child < heap->count;
+             child++) {
+            bool before;
+            r = heap_before(comparator, heap->entries[child].priority,
+                            heap->entries[best].priority, env, &before);
+            if (r.is_error) {
+                return r;
+            }
+            if (before) {
+                best = child;
+            }
+        }
+
+        bool before;
+        r = heap_before(comparator, heap->entries[best].priority,
+                        heap->entries[index].priority, env, &before);
+        if (r.is_error || !before) {
+            break;
+        }
+        heap_swap(heap, index, best);
+        index = best;
+    }
+    return r;
+}
+
+// ==================================================
+// MUTATION
+// ==================================================
+
+static void heap_reserve(HeapValue *heap, size_t needed) {
+    if (needed <= heap->capacity) {
+        return;
+    }
+    size_t capacity = heap->capacity ? heap->capacity * 2 : HEAP_MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+
+    HeapEntry *entries = gc_alloc(GC_HEAP, capacity * sizeof(HeapEntry));
+    if (heap->count > 0) {
+        memcpy(entries, heap->entries, heap->count * sizeof(HeapEntry));
+    }
+    memset(entries + heap->count, 0,
+           (capacity - heap->count) * sizeof(HeapEntry));
+    heap->entries = entries;
+    heap->capacity = capacity;
+}
+
+/**
+ * @brief Adds a value to a heap, in O(log n) comparisons.
+ *
+ * @param heap     The heap (which must be writable).
+ * @param priority What the value is ordered by.
+ * @param value    The value `heap_pop()` will return.
+ * @param env      The environment to call the comparator in.
+ * @return InterpretResult An error if the priority can't be compared. If
+ * the comparator throws, the entry is kept but the heap's order may be off.
+ */
+InterpretResult heap_push(HeapValue *heap, LiteralValue priority,
+                          LiteralValue value, Environment *env) {
+    Function storage, *comparator;
+    InterpretResult r = heap_comparator(heap, env, &storage, &comparator);
+    if (r.is_error) {
+        return r;
+    }
+
+    // Without a comparator, every priority must be ordered like the first
+    if (!comparator) {
+        bool number = literal_is_number(priority);
+        if ((!number && priority.type != TYPE_STRING) ||
+            (heap->count > 0 &&
+             number != literal_is_number(heap->entries[0].priority))) {
+            return raise_error("Heap priorities must be all numbers or all "
+                               "strings, unless the heap has a comparator.\n");
+        }
+    }
+
+    heap_reserve(heap, heap->count + 1);
+    heap->entries[heap->count].priority = priority;
+    heap->entries[heap->count].value = value;
+    heap->count++;
+    return heap_sift_up(heap, heap->count - 1, comparator, env);
+}
+
+/**
+ * @brief Removes the entry that comes out first from a non-empty heap.
+ *
+ * @param heap The heap (which must be writable).
+ * @param env  The environment to call the comparator in.
+ * @return InterpretResult The removed entry's value.
+ */
+InterpretResult heap_pop(HeapValue *heap, Environment *env) {
+    Function storage, *comparator;
+    InterpretResult r = heap_comparator(heap, env, &storage, &comparator);
+    if (r.is_error) {
+        return r;
+    }
+
+    LiteralValue top = heap->entries[0].value;
+    heap->count--;
+    heap->entries[0] = heap->entries[heap->count];
+    memset(&heap->entries[heap->count], 0, sizeof(HeapEntry));
+
+    gc_push_root(&top);
+    r = heap_sift_down(heap, 0, comparator, env);
+    gc_pop_roots(1);
+    if (r.is_error) {
+        return r;
+    }
+    return make_result(top, false, false);
+}
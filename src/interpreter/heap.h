@@ -0,0 +1,25 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Children per heap node. Four children make the heap half as deep as a
+// binary one, and siblings share a cache line or two.
+#define HEAP_ARITY 4
+
+// Entry slots allocated by the first push
+#define HEAP_MIN_CAPACITY 8
+
+// Creation (`comparator` names a user function, or is NULL for ascending
+// numbers or strings)
+HeapValue *heap_new(FlavorString *comparator);
+
+// Mutation
+bool heap_writable(const HeapValue *heap);
+InterpretResult heap_push(HeapValue *heap, LiteralValue priority,
+                          LiteralValue value, Environment *env);
+InterpretResult heap_pop(HeapValue *heap, Environment *env);
+
+#endif
@@ -0,0 +1,474 @@
+#include "hoist.h"
+#include "../parser/utils.h"
+#include "interpreter.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOIST_COUNT(names) (sizeof(names) / sizeof(*(names)))
+
+// Configuration (`--no-hoist` turns it off)
+static bool hoist_enabled = true;
+
+void hoist_configure(bool enabled) { hoist_enabled = enabled; }
+
+// The running loops' frames, innermost first
+static _Thread_local HoistFrame *current_frame = NULL;
+
+// Built-ins whose result only depends on their arguments, so calls to them
+// can be hoisted
+static const char *const pure_builtins[] = {
+    "string", "float",    "int",      "floor", "ceil", "round",
+    "abs",    "length",   "sum",      "min",   "max",  "mean",
+    "dot",    "count_eq", "index_of", "has",   "get",  "keys",
+    "values", "sort",     "popcount",
+};
+
+// Built-ins that don't change the values they're given
+static const char *const harmless_builtins[] = {
+    "serve", "sample",     "burn",       "random",       "get_time",
+    "sleep", "taste_file", "plate_file", "garnish_file",
+};
+
+// Built-ins that call user-defined functions or add new ones: a loop calling
+// them is left alone
+static const char *const unsafe_builtins[] = {
+    "sort_by", "parallel_map", "parallel_filter", "parallel_reduce",
+    "push",    "pop",          "cimport",         "memoize",
+};
+
+static bool hoist_name_in(const char *const *names, size_t count,
+                          const char *name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct {
+    ASTNode *loop;
+    Environment *env; // Where called functions are looked up
+    const char **written;
+    size_t written_count;
+    size_t written_capacity;
+    bool safe;     // Only calls built-ins & declares no functions
+    bool modifies; // Changes an array, map, ... in place somewhere
+    size_t count;  // Expressions wrapped so far
+} HoistAnalysis;
+
+static void hoist_add_written(HoistAnalysis *analysis, const char *name) {
+    if (!name) {
+        return;
+    }
+    if (analysis->written_count == analysis->written_capacity) {
+        size_t capacity =
+            analysis->written_capacity ? analysis->written_capacity * 2 : 16;
+        const char **written = realloc((void *)analysis->written,
+                                       capacity * sizeof(const char *));
+        if (!written) {
+            fatal_error("Memory allocation failed while optimizing a loop.\n");
+        }
+        analysis->written = written;
+        analysis->written_capacity = capacity;
+    }
+    analysis->written[analysis->written_count++] = name;
+}
+
+static bool hoist_is_written(const HoistAnalysis *analysis, const char *name) {
+    for (size_t i = 0; i < analysis->written_count; i++) {
+        if (strcmp(analysis->written[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The standard library built-in `call` resolves to, or NULL
+static Function *hoist_builtin_callee(const HoistAnalysis *analysis,
+                                      const ASTNode *call) {
+    ASTNode *ref = call->function_call.function_ref;
+    if (ref->type != AST_VARIABLE_REFERENCE ||
+        hoist_is_written(analysis, ref->variable_name)) {
+        return NULL;
+    }
+    Function *callee = get_function(analysis->env, ref->variable_name);
+    return callee && callee->builtin ? callee : NULL;
+}
+
+// Records a write to `target` (a variable, or an element or field of one)
+static void hoist_collect_write(HoistAnalysis *analysis, ASTNode *target) {
+    if (target->type == AST_VARIABLE_REFERENCE) {
+        hoist_add_written(analysis, target->variable_name);
+        return;
+    }
+
+    // Find the variable whose value is being changed in place
+    analysis->modifies = true;
+    ASTNode *root = target;
+    for (;;) {
+        if (root->type == AST_ARRAY_INDEX_ACCESS) {
+            root = root->array_index_access.array;
+        } else if (root->type == AST_ARRAY_SLICE_ACCESS) {
+            root = root->array_slice_access.array;
+        } else if (root->type == AST_FIELD_ACCESS) {
+            root = root->field_access.object;
+        } else if (root->type == AST_ARRAY_OPERATION) {
+            root = root->array_operation.array;
+        } else {
+            break;
+        }
+    }
+    if (root->type == AST_VARIABLE_REFERENCE) {
+        hoist_add_written(analysis, root->variable_name);
+    } else {
+        analysis->safe = false;
+    }
+}
+
+// Collects what a loop writes, & whether it can be optimized at all
+static void hoist_collect(ASTNode **slot, void *context) {
+    HoistAnalysis *analysis = context;
+    ASTNode *node = *slot;
+    if (!analysis->safe) {
+        return;
+    }
+
+    switch (node->type) {
+    case AST_ASSIGNMENT:
+        hoist_collect_write(analysis, node->assignment.lhs);
+        break;
+    case AST_ARRAY_OPERATION:
+        hoist_collect_write(analysis, node);
+        break;
+    case AST_VAR_DECLARATION:
+        hoist_add_written(analysis, node->var_declaration.variable_name);
+        break;
+    case AST_CONST_DECLARATION:
+        hoist_add_written(analysis, node->const_declaration.constant_name);
+        break;
+    case AST_FOR_LOOP:
+        hoist_add_written(analysis, node->for_loop.loop_variable);
+        for (ASTReduction *reduction = node->for_loop.reductions; reduction;
+             reduction = reduction->next) {
+            hoist_add_written(analysis, reduction->variable_name);
+        }
+        break;
+    case AST_TRY:
+        for (ASTCatchNode *catch_node = node->try_block.catch_blocks;
+             catch_node; catch_node = catch_node->next) {
+            hoist_add_written(analysis, catch_node->error_variable);
+        }
+        break;
+    case AST_FUNCTION_CALL: {
+        // User-defined functions could change anything
+        Function *callee = hoist_builtin_callee(analysis, node);
+        if (!callee || hoist_name_in(unsafe_builtins,
+                                     HOIST_COUNT(unsafe_builtins),
+                                     callee->name)) {
+            analysis->safe = false;
+            return;
+        }
+        if (!hoist_name_in(pure_builtins, HOIST_COUNT(pure_builtins),
+                           callee->name) &&
+            !hoist_name_in(harmless_builtins, HOIST_COUNT(harmless_builtins),
+                           callee->name)) {
+            analysis->modifies = true; // `append()`, `remove()`, ...
+        }
+        break;
+    }
+    case AST_FUNCTION_DECLARATION:
+    case AST_RECORD_DECLARATION:
+    case AST_IMPORT:
+    case AST_EXPORT:
+        analysis->safe = false;
+        return;
+    default:
+        break;
+    }
+
+    ast_for_each_child(node, hoist_collect, context);
+}
+
+typedef struct {
+    const HoistAnalysis *analysis;
+    bool invariant;
+} InvariantCheck;
+
+// Whether an expression gives the same value every time round the loop: it
+// may only read variables the loop doesn't write & call pure built-ins
+static void hoist_check_invariant(ASTNode **slot, void *context) {
+    InvariantCheck *check = context;
+    ASTNode *node = *slot;
+    if (!check->invariant) {
+        return;
+    }
+
+    switch (node->type) {
+    case AST_LITERAL:
+    case AST_UNARY_OP:
+    case AST_BINARY_OP:
+    case AST_TERNARY:
+    case AST_ARRAY_LITERAL:
+    case AST_MAP_LITERAL:
+    case AST_ARRAY_INDEX_ACCESS:
+    case AST_ARRAY_SLICE_ACCESS:
+    case AST_FIELD_ACCESS:
+    case AST_INVARIANT: // Hoisted out of an enclosing loop already
+        break;
+    case AST_VARIABLE_REFERENCE:
+        if (hoist_is_written(check->analysis, node->variable_name)) {
+            check->invariant = false;
+            return;
+        }
+        break;
+    case AST_FUNCTION_CALL: {
+        Function *callee = hoist_builtin_callee(check->analysis, node);
+        if (!callee || !hoist_name_in(pure_builtins,
+                                      HOIST_COUNT(pure_builtins),
+                                      callee->name)) {
+            check->invariant = false;
+            return;
+        }
+        break;
+    }
+    default:
+        check->invariant = false;
+        return;
+    }
+
+    ast_for_each_child(node, hoist_check_invariant, context);
+}
+
+// Wraps the largest invariant expressions in `AST_INVARIANT` nodes
+static void hoist_wrap(ASTNode **slot, void *context) {
+    HoistAnalysis *analysis = context;
+    ASTNode *node = *slot;
+
+    switch (node->type) {
+    case AST_LITERAL:
+    case AST_VARIABLE_REFERENCE:
+    case AST_INVARIANT:
+        return; // Nothing to save
+    case AST_FOR_LOOP:
+        if (node->for_loop.is_parallel) {
+            return; // Its body runs in parallel tasks
+        }
+        break;
+    case AST_ARRAY_LITERAL:
+    case AST_MAP_LITERAL:
+        break; // A new one is made every time, but its elements may be kept
+    default: {
+        if (analysis->count == HOIST_MAX_EXPRESSIONS) {
+            return;
+        }
+        InvariantCheck check = {.analysis = analysis, .invariant = true};
+        hoist_check_invariant(&node, &check);
+        if (!check.invariant) {
+            break;
+        }
+
+        ASTNode *wrapper = calloc(1, sizeof(ASTNode));
+        if (!wrapper) {
+            fatal_error("Memory allocation failed while optimizing a loop.\n");
+        }
+        wrapper->type = AST_INVARIANT;
+        wrapper->invariant.expression = node;
+        wrapper->invariant.loop = analysis->loop;
+        wrapper->invariant.slot = analysis->count++;
+        wrapper->invariant.guarded = analysis->modifies;
+        wrapper->next = node->next;
+        node->next = NULL;
+        *slot = wrapper;
+        return;
+    }
+    }
+
+    ast_for_each_child(node, hoist_wrap, context);
+}
+
+// Finds a loop's invariant expressions, returning how many were wrapped
+static size_t hoist_analyze(ASTNode *loop, Environment *env) {
+    HoistAnalysis analysis = {.loop = loop,
+                              .env = env,
+                              .written = NULL,
+                              .written_count = 0,
+                              .written_capacity = 0,
+                              .safe = true,
+                              .modifies = false,
+                              .count = 0};
+
+    // Only the condition & body run more than once per run of the loop
+    ASTNode **condition = NULL;
+    ASTNode **body;
+    if (loop->type == AST_WHILE_LOOP) {
+        condition = &loop->while_loop.condition;
+        body = &loop->while_loop.body;
+    } else {
+        hoist_add_written(&analysis, loop->for_loop.loop_variable);
+        body = &loop->for_loop.body;
+    }
+
+    if (condition && *condition) {
+        hoist_collect(condition, &analysis);
+    }
+    for (ASTNode *stmt = *body; stmt; stmt = stmt->next) {
+        hoist_collect(&stmt, &analysis);
+    }
+
+    if (analysis.safe) {
+        if (condition && *condition) {
+            hoist_wrap(condition, &analysis);
+        }
+        for (ASTNode **stmt = body; *stmt; stmt = &(*stmt)->next) {
+            hoist_wrap(stmt, &analysis);
+        }
+    }
+
+    free((void *)analysis.written);
+    return analysis.count;
+}
+
+/**
+ * @brief Starts a run of a loop, keeping the values of its invariant
+ * expressions in `frame` until `hoist_leave()`.
+ *
+ * The first time a loop runs, its condition & body are searched for
+ * expressions that read no variable the loop writes & only call pure
+ * built-ins (`while i < length(data)`, say), which are wrapped in
+ * `AST_INVARIANT` nodes. Loops that call user-defined functions, or declare
+ * or import anything, are left as they are. Each wrapped expression is then
+ * evaluated the first time it's reached in a run of the loop (so errors &
+ * evaluation order don't change) & its value reused for the rest of the run.
+ *
+ * @param loop  A `while` or sequential `for` loop.
+ * @param env   The loop's environment.
+ * @param frame Where the values are kept (on the caller's stack).
+ * @return bool Whether `frame` was started (& `hoist_leave()` is needed).
+ */
+bool hoist_enter(ASTNode *loop, Environment *env, HoistFrame *frame) {
+    // Parallel tasks share the AST, so they never change it
+    if (!hoist_enabled || parallel_in_task()) {
+        return false;
+    }
+
+    bool *analyzed = loop->type == AST_WHILE_LOOP
+                         ? &loop->while_loop.hoist_analyzed
+                         : &loop->for_loop.hoist_analyzed;
+    size_t *count = loop->type == AST_WHILE_LOOP
+                        ? &loop->while_loop.hoisted_count
+                        : &loop->for_loop.hoisted_count;
+    if (!*analyzed) {
+        *count = hoist_analyze(loop, env);
+        *analyzed = true;
+    }
+    if (*count == 0) {
+        return false;
+    }
+
+    frame->loop = loop;
+    frame->count = *count;
+    frame->root_depth = gc_root_depth();
+    for (size_t i = 0; i < frame->count; i++) {
+        frame->values[i] = create_default_value();
+        frame->states[i] = HOIST_PENDING;
+        gc_push_root(&frame->values[i]);
+    }
+    frame->outer = current_frame;
+    current_frame = frame;
+    return true;
+}
+
+void hoist_leave(HoistFrame *frame) {
+    current_frame = frame->outer;
+    gc_restore_roots(frame->root_depth);
+}
+
+// The running frame of `loop`, or NULL (in parallel tasks, for instance)
+HoistFrame *hoist_frame(const ASTNode *loop) {
+    if (parallel_in_task()) {
+        return NULL;
+    }
+    for (HoistFrame *frame = current_frame; frame; frame = frame->outer) {
+        if (frame->loop == loop) {
+            return frame;
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    Environment *env;
+    bool immutable;
+} ImmutableCheck;
+
+// Whether every variable an expression reads holds a number, boolean,
+// string or function, which nothing can change in place
+static void hoist_check_reads(ASTNode **slot, void *context) {
+    ImmutableCheck *check = context;
+    ASTNode *node = *slot;
+    if (!check->immutable) {
+        return;
+    }
+    if (node->type == AST_FUNCTION_CALL) {
+        // The callee isn't a variable read
+        for (ASTNode *arg = node->function_call.arguments; arg;
+             arg = arg->next) {
+            hoist_check_reads(&arg, context);
+        }
+        return;
+    }
+    if (node->type == AST_VARIABLE_REFERENCE) {
+        Variable *var = get_variable(check->env, node->variable_name);
+        if (var) {
+            switch (var->value.type) {
+            case TYPE_INTEGER:
+            case TYPE_FLOAT:
+            case TYPE_BOOLEAN:
+            case TYPE_STRING:
+            case TYPE_FUNCTION:
+                break;
+            default:
+                check->immutable = false;
+            }
+        }
+        return;
+    }
+    ast_for_each_child(node, hoist_check_reads, context);
+}
+
+/**
+ * @brief Keeps the value an invariant expression was just evaluated to for
+ * the rest of its loop's run, if it can't change meanwhile.
+ *
+ * Only numbers, booleans & strings (frozen, since they're shared from now
+ * on) are kept. If the loop changes arrays, maps or records in place, values
+ * worked out from any of them aren't kept either.
+ *
+ * @param frame The loop's frame.
+ * @param node  The `AST_INVARIANT` node.
+ * @param env   The current environment.
+ * @param value The expression's value.
+ */
+void hoist_store(HoistFrame *frame, ASTNode *node, Environment *env,
+                 LiteralValue value) {
+    size_t slot = node->invariant.slot;
+    bool keep = value.type == TYPE_INTEGER || value.type == TYPE_FLOAT ||
+                value.type == TYPE_BOOLEAN || value.type == TYPE_STRING;
+    if (keep && node->invariant.guarded) {
+        ImmutableCheck check = {.env = env, .immutable = true};
+        hoist_check_reads(&node->invariant.expression, &check);
+        keep = check.immutable;
+    }
+    if (!keep) {
+        frame->states[slot] = HOIST_EVALUATED;
+        return;
+    }
+
+    if (value.type == TYPE_STRING) {
+        fl_string_freeze(value.data.string);
+    }
+    frame->values[slot] = value;
+    frame->states[slot] = HOIST_CACHED;
+}
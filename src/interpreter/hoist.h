@@ -0,0 +1,42 @@
+#ifndef HOIST_H
+#define HOIST_H
+
+#include "../shared/ast_types.h"
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Most invariant expressions a single loop keeps the values of
+#define HOIST_MAX_EXPRESSIONS 16
+
+typedef enum {
+    HOIST_PENDING,  // Not evaluated yet in this run of the loop
+    HOIST_CACHED,   // `values[slot]` holds it
+    HOIST_EVALUATED // Its value can't be kept, so it's evaluated every time
+} HoistState;
+
+// The values of a loop's invariant expressions while it runs. Frames live on
+// the C stack of `interpret_while_loop()` & `interpret_for_loop()`, linked
+// innermost first.
+typedef struct HoistFrame {
+    ASTNode *loop;
+    size_t count;
+    LiteralValue values[HOIST_MAX_EXPRESSIONS]; // GC roots meanwhile
+    HoistState states[HOIST_MAX_EXPRESSIONS];
+    size_t root_depth;
+    struct HoistFrame *outer;
+} HoistFrame;
+
+// Configuration
+void hoist_configure(bool enabled);
+
+// Loops
+bool hoist_enter(ASTNode *loop, Environment *env, HoistFrame *frame);
+void hoist_leave(HoistFrame *frame);
+
+// Invariant expressions
+HoistFrame *hoist_frame(const ASTNode *loop);
+void hoist_store(HoistFrame *frame, ASTNode *node, Environment *env,
+                 LiteralValue value);
+
+#endif
@@ -0,0 +1,153 @@
+#include "inliner.h"
+#include "../parser/utils.h"
+#include "builtins.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Configuration (0 turns inlining off)
+static size_t max_size = INLINER_DEFAULT_SIZE;
+
+void inliner_configure(size_t size) { max_size = size; }
+
+// Position of the parameter called `name` (the first, if repeated), or
+// SIZE_MAX
+static size_t parameter_index(const Function *func, const char *name) {
+    size_t index = 0;
+    for (ASTFunctionParameter *param = func->parameters; param;
+         param = param->next, index++) {
+        if (strcmp(param->parameter_name, name) == 0) {
+            return index;
+        }
+    }
+    return SIZE_MAX;
+}
+
+typedef struct {
+    Function *func;
+    Environment *env; // Where called functions are looked up
+    size_t nodes;
+    bool inlinable;
+} InlineCheck;
+
+// Whether an expression can be evaluated at the call site instead of in the
+// function's own environment: it may only combine values & call built-ins
+static void inliner_check_node(ASTNode **slot, void *context) {
+    InlineCheck *check = context;
+    ASTNode *node = *slot;
+    if (!check->inlinable) {
+        return;
+    }
+    if (++check->nodes > max_size) {
+        check->inlinable = false;
+        return;
+    }
+
+    switch (node->type) {
+    case AST_LITERAL:
+    case AST_VARIABLE_REFERENCE:
+    case AST_UNARY_OP:
+    case AST_BINARY_OP:
+    case AST_TERNARY:
+    case AST_ARRAY_LITERAL:
+    case AST_MAP_LITERAL:
+    case AST_ARRAY_INDEX_ACCESS:
+    case AST_ARRAY_SLICE_ACCESS:
+    case AST_FIELD_ACCESS:
+        break;
+    case AST_FUNCTION_CALL: {
+        // User-defined functions would be called from the call site's
+        // environment, without the parameters in scope
+        ASTNode *ref = node->function_call.function_ref;
+        Function *callee = NULL;
+        if (ref->type == AST_VARIABLE_REFERENCE &&
+            parameter_index(check->func, ref->variable_name) == SIZE_MAX) {
+            callee = get_function(check->env, ref->variable_name);
+        }
+        if (!callee || !callee->builtin || is_callback_builtin(callee->name)) {
+            check->inlinable = false;
+            return;
+        }
+        break;
+    }
+    default:
+        check->inlinable = false;
+        return;
+    }
+
+    ast_for_each_child(node, inliner_check_node, context);
+}
+
+// Turns references to the function's parameters into argument slots
+static void inliner_bind_parameters(ASTNode **slot, void *context) {
+    const Function *func = context;
+    ASTNode *node = *slot;
+    if (node->type == AST_VARIABLE_REFERENCE) {
+        size_t index = parameter_index(func, node->variable_name);
+        if (index != SIZE_MAX) {
+            free(node->variable_name);
+            node->type = AST_INLINE_ARGUMENT;
+            node->inline_argument = index;
+        }
+        return;
+    }
+    ast_for_each_child(node, inliner_bind_parameters, context);
+}
+
+/**
+ * @brief Builds the expression a call can evaluate instead of calling `func`.
+ *
+ * Only functions whose whole body is `deliver <expression>;` are inlined, if
+ * the expression has at most `--inline-size` nodes & only calls built-ins
+ * (so inlined functions are never recursive). The result is a copy of the
+ * expression whose parameter references read the call's arguments
+ * (`AST_INLINE_ARGUMENT`), which are still evaluated once each, in order,
+ * before it. Other variables resolve exactly as they would in the function,
+ * since its environment's parent is the caller's.
+ *
+ * @param func      The function the call resolved to.
+ * @param call_node The call.
+ * @param env       The caller's environment.
+ * @return ASTNode* The expression (owned by the caller), or NULL if the call
+ * has to be made as usual.
+ */
+ASTNode *inliner_expand(Function *func, ASTNode *call_node, Environment *env) {
+    ASTNode *body = func->body;
+    if (max_size == 0 || func->is_builtin || func->record || !body ||
+        body->next || body->type != AST_FUNCTION_RETURN ||
+        !body->function_return.return_data) {
+        return NULL;
+    }
+
+    // Repeated parameter names & argument count mismatches are left to the
+    // usual call
+    size_t num_params = 0;
+    for (ASTFunctionParameter *param = func->parameters; param;
+         param = param->next, num_params++) {
+        if (num_params == INLINER_MAX_ARGUMENTS ||
+            parameter_index(func, param->parameter_name) != num_params) {
+            return NULL;
+        }
+    }
+    size_t num_args = 0;
+    for (ASTNode *arg = call_node->function_call.arguments; arg;
+         arg = arg->next) {
+        num_args++;
+    }
+    if (num_args != num_params) {
+        return NULL;
+    }
+
+    ASTNode *expression = body->function_return.return_data;
+    InlineCheck check = {
+        .func = func, .env = env, .nodes = 0, .inlinable = !expression->next};
+    inliner_check_node(&expression, &check);
+    if (!check.inlinable) {
+        return NULL;
+    }
+
+    ASTNode *inlined = copy_ast_node(expression);
+    inliner_bind_parameters(&inlined, func);
+    return inlined;
+}
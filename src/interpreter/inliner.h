@@ -0,0 +1,21 @@
+#ifndef INLINER_H
+#define INLINER_H
+
+#include "../shared/ast_types.h"
+#include "interpreter_types.h"
+#include <stddef.h>
+
+// Largest `deliver` expression (in AST nodes) inlined by default
+#define INLINER_DEFAULT_SIZE 24
+
+// Most parameters an inlined function may have (its arguments are kept in a
+// fixed array on the C stack)
+#define INLINER_MAX_ARGUMENTS 8
+
+// Configuration
+void inliner_configure(size_t max_size);
+
+// Inlining
+ASTNode *inliner_expand(Function *func, ASTNode *call_node, Environment *env);
+
+#endif
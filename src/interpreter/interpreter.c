@@ -9,200 +9,261 @@ LiteralValue create_default_value(void) {
     return value;
 }
 
-InterpretResult interpret_node(ASTNode *node, Environment *env) {
+// The function the current thread is running, so a `deliver f(...)` in it
+// can hand `f` over instead of calling it (see `execute_function_body()`).
+// NULL wherever a call can't be made in place (outside functions, inside
+// `try` blocks, ...).
+typedef struct {
+    Environment *frame; // The running function's environment
+    Environment *next;  // Where `f`'s arguments get bound
+    Function *function; // `f`, once a `deliver` has handed it over
+} TailCall;
+
+static _Thread_local TailCall *current_tail_call = NULL;
+
+// Arguments of the inlined call being evaluated, read by its
+// `AST_INLINE_ARGUMENT` nodes (see `interpret_inline_call()`)
+static _Thread_local LiteralValue *inline_arguments = NULL;
+
+/**
+ * @brief Evaluates a node, writing its value into `out`.
+ *
+ * `out` also receives the `deliver`ed value on `FLOW_RETURN` & the error value
+ * on `FLOW_ERROR`, so nothing bigger than a status is returned through every
+ * level of the tree.
+ *
+ * @param node The node to evaluate (may be NULL, giving the default value).
+ * @param env  The current environment.
+ * @param out  The caller's result slot.
+ * @return ControlFlow How the node finished.
+ */
+ControlFlow interpret(ASTNode *node, Environment *env, LiteralValue *out) {
     if (!node) {
-        return make_result(create_default_value(), false, false);
+        *out = create_default_value();
+        return FLOW_NORMAL;
     }
 
-    debug_print_int("`interpret_node()` called\n");
-
-    InterpretResult result = {0};
+    debug_print_int("`interpret()` called\n");
 
     switch (node->type) {
     case AST_LITERAL:
         debug_print_int("\tMatched: `AST_LITERAL`\n");
-        result = interpret_literal(node);
-        break;
+        return interpret_literal(node, out);
 
-    case AST_VAR_DECLARATION: {
+    case AST_VAR_DECLARATION:
         debug_print_int("\tMatched: `AST_VAR_DECLARATION`\n");
-        result = interpret_var_declaration(node, env);
-        break;
-    }
+        return result_to_flow(interpret_var_declaration(node, env), out);
 
-    case AST_CONST_DECLARATION: {
+    case AST_CONST_DECLARATION:
         debug_print_int("\tMatched: `AST_CONST_DECLARATION`\n");
-        result = interpret_const_declaration(node, env);
-        break;
-    }
+        return result_to_flow(interpret_const_declaration(node, env), out);
 
     case AST_ASSIGNMENT:
         debug_print_int("\tMatched: `AST_ASSIGNMENT`\n");
-        result = interpret_assignment(node, env);
-        break;
+        return interpret_assignment(node, env, out);
 
     case AST_VARIABLE_REFERENCE:
-        result = interpret_variable_reference(node, env);
-        break;
+        return interpret_variable_reference(node, env, out);
+
+    case AST_INLINE_ARGUMENT:
+        // Like a parameter, whoever receives the string may keep it
+        *out = inline_arguments[node->inline_argument];
+        if (out->type == TYPE_STRING) {
+            fl_string_freeze(out->data.string);
+        }
+        return FLOW_NORMAL;
+
+    case AST_INVARIANT:
+        return interpret_invariant(node, env, out);
 
     case AST_UNARY_OP:
         debug_print_int("\tMatched: `AST_UNARY_OP`\n");
-        result = interpret_unary_op(node, env);
-        break;
+        return interpret_unary_op(node, env, out);
 
     case AST_BINARY_OP:
         debug_print_int("\tMatched: `AST_BINARY_OP`\n");
-        result = interpret_binary_op(node, env);
-        break;
+        return interpret_binary_op(node, env, out);
 
-    case AST_CONDITIONAL: {
+    case AST_CONDITIONAL:
         debug_print_int("\tMatched: `AST_CONDITIONAL`\n");
-        result = interpret_conditional(node, env);
-        break;
-    }
+        return interpret_conditional(node, env, out);
 
-    case AST_FUNCTION_CALL: {
+    case AST_FUNCTION_CALL:
         debug_print_int("\tMatched: `AST_FUNCTION_CALL`\n");
-        result = interpret_function_call(node, env);
-        break;
-    }
+        return interpret_function_call(node, env, out);
 
-    case AST_FUNCTION_DECLARATION: {
+    case AST_FUNCTION_DECLARATION:
         debug_print_int("\tMatched: `AST_FUNCTION_DECLARATION`\n");
         interpret_function_declaration(node, env);
         // No direct return from a function declaration
-        result = make_result(create_default_value(), false, false);
-        break;
-    }
+        *out = create_default_value();
+        return FLOW_NORMAL;
 
     case AST_FUNCTION_RETURN: {
+        ASTNode *return_data = node->function_return.return_data;
+        if (current_tail_call && return_data &&
+            return_data->type == AST_FUNCTION_CALL) {
+            return interpret_tail_call(return_data, env, out);
+        }
+
         // Interpret the return expression
-        InterpretResult return_res =
-            interpret_node(node->function_return.return_data, env);
+        ControlFlow flow = interpret(return_data, env, out);
 
         // Log the return value for debugging
-        switch (return_res.value.type) {
+        switch (out->type) {
         case TYPE_INTEGER:
             debug_print_int("Function returning integer: " INT_FORMAT "\n",
-                            return_res.value.data.integer);
+                            out->data.integer);
             break;
         case TYPE_FLOAT:
             debug_print_int("Function returning float:" FLOAT_FORMAT "\n",
-                            return_res.value.data.floating_point);
+                            out->data.floating_point);
             break;
         case TYPE_STRING:
             debug_print_int("Function returning string: %s\n",
-                            return_res.value.data.string);
+                            out->data.string->bytes);
             break;
         // Handle other types as needed
         default:
-            debug_print_int("Function returning type: %d\n",
-                            return_res.value.type);
-        }
-
-        // Propagate errors if any
-        if (return_res.is_error) {
-            return return_res;
+            debug_print_int("Function returning type: %d\n", out->type);
         }
 
-        // Indicate that a return has occurred
-        return_res.did_return = true;
-        return return_res;
+        // Propagate errors if any; otherwise leave the function
+        return flow == FLOW_ERROR ? FLOW_ERROR : FLOW_RETURN;
     }
 
-    case AST_WHILE_LOOP: {
+    case AST_WHILE_LOOP:
         debug_print_int("\tMatched: `AST_WHILE_LOOP`\n");
-        result = interpret_while_loop(node, env);
-        break;
-    }
+        return interpret_while_loop(node, env, out);
 
-    case AST_FOR_LOOP: {
+    case AST_FOR_LOOP:
         debug_print_int("\tMatched: `AST_FOR_LOOP`\n");
-        InterpretResult loop_res = interpret_for_loop(node, env);
-        result = loop_res;
-        break;
-    }
+        return interpret_for_loop(node, env, out);
 
-    case AST_SWITCH: {
+    case AST_SWITCH:
         debug_print_int("\tMatched: `AST_SWITCH`\n");
-        result = interpret_switch(node, env);
-        break;
-    }
+        return interpret_switch(node, env, out);
 
     case AST_BREAK:
         debug_print_int("\tMatched: `AST_BREAK`\n");
-        result = make_result(create_default_value(), false, true);
-        break;
+        *out = create_default_value();
+        return FLOW_BREAK;
 
     case AST_TERNARY:
         debug_print_int("\tMatched: `AST_TERNARY`\n");
-        result = interpret_ternary(node, env);
-        break;
+        return interpret_ternary(node, env, out);
 
     case AST_TRY:
         debug_print_int("\tMatched: `AST_TRY`\n");
-        result = interpret_try(node, env);
-        break;
+        return interpret_try(node, env, out);
 
     case AST_CATCH:
         debug_print_int("\tMatched: `AST_CATCH`\n");
-        break;
+        *out = create_default_value();
+        return FLOW_NORMAL;
 
     case AST_FINALLY:
         debug_print_int("\tMatched: `AST_FINALLY`\n");
-        break;
+        *out = create_default_value();
+        return FLOW_NORMAL;
 
     case AST_ARRAY_LITERAL:
         debug_print_int("\tMatched: `AST_ARRAY_LITERAL`\n");
-        result = interpret_array_literal(node, env);
-        break;
+        return result_to_flow(interpret_array_literal(node, env), out);
 
     case AST_ARRAY_OPERATION:
         debug_print_int("\tMatched: `AST_ARRAY_OPERATION`\n");
-        result = interpret_array_operation(node, env);
-        break;
+        return result_to_flow(interpret_array_operation(node, env), out);
+
+    case AST_MAP_LITERAL:
+        debug_print_int("\tMatched: `AST_MAP_LITERAL`\n");
+        return result_to_flow(interpret_map_literal(node, env), out);
+
+    case AST_RECORD_DECLARATION:
+        debug_print_int("\tMatched: `AST_RECORD_DECLARATION`\n");
+        return result_to_flow(interpret_record_declaration(node, env), out);
+
+    case AST_FIELD_ACCESS:
+        debug_print_int("\tMatched: `AST_FIELD_ACCESS`\n");
+        return result_to_flow(interpret_field_access(node, env), out);
 
     case AST_ARRAY_INDEX_ACCESS:
         debug_print_int("\tMatched: `AST_ARRAY_INDEX_ACCESS`\n");
-        result = interpret_array_index_access(node, env);
-        break;
+        return result_to_flow(interpret_array_index_access(node, env), out);
 
     case AST_ARRAY_SLICE_ACCESS:
         debug_print_int("\tMatched: `AST_ARRAY_SLICE_ACCESS`\n");
-        result = interpret_array_slice_access(node, env);
-        break;
+        return result_to_flow(interpret_array_slice_access(node, env), out);
 
     case AST_IMPORT:
         debug_print_int("\tMatched: `AST_IMPORT`\n");
-        result = interpret_import(node, env);
-        break;
+        return result_to_flow(interpret_import(node, env), out);
 
     case AST_EXPORT:
         debug_print_int("\tMatched: `AST_EXPORT`\n");
-        result = interpret_export(node, env);
-        break;
+        return result_to_flow(interpret_export(node, env), out);
 
     default:
-        return raise_error("Unsupported `ASTNode` type.\n");
+        return result_to_flow(raise_error("Unsupported `ASTNode` type.\n"),
+                              out);
+    }
+}
+
+// `interpret()` for callers that want an `InterpretResult` (built-ins,
+// plugins & the less common node types)
+InterpretResult interpret_node(ASTNode *node, Environment *env) {
+    LiteralValue value;
+    ControlFlow flow = interpret(node, env, &value);
+    return flow_to_result(flow, value);
+}
+
+// Runs a list of statements, stopping at the first one that doesn't finish
+// normally. Falling off the end leaves the default value in `out`.
+ControlFlow interpret_block(ASTNode *stmt, Environment *env,
+                            LiteralValue *out) {
+    for (; stmt; stmt = stmt->next) {
+        gc_safepoint();
+        ControlFlow flow = interpret(stmt, env, out);
+        if (flow != FLOW_NORMAL) {
+            return flow;
+        }
     }
+    *out = create_default_value();
+    return FLOW_NORMAL;
+}
 
-    return result;
+// Runs one iteration of a loop's body. Errors have already been reported by
+// `raise_error()`, so a failing statement is skipped rather than ending the
+// loop; only a `break` or `deliver` stops the iteration early.
+ControlFlow interpret_loop_body(ASTNode *stmt, Environment *env,
+                                LiteralValue *out) {
+    for (; stmt; stmt = stmt->next) {
+        gc_safepoint();
+        ControlFlow flow = interpret(stmt, env, out);
+        if (flow == FLOW_RETURN || flow == FLOW_BREAK) {
+            return flow;
+        }
+    }
+    *out = create_default_value();
+    return FLOW_NORMAL;
 }
 
 void interpret_program(ASTNode *program, Environment *env) {
+    bindings_add_program(program);
     ASTNode *current = program;
     while (current) {
         debug_print_int("Executing top-level statement\n");
-        InterpretResult res = interpret_node(current, env);
-        if (res.is_error) {
-            fprintf(stderr, "Unhandled error: %s\n", res.value.data.string);
+        gc_safepoint();
+        LiteralValue value;
+        if (interpret(current, env, &value) == FLOW_ERROR) {
+            fprintf(stderr, "Unhandled error: %s\n", value.data.string->bytes);
             break; // (or handle as needed in future)
         }
         current = current->next;
     }
 }
 
-InterpretResult interpret_literal(ASTNode *node) {
+ControlFlow interpret_literal(ASTNode *node, LiteralValue *out) {
     LiteralValue value;
     debug_print_int("Interpreting literal value...\n");
     debug_print_int("Literal type: %d\n", node->literal.type);
@@ -210,8 +271,9 @@ InterpretResult interpret_literal(ASTNode *node) {
     switch (node->literal.type) {
     case LITERAL_STRING:
         value.type = TYPE_STRING;
-        value.data.string = strdup(node->literal.value.string);
-        debug_print_int("Created string literal: `%s`\n", value.data.string);
+        value.data.string = fl_string_new(node->literal.value.string);
+        debug_print_int("Created string literal: `%s`\n",
+                        value.data.string->bytes);
         break;
     case LITERAL_FLOAT:
         value.type = TYPE_FLOAT;
@@ -234,24 +296,35 @@ InterpretResult interpret_literal(ASTNode *node) {
     default:
         // Let `interpret_node` handle unsupported literals
         value.type = TYPE_ERROR;
-        value.data.string = strdup("Unsupported literal type.\n");
+        value.data.string = fl_string_new("Unsupported literal type.\n");
         break;
     }
 
-    return make_result(value, false, false);
+    *out = value;
+    return FLOW_NORMAL;
 }
 
-InterpretResult interpret_variable_reference(ASTNode *node, Environment *env) {
+ControlFlow interpret_variable_reference(ASTNode *node, Environment *env,
+                                         LiteralValue *out) {
     if (node->type != AST_VARIABLE_REFERENCE) {
-        return raise_error("Expected AST_VARIABLE_REFERENCE node.\n");
+        return result_to_flow(
+            raise_error("Expected AST_VARIABLE_REFERENCE node.\n"), out);
     }
 
     Variable *var = get_variable(env, node->variable_name);
     if (!var) {
-        return raise_error("Undefined variable `%s`.\n", node->variable_name);
+        return result_to_flow(
+            raise_error("Undefined variable `%s`.\n", node->variable_name),
+            out);
     }
 
-    return make_result(var->value, false, false);
+    // Whoever receives the string may keep it, so it can't grow in place now
+    if (var->value.type == TYPE_STRING) {
+        fl_string_freeze(var->value.data.string);
+    }
+
+    *out = var->value;
+    return FLOW_NORMAL;
 }
 
 InterpretResult interpret_var_declaration(ASTNode *node, Environment *env) {
@@ -312,15 +385,24 @@ InterpretResult interpret_const_declaration(ASTNode *node, Environment *env) {
     return make_result(init_val_res.value, false, false);
 }
 
-InterpretResult interpret_assignment(ASTNode *node, Environment *env) {
+ControlFlow interpret_assignment(ASTNode *node, Environment *env,
+                                 LiteralValue *out) {
     if (node->type != AST_ASSIGNMENT) {
-        return raise_error("Invalid node type for assignment.\n");
+        return result_to_flow(
+            raise_error("Invalid node type for assignment.\n"), out);
+    }
+
+    // `s = s + ...` on a string variable appends instead of copying
+    InterpretResult append_res;
+    if (interpret_string_append(node, env, &append_res)) {
+        return result_to_flow(append_res, out);
     }
 
     // Interpret the RHS expression
-    InterpretResult rhs_val_res = interpret_node(node->assignment.rhs, env);
-    if (rhs_val_res.is_error) {
-        return rhs_val_res; // propagate the error
+    LiteralValue rhs;
+    if (interpret(node->assignment.rhs, env, &rhs) == FLOW_ERROR) {
+        *out = rhs;
+        return FLOW_ERROR; // propagate the error
     }
 
     // Determine the LHS type
@@ -336,190 +418,347 @@ InterpretResult interpret_assignment(ASTNode *node, Environment *env) {
             Variable new_var;
             new_var.variable_name = strdup(var_name);
             if (!new_var.variable_name) {
-                return raise_error(
-                    "Memory allocation failed for variable name `%s`.\n",
-                    var_name);
+                return result_to_flow(
+                    raise_error(
+                        "Memory allocation failed for variable name `%s`.\n",
+                        var_name),
+                    out);
             }
-            new_var.value = rhs_val_res.value;
+            new_var.value = rhs;
             new_var.is_constant = false;
 
             InterpretResult add_res = add_variable(env, new_var);
             if (add_res.is_error) {
                 free(new_var.variable_name); // clean up on error
-                return add_res;
             }
 
-            return add_res;
+            return result_to_flow(add_res, out);
         }
 
         if (var->is_constant) {
-            return raise_error("Cannot reassign to constant `%s`.\n", var_name);
+            return result_to_flow(
+                raise_error("Cannot reassign to constant `%s`.\n", var_name),
+                out);
         }
-
-        // If assigning to a string, free the old string to prevent memory leaks
-        if (var->value.type == TYPE_STRING && var->value.data.string) {
-            free(var->value.data.string);
+        if (variable_is_read_only(env, var_name)) {
+            return result_to_flow(
+                raise_error("Cannot assign to `%s` in a parallel task; "
+                            "outer variables are read-only.\n",
+                            var_name),
+                out);
         }
 
-        var->value = rhs_val_res.value;
+        // The previous value (if unreachable) is reclaimed by the GC
+        var->value = rhs;
 
-        return rhs_val_res;
+        *out = rhs;
+        return FLOW_NORMAL;
     }
 
     case AST_ARRAY_INDEX_ACCESS: {
-        return interpret_array_index_assignment(lhs_node, env,
-                                                rhs_val_res.value);
+        if (lhs_node->array_index_access.column) {
+            return result_to_flow(
+                interpret_matrix_assignment(lhs_node, env, rhs), out);
+        }
+        return result_to_flow(
+            interpret_array_index_assignment(lhs_node, env, rhs), out);
     }
 
     case AST_ARRAY_SLICE_ACCESS: {
-        return interpret_array_slice_access(node, env);
+        return result_to_flow(interpret_array_slice_access(node, env), out);
     }
 
     case AST_ARRAY_OPERATION:
-        return interpret_array_operation(node, env);
+        return result_to_flow(
+            interpret_array_push_assignment(lhs_node, env, rhs), out);
+
+    case AST_FIELD_ACCESS:
+        return result_to_flow(interpret_field_assignment(lhs_node, env, rhs),
+                              out);
 
     default:
-        return raise_error("Invalid LHS in assignment.\n");
+        return result_to_flow(raise_error("Invalid LHS in assignment.\n"),
+                              out);
     }
 }
 
-InterpretResult handle_string_concatenation(InterpretResult left,
-                                            InterpretResult right) {
-    LiteralValue lv_result;
-    lv_result.type = TYPE_STRING;
-
-    LiteralValue left_val = left.value;
-    LiteralValue right_val = right.value;
-
-    // Convert numbers to strings
-    char num_str1[50] = {0};
-    char num_str2[50] = {0};
-
-    // If left operand is a float or an integer, convert it
-    if (left_val.type == TYPE_FLOAT) {
-        snprintf(num_str1, sizeof(num_str1), FLOAT_FORMAT,
-                 left_val.data.floating_point);
-    } else if (left_val.type == TYPE_INTEGER) {
-        snprintf(num_str1, sizeof(num_str1), INT_FORMAT, left_val.data.integer);
-    }
-
-    // If right operand is a float or an integer, convert it
-    if (right_val.type == TYPE_FLOAT) {
-        snprintf(num_str2, sizeof(num_str2), FLOAT_FORMAT,
-                 right_val.data.floating_point);
-    } else if (right_val.type == TYPE_INTEGER) {
-        snprintf(num_str2, sizeof(num_str2), INT_FORMAT,
-                 right_val.data.integer);
-    }
-
-    // Calculate the total size of the new string:
-    // For operands that are already strings, use them directly.
-    // For numbers, we now have num_str1 or num_str2.
-    size_t new_size =
-        strlen(num_str1) + strlen(num_str2) +
-        strlen(left_val.type == TYPE_STRING ? left_val.data.string : "") +
-        strlen(right_val.type == TYPE_STRING ? right_val.data.string : "") + 1;
-
-    char *new_string = malloc(new_size);
-    if (!new_string) {
-        return raise_error(
-            "Memory allocation failed for string concatenation.\n");
-    }
+/**
+ * @brief Returns the text an operand contributes to string concatenation.
+ *
+ * Strings are used as-is, numbers are formatted into `buffer` & anything else
+ * contributes nothing.
+ */
+const char *concatenation_text(LiteralValue value, char *buffer,
+                               size_t buffer_size, size_t *length) {
+    buffer[0] = '\0';
+    if (value.type == TYPE_STRING) {
+        *length = value.data.string->length;
+        return value.data.string->bytes;
+    } else if (value.type == TYPE_FLOAT) {
+        snprintf(buffer, buffer_size, FLOAT_FORMAT, value.data.floating_point);
+    } else if (value.type == TYPE_INTEGER) {
+        snprintf(buffer, buffer_size, INT_FORMAT, value.data.integer);
+    }
+    *length = strlen(buffer);
+    return buffer;
+}
 
-    // Start by copying the left part:
-    if (left_val.type == TYPE_STRING)
-        strcpy(new_string, left_val.data.string);
-    else
-        strcpy(new_string, num_str1);
+/**
+ * @brief Runs `s = s + a + b ...` on a string variable by appending to `s`'s
+ * buffer rather than copying the whole string for every `+`.
+ *
+ * The variable keeps an unfrozen buffer with spare capacity that is extended
+ * in place until something reads the variable (which freezes it), so building
+ * a string in a loop is linear instead of quadratic. Returns false, having
+ * evaluated nothing, if the assignment doesn't have this shape.
+ */
+bool interpret_string_append(ASTNode *node, Environment *env,
+                             InterpretResult *out) {
+    ASTNode *lhs = node->assignment.lhs;
+    if (lhs->type != AST_VARIABLE_REFERENCE) {
+        return false;
+    }
+
+    // Collect the right operands of the left-leaning `+` chain
+    ASTNode *operands[MAX_APPEND_OPERANDS];
+    size_t operand_count = 0;
+    ASTNode *current = node->assignment.rhs;
+    while (current->type == AST_BINARY_OP &&
+           strcmp(current->binary_op.operator, "+") == 0) {
+        if (operand_count == MAX_APPEND_OPERANDS) {
+            return false;
+        }
+        operands[operand_count++] = current->binary_op.right;
+        current = current->binary_op.left;
+    }
+    if (operand_count == 0 || current->type != AST_VARIABLE_REFERENCE ||
+        strcmp(current->variable_name, lhs->variable_name) != 0) {
+        return false;
+    }
+
+    Variable *var = get_variable(env, lhs->variable_name);
+    if (!var || var->is_constant || var->value.type != TYPE_STRING ||
+        variable_is_read_only(env, lhs->variable_name)) {
+        return false;
+    }
+
+    // Evaluate operands left to right, keeping the original string & the
+    // operand values reachable meanwhile
+    LiteralValue base = var->value;
+    size_t base_length = base.data.string->length;
+    LiteralValue values[MAX_APPEND_OPERANDS];
+    size_t root_depth = gc_root_depth();
+    gc_push_root(&base);
+    for (size_t i = 0; i < operand_count; i++) {
+        InterpretResult res =
+            interpret_node(operands[operand_count - 1 - i], env);
+        if (res.is_error) {
+            gc_restore_roots(root_depth);
+            *out = res;
+            return true;
+        }
+        values[i] = res.value;
+        gc_push_root(&values[i]);
+    }
+
+    // Look the variable up again, as evaluating operands may have moved it.
+    // They may also have appended to it (`s = s + f()`, where `f()` does
+    // `s = s + "X"`), maybe in place. That never changes the bytes `s` had,
+    // but its buffer is only reused if the variable still holds it,
+    // unchanged; otherwise the result starts from a copy.
+    var = get_variable(env, lhs->variable_name);
+    FlavorString *result = base.data.string;
+    if (var->value.type != TYPE_STRING ||
+        var->value.data.string != result || result->length != base_length) {
+        result = fl_string_from_bytes(result->bytes, base_length);
+    }
+    for (size_t i = 0; i < operand_count; i++) {
+        char number[50];
+        size_t length;
+        const char *text =
+            concatenation_text(values[i], number, sizeof(number), &length);
+        result = fl_string_append(result, text, length);
+    }
+    gc_restore_roots(root_depth);
+
+    var->value.type = TYPE_STRING;
+    var->value.data.string = result;
+
+    *out = make_result(var->value, false, false);
+    return true;
+}
 
-    // Then concatenate the right part:
-    if (right_val.type == TYPE_STRING)
-        strcat(new_string, right_val.data.string);
-    else
-        strcat(new_string, num_str2);
+InterpretResult handle_string_concatenation(LiteralValue left,
+                                            LiteralValue right) {
+    LiteralValue lv_result;
+    lv_result.type = TYPE_STRING;
 
-    lv_result.data.string = new_string;
+    // Numbers are converted to strings; operands that are already strings
+    // carry their length, so nothing needs measuring
+    char num_str1[50];
+    char num_str2[50];
+    size_t left_length, right_length;
+    const char *left_bytes =
+        concatenation_text(left, num_str1, sizeof(num_str1), &left_length);
+    const char *right_bytes =
+        concatenation_text(right, num_str2, sizeof(num_str2), &right_length);
+
+    lv_result.data.string =
+        fl_string_concat(left_bytes, left_length, right_bytes, right_length);
     return make_result(lv_result, false, false);
 }
 
 /**
  * @brief Concatenates two arrays and returns the resulting array.
  *
- * @param left_res The left-hand side array.
- * @param right_res The right-hand side array.
+ * @param left The left-hand side array.
+ * @param right The right-hand side array.
  * @return InterpretResult The result of the concatenation or an error.
  */
-InterpretResult handle_array_concatenation(InterpretResult left_res,
-                                           InterpretResult right_res) {
+InterpretResult handle_array_concatenation(LiteralValue left,
+                                           LiteralValue right) {
     // Ensure both operands are arrays
-    if (left_res.value.type != TYPE_ARRAY ||
-        right_res.value.type != TYPE_ARRAY) {
+    if (left.type != TYPE_ARRAY || right.type != TYPE_ARRAY) {
         return raise_error(
             "Array concatenation requires both operands to be arrays.\n");
     }
 
-    ArrayValue *left_array = &left_res.value.data.array;
-    ArrayValue *right_array = &right_res.value.data.array;
-
-    // Calculate the new size
-    size_t new_count = left_array->count + right_array->count;
-    size_t new_capacity = left_array->capacity + right_array->capacity;
+    LiteralValue result;
+    result.type = TYPE_ARRAY;
+    result.data.array =
+        array_box(array_concat(left.data.array, right.data.array));
 
-    // Allocate memory for the new array elements
-    LiteralValue *new_elements = malloc(new_capacity * sizeof(LiteralValue));
-    if (!new_elements) {
-        return raise_error(
-            "Memory allocation failed during array concatenation.\n");
-    }
+    return make_result(result, false, false);
+}
 
-    // Copy elements from the left array
-    for (size_t i = 0; i < left_array->count; i++) {
-        new_elements[i] = left_array->elements[i];
-    }
+bool is_bitwise_operator(const char *op) {
+    return strcmp(op, "&") == 0 || strcmp(op, "|") == 0 ||
+           strcmp(op, "^") == 0 || strcmp(op, "<<") == 0 ||
+           strcmp(op, ">>") == 0;
+}
 
-    // Copy elements from the right array
-    for (size_t i = 0; i < right_array->count; i++) {
-        new_elements[left_array->count + i] = right_array->elements[i];
+// Applies `&`, `|`, `^`, `<<` or `>>` to two integers' two's complement bits
+InterpretResult handle_bitwise_operator(const char *op, LiteralValue left,
+                                        LiteralValue right) {
+    if (left.type != TYPE_INTEGER || right.type != TYPE_INTEGER) {
+        return raise_error("Operator `%s` requires integer operands.\n", op);
+    }
+    uint64_t l = (uint64_t)left.data.integer;
+    INT_SIZE r = right.data.integer;
+
+    LiteralValue result = {.type = TYPE_INTEGER};
+    if (strcmp(op, "&") == 0) {
+        result.data.integer = (INT_SIZE)(l & (uint64_t)r);
+    } else if (strcmp(op, "|") == 0) {
+        result.data.integer = (INT_SIZE)(l | (uint64_t)r);
+    } else if (strcmp(op, "^") == 0) {
+        result.data.integer = (INT_SIZE)(l ^ (uint64_t)r);
+    } else {
+        if (r < 0 || r >= 64) {
+            return raise_error("Shift amount `" INT_FORMAT "` must be between "
+                               "0 and 63.\n",
+                               r);
+        }
+        if (strcmp(op, "<<") == 0) {
+            result.data.integer = (INT_SIZE)(l << r);
+        } else {
+            // Arithmetic shift: negative numbers stay negative
+            INT_SIZE value = left.data.integer;
+            result.data.integer = value < 0 ? ~(~value >> r) : value >> r;
+        }
     }
+    return make_result(result, false, false);
+}
 
-    // Create the new concatenated array
-    ArrayValue concatenated_array;
-    concatenated_array.count = new_count;
-    concatenated_array.capacity = new_capacity;
-    concatenated_array.elements = new_elements;
-
-    LiteralValue result;
-    result.type = TYPE_ARRAY;
-    result.data.array = concatenated_array;
+// Integer operands stay in `INT_SIZE`: a double only holds integers exactly up
+// to 2^53. Overflow wraps around, as it does for the bitwise operators.
+static InterpretResult handle_integer_operator(const char *op, INT_SIZE l,
+                                               INT_SIZE r) {
+    uint64_t ul = (uint64_t)l;
+    uint64_t ur = (uint64_t)r;
 
+    LiteralValue result = {.type = TYPE_INTEGER};
+    if (strcmp(op, "+") == 0) {
+        result.data.integer = (INT_SIZE)(ul + ur);
+    } else if (strcmp(op, "*") == 0) {
+        result.data.integer = (INT_SIZE)(ul * ur);
+    } else if (strcmp(op, "-") == 0) {
+        result.data.integer = (INT_SIZE)(ul - ur);
+    } else if (strcmp(op, "/") == 0) {
+        if (r == 0) {
+            return raise_error("Division by zero.\n");
+        }
+        result.type = TYPE_FLOAT;
+        result.data.floating_point = (FLOAT_SIZE)l / (FLOAT_SIZE)r;
+    } else if (strcmp(op, "//") == 0) { // floor Division
+        if (r == 0) {
+            return raise_error("Floor division by zero.\n");
+        }
+        if (r == -1) {
+            result.data.integer = (INT_SIZE)(0 - ul);
+        } else {
+            INT_SIZE quotient = l / r;
+            if (l % r != 0 && (l < 0) != (r < 0)) {
+                quotient--;
+            }
+            result.data.integer = quotient;
+        }
+    } else if (strcmp(op, "%") == 0) { // modulo
+        if (r == 0) {
+            return raise_error("Modulo by zero.\n");
+        }
+        result.data.integer = r == -1 ? 0 : l % r;
+    } else if (strcmp(op, "**") == 0) { // exponentiation
+        if (r < 0) {
+            // Only 1 and -1 have integer reciprocals; the rest truncate to 0
+            result.data.integer = (INT_SIZE)FLOAT_POW(l, r);
+        } else {
+            uint64_t power = 1;
+            for (uint64_t base = ul; ur > 0; ur >>= 1, base *= base) {
+                if (ur & 1) {
+                    power *= base;
+                }
+            }
+            result.data.integer = (INT_SIZE)power;
+        }
+    } else if (strcmp(op, "<") == 0) {
+        result.type = TYPE_BOOLEAN;
+        result.data.boolean = l < r;
+    } else if (strcmp(op, ">") == 0) {
+        result.type = TYPE_BOOLEAN;
+        result.data.boolean = l > r;
+    } else if (strcmp(op, "<=") == 0) {
+        result.type = TYPE_BOOLEAN;
+        result.data.boolean = l <= r;
+    } else if (strcmp(op, ">=") == 0) {
+        result.type = TYPE_BOOLEAN;
+        result.data.boolean = l >= r;
+    } else {
+        return raise_error("Unknown operator `%s`.\n", op);
+    }
     return make_result(result, false, false);
 }
 
 // Helper function to handle numeric operations and comparisons
-InterpretResult handle_numeric_operator(const char *op,
-                                        InterpretResult left_res,
-                                        InterpretResult right_res) {
-    // Check for errors in operands
-    if (left_res.is_error) {
-        return left_res;
-    }
-    if (right_res.is_error) {
-        return right_res;
-    }
-
-    LiteralValue left = left_res.value;
-    LiteralValue right = right_res.value;
-
+InterpretResult handle_numeric_operator(const char *op, LiteralValue left,
+                                        LiteralValue right) {
     // Ensure both operands are numeric
     if (!is_numeric_type(left.type) || !is_numeric_type(right.type)) {
         return raise_error("Operator `%s` requires numeric operands.\n", op);
     }
 
-    // Determine if the result should be a float
-    bool result_is_float =
-        (left.type == TYPE_FLOAT || right.type == TYPE_FLOAT);
+    // Bitwise operators skip the float conversion below
+    if (is_bitwise_operator(op)) {
+        return handle_bitwise_operator(op, left, right);
+    }
+
+    // So do operators on two integers
+    if (left.type == TYPE_INTEGER && right.type == TYPE_INTEGER) {
+        return handle_integer_operator(op, left.data.integer,
+                                       right.data.integer);
+    }
 
-    // Fetch numeric values with coercion
+    // Anything else mixes in a float, so the result is one too
     FLOAT_SIZE left_val = (left.type == TYPE_FLOAT)
                               ? left.data.floating_point
                               : (FLOAT_SIZE)left.data.integer;
@@ -529,70 +768,32 @@ InterpretResult handle_numeric_operator(const char *op,
 
     LiteralValue result;
     memset(&result, 0, sizeof(LiteralValue));
+    result.type = TYPE_FLOAT;
 
     // Handle operators
     if (strcmp(op, "+") == 0) {
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = left_val + right_val;
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer = (INT_SIZE)(left_val + right_val);
-        }
+        result.data.floating_point = left_val + right_val;
     } else if (strcmp(op, "*") == 0) {
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = left_val * right_val;
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer = (INT_SIZE)(left_val * right_val);
-        }
+        result.data.floating_point = left_val * right_val;
     } else if (strcmp(op, "-") == 0) {
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = left_val - right_val;
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer = (INT_SIZE)(left_val - right_val);
-        }
+        result.data.floating_point = left_val - right_val;
     } else if (strcmp(op, "/") == 0) {
         if (right_val == 0.0) {
             return raise_error("Division by zero.\n");
         }
-        result.type = TYPE_FLOAT;
         result.data.floating_point = left_val / right_val;
     } else if (strcmp(op, "//") == 0) { // floor Division
         if (right_val == 0.0) {
             return raise_error("Floor division by zero.\n");
         }
-        FLOAT_SIZE div_result = left_val / right_val;
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = floor(div_result);
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer = (INT_SIZE)floor(div_result);
-        }
+        result.data.floating_point = FLOAT_FLOOR(left_val / right_val);
     } else if (strcmp(op, "%") == 0) { // modulo
         if (right_val == 0.0) {
             return raise_error("Modulo by zero.\n");
         }
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = fmod(left_val, right_val);
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer =
-                (INT_SIZE)((INT_SIZE)left_val % (INT_SIZE)right_val);
-        }
+        result.data.floating_point = FLOAT_MOD(left_val, right_val);
     } else if (strcmp(op, "**") == 0) { // exponentiation
-        if (result_is_float) {
-            result.type = TYPE_FLOAT;
-            result.data.floating_point = pow(left_val, right_val);
-        } else {
-            result.type = TYPE_INTEGER;
-            result.data.integer = (INT_SIZE)pow(left_val, right_val);
-        }
+        result.data.floating_point = FLOAT_POW(left_val, right_val);
     } else if (strcmp(op, "<") == 0) {
         result.type = TYPE_BOOLEAN;
         result.data.boolean = (left_val < right_val);
@@ -613,29 +814,37 @@ InterpretResult handle_numeric_operator(const char *op,
 }
 
 // Function to evaluate binary operators
-InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
-                                  InterpretResult right_res) {
+InterpretResult evaluate_operator(const char *op, LiteralValue left,
+                                  LiteralValue right) {
     debug_print_int("Operator: `%s`\n", op);
 
+    // Bitsets combine word by word
+    if (left.type == TYPE_BITSET || right.type == TYPE_BITSET) {
+        return handle_bitset_operator(op, left, right);
+    }
+
+    // Matrices combine element by element
+    if (left.type == TYPE_MATRIX || right.type == TYPE_MATRIX) {
+        return handle_matrix_operator(op, left, right);
+    }
+
     // Handle array concatenation with "+" operator
     if (strcmp(op, "+") == 0) {
-        if (left_res.value.type == TYPE_ARRAY &&
-            right_res.value.type == TYPE_ARRAY) {
-            return handle_array_concatenation(left_res, right_res);
+        if (left.type == TYPE_ARRAY && right.type == TYPE_ARRAY) {
+            return handle_array_concatenation(left, right);
         }
     }
 
     // Handle string concatenation with "+" operator
-    if (strcmp(op, "+") == 0 && (left_res.value.type == TYPE_STRING ||
-                                 right_res.value.type == TYPE_STRING)) {
-        return handle_string_concatenation(left_res, right_res);
+    if (strcmp(op, "+") == 0 &&
+        (left.type == TYPE_STRING || right.type == TYPE_STRING)) {
+        return handle_string_concatenation(left, right);
     }
 
     // Handle logical AND and OR
     if (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0) {
         // Ensure both operands are boolean
-        if (!is_boolean_type(left_res.value.type) ||
-            !is_boolean_type(right_res.value.type)) {
+        if (!is_boolean_type(left.type) || !is_boolean_type(right.type)) {
             return raise_error(
                 "Logical operators `&&` and `||` require boolean operands.\n");
         }
@@ -644,11 +853,9 @@ InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
         result.type = TYPE_BOOLEAN;
 
         if (strcmp(op, "&&") == 0) {
-            result.data.boolean =
-                left_res.value.data.boolean && right_res.value.data.boolean;
+            result.data.boolean = left.data.boolean && right.data.boolean;
         } else { // op == "||"
-            result.data.boolean =
-                left_res.value.data.boolean || right_res.value.data.boolean;
+            result.data.boolean = left.data.boolean || right.data.boolean;
         }
 
         return make_result(result, false, false);
@@ -659,27 +866,24 @@ InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
         bool comparison_result = false;
 
         // If types are the same, perform direct comparison
-        if (left_res.value.type == right_res.value.type) {
-            switch (left_res.value.type) {
+        if (left.type == right.type) {
+            switch (left.type) {
             case TYPE_INTEGER:
-                comparison_result = (left_res.value.data.integer ==
-                                     right_res.value.data.integer);
+                comparison_result = (left.data.integer == right.data.integer);
                 break;
             case TYPE_FLOAT:
-                comparison_result = (left_res.value.data.floating_point ==
-                                     right_res.value.data.floating_point);
+                comparison_result = (left.data.floating_point ==
+                                     right.data.floating_point);
                 break;
             case TYPE_BOOLEAN:
-                comparison_result = (left_res.value.data.boolean ==
-                                     right_res.value.data.boolean);
+                comparison_result = (left.data.boolean == right.data.boolean);
                 break;
             case TYPE_STRING:
-                if (left_res.value.data.string == NULL ||
-                    right_res.value.data.string == NULL) {
+                if (left.data.string == NULL || right.data.string == NULL) {
                     return raise_error("Cannot compare NULL strings.\n");
                 }
-                comparison_result = (strcmp(left_res.value.data.string,
-                                            right_res.value.data.string) == 0);
+                comparison_result =
+                    fl_string_equals(left.data.string, right.data.string);
                 break;
             default:
                 return raise_error("Equality operators `==` and `!=` are not "
@@ -689,33 +893,28 @@ InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
         // Handle cross-type comparisons
         else {
             // For simplicity, handle numeric comparisons by coercing to float
-            if (is_numeric_type(left_res.value.type) &&
-                is_numeric_type(right_res.value.type)) {
-                return handle_numeric_operator(op, left_res, right_res);
+            if (is_numeric_type(left.type) && is_numeric_type(right.type)) {
+                return handle_numeric_operator(op, left, right);
             }
             // Handle boolean and integer comparisons
-            else if ((left_res.value.type == TYPE_BOOLEAN &&
-                      is_numeric_type(right_res.value.type)) ||
-                     (right_res.value.type == TYPE_BOOLEAN &&
-                      is_numeric_type(left_res.value.type))) {
+            else if ((left.type == TYPE_BOOLEAN &&
+                      is_numeric_type(right.type)) ||
+                     (right.type == TYPE_BOOLEAN &&
+                      is_numeric_type(left.type))) {
                 // Coerce boolean to integer (false=0, true=1)
-                LiteralValue coerced_left = left_res.value;
-                LiteralValue coerced_right = right_res.value;
+                LiteralValue coerced_left = left;
+                LiteralValue coerced_right = right;
 
-                if (left_res.value.type == TYPE_BOOLEAN) {
+                if (left.type == TYPE_BOOLEAN) {
                     coerced_left.type = TYPE_INTEGER;
-                    coerced_left.data.integer =
-                        left_res.value.data.boolean ? 1 : 0;
+                    coerced_left.data.integer = left.data.boolean ? 1 : 0;
                 }
-                if (right_res.value.type == TYPE_BOOLEAN) {
+                if (right.type == TYPE_BOOLEAN) {
                     coerced_right.type = TYPE_INTEGER;
-                    coerced_right.data.integer =
-                        right_res.value.data.boolean ? 1 : 0;
+                    coerced_right.data.integer = right.data.boolean ? 1 : 0;
                 }
 
-                return handle_numeric_operator(
-                    op, make_result(coerced_left, false, false),
-                    make_result(coerced_right, false, false));
+                return handle_numeric_operator(op, coerced_left, coerced_right);
             }
             // Handle string and other type comparisons if necessary
             else {
@@ -739,7 +938,8 @@ InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
     // Handle Arithmetic and Comparison Operators
     // List of operators that require numeric operands
     const char *numeric_operators[] = {
-        "+", "*", "-", "/", "//", "%", "**", "<", ">", "<=", ">=",
+        "+", "*", "-", "/", "//", "%", "**", "<",
+        ">", "<=", ">=", "&", "|", "^", "<<", ">>",
     };
     size_t num_numeric_ops =
         sizeof(numeric_operators) / sizeof(numeric_operators[0]);
@@ -753,84 +953,80 @@ InterpretResult evaluate_operator(const char *op, InterpretResult left_res,
     }
 
     if (is_numeric_op) {
-        return handle_numeric_operator(op, left_res, right_res);
+        return handle_numeric_operator(op, left, right);
     }
 
     if (strcmp(op, "+") == 0) {
-        return handle_string_concatenation(left_res, right_res);
+        return handle_string_concatenation(left, right);
     }
 
     // If operator is not recognized
     return raise_error("Unknown operator `%s`.\n", op);
 }
 
-InterpretResult interpret_binary_op(ASTNode *node, Environment *env) {
+ControlFlow interpret_binary_op(ASTNode *node, Environment *env,
+                                LiteralValue *out) {
     if (node->type != AST_BINARY_OP) {
-        return raise_error("Invalid node type for binary operation.\n");
+        return result_to_flow(
+            raise_error("Invalid node type for binary operation.\n"), out);
     }
 
     // Interpret left operand
-    InterpretResult left_res = interpret_node(node->binary_op.left, env);
-    if (left_res.is_error) {
-        return left_res;
+    LiteralValue left;
+    if (interpret(node->binary_op.left, env, &left) == FLOW_ERROR) {
+        *out = left;
+        return FLOW_ERROR;
     }
 
-    // Interpret right operand
-    InterpretResult right_res = interpret_node(node->binary_op.right, env);
-    if (right_res.is_error) {
-        return right_res;
+    // Interpret right operand (keeping the left one reachable meanwhile)
+    LiteralValue right;
+    gc_push_root(&left);
+    ControlFlow right_flow = interpret(node->binary_op.right, env, &right);
+    gc_pop_roots(1);
+    if (right_flow == FLOW_ERROR) {
+        *out = right;
+        return FLOW_ERROR;
     }
 
     // Evaluate the operator
-    const char *op = node->binary_op.operator;
-    InterpretResult op_res = evaluate_operator(op, left_res, right_res);
-    if (op_res.is_error) {
-        return op_res;
-    }
-
-    return make_result(op_res.value, false, false);
+    return result_to_flow(
+        evaluate_operator(node->binary_op.operator, left, right), out);
 }
 
 // Implementation of interpret_unary_op
-InterpretResult interpret_unary_op(ASTNode *node, Environment *env) {
+ControlFlow interpret_unary_op(ASTNode *node, Environment *env,
+                               LiteralValue *out) {
     if (node->type != AST_UNARY_OP) {
-        return raise_error("Invalid node type for unary operation.\n");
+        return result_to_flow(
+            raise_error("Invalid node type for unary operation.\n"), out);
     }
 
     // Interpret the operand
-    InterpretResult operand_res = interpret_node(node->unary_op.operand, env);
-    if (operand_res.is_error) {
-        return operand_res;
+    LiteralValue operand;
+    if (interpret(node->unary_op.operand, env, &operand) == FLOW_ERROR) {
+        *out = operand;
+        return FLOW_ERROR;
     }
 
     // Evaluate the unary operator
-    const char *op = node->unary_op.operator;
-    InterpretResult op_res = evaluate_unary_operator(op, operand_res);
-    if (op_res.is_error) {
-        return op_res;
-    }
-
-    return make_result(op_res.value, false, false);
+    return result_to_flow(
+        evaluate_unary_operator(node->unary_op.operator, operand), out);
 }
 
 // Helper function to handle unary operators
-InterpretResult evaluate_unary_operator(const char *op,
-                                        InterpretResult operand_res) {
+InterpretResult evaluate_unary_operator(const char *op, LiteralValue operand) {
     debug_print_int("Unary Operator: `%s`\n", op);
 
-    // Check for errors in operand
-    if (operand_res.is_error) {
-        return operand_res;
-    }
-
-    LiteralValue operand = operand_res.value;
     LiteralValue result;
 
     if (strcmp(op, "-") == 0) {
         // Arithmetic negation
         if (operand.type == TYPE_INTEGER) {
+            // Wraps around like the binary operators (the smallest integer
+            // is its own negation)
             result.type = TYPE_INTEGER;
-            result.data.integer = -operand.data.integer;
+            result.data.integer =
+                (INT_SIZE)(0 - (uint64_t)operand.data.integer);
         } else if (operand.type == TYPE_FLOAT) {
             result.type = TYPE_FLOAT;
             result.data.floating_point = -operand.data.floating_point;
@@ -851,6 +1047,18 @@ InterpretResult evaluate_unary_operator(const char *op,
             return raise_error(
                 "Unary `!` operator requires boolean or integer operand.\n");
         }
+    } else if (strcmp(op, "~") == 0) {
+        // Bitwise NOT
+        if (operand.type == TYPE_INTEGER) {
+            result.type = TYPE_INTEGER;
+            result.data.integer = ~operand.data.integer;
+        } else if (operand.type == TYPE_BITSET) {
+            result.type = TYPE_BITSET;
+            result.data.bitset = bitset_complement(operand.data.bitset);
+        } else {
+            return raise_error(
+                "Unary `~` operator requires an integer or bitset operand.\n");
+        }
     } else {
         return raise_error("Unsupported unary operator `%s`.\n", op);
     }
@@ -882,7 +1090,7 @@ Variable *get_variable(Environment *env, const char *variable_name) {
                 case TYPE_STRING:
                     debug_print_int(
                         "Variable found: `%s` with value `%s`\n", variable_name,
-                        current_env->variables[i].value.data.string);
+                        current_env->variables[i].value.data.string->bytes);
                     break;
                 case TYPE_FUNCTION:
                     debug_print_int(
@@ -894,7 +1102,7 @@ Variable *get_variable(Environment *env, const char *variable_name) {
                     debug_print_int(
                         "Variable found: `%s` with array of %zu elements.\n",
                         variable_name,
-                        current_env->variables[i].value.data.array.count);
+                        current_env->variables[i].value.data.array->count);
                     break;
                 default:
                     debug_print_int("Variable found: `%s` with unknown type.\n",
@@ -909,6 +1117,31 @@ Variable *get_variable(Environment *env, const char *variable_name) {
     return NULL;
 }
 
+/**
+ * @brief Whether a parallel task may only read a variable, because it lives
+ * in an environment shared with other threads.
+ */
+bool variable_is_read_only(Environment *env, const char *variable_name) {
+    Environment *shared_env = parallel_shared_environment();
+    if (!shared_env) {
+        return false;
+    }
+
+    for (Environment *current = env; current != shared_env;
+         current = current->parent) {
+        if (!current) {
+            return false;
+        }
+        for (size_t i = 0; i < current->variable_count; i++) {
+            if (strcmp(current->variables[i].variable_name, variable_name) ==
+                0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 InterpretResult add_variable(Environment *env, Variable var) {
     // Check if the variable already exists
     for (size_t i = 0; i < env->variable_count; i++) {
@@ -923,12 +1156,6 @@ InterpretResult add_variable(Environment *env, Variable var) {
 
             // If assigning a function, ensure to store the function name
             if (var.value.type == TYPE_FUNCTION) {
-                // Free previous string if necessary
-                if (env->variables[i].value.type == TYPE_STRING &&
-                    env->variables[i].value.data.string) {
-                    free(env->variables[i].value.data.string);
-                }
-
                 // Store function name
                 env->variables[i].value.type = TYPE_FUNCTION;
                 env->variables[i].value.data.function_name =
@@ -940,10 +1167,6 @@ InterpretResult add_variable(Environment *env, Variable var) {
                 }
             } else {
                 // Non-function types: directly assign
-                if (env->variables[i].value.type == TYPE_STRING &&
-                    env->variables[i].value.data.string) {
-                    free(env->variables[i].value.data.string);
-                }
                 env->variables[i].value = var.value;
             }
 
@@ -978,17 +1201,9 @@ InterpretResult add_variable(Environment *env, Variable var) {
                            var.variable_name);
     }
 
-    // Deep copy based on type
-    if (var.value.type == TYPE_STRING) {
-        env->variables[env->variable_count].value.type = TYPE_STRING;
-        env->variables[env->variable_count].value.data.string =
-            strdup(var.value.data.string);
-        if (!env->variables[env->variable_count].value.data.string) {
-            return raise_error(
-                "Memory allocation failed for string variable `%s`.\n",
-                var.variable_name);
-        }
-    } else if (var.value.type == TYPE_FUNCTION) {
+    // Deep copy function names; strings are immutable GC objects & can be
+    // shared as-is
+    if (var.value.type == TYPE_FUNCTION) {
         env->variables[env->variable_count].value.type = TYPE_FUNCTION;
         env->variables[env->variable_count].value.data.function_name =
             strdup(var.value.data.function_name);
@@ -1045,104 +1260,80 @@ InterpretResult allocate_variable(Environment *env, const char *name) {
     return make_result(var->value, false, false);
 }
 
-InterpretResult interpret_conditional(ASTNode *node, Environment *env) {
+ControlFlow interpret_conditional(ASTNode *node, Environment *env,
+                                  LiteralValue *out) {
     debug_print_int("`interpret_conditional()` called\n");
     if (!node) {
         // Error
-        return raise_error("Invalid conditional node.");
+        return result_to_flow(raise_error("Invalid conditional node."), out);
     }
 
-    bool condition_met = false;
-
     ASTNode *current_branch = node;
 
     while (current_branch) {
         if (current_branch->conditional.condition) {
-            InterpretResult cond_res =
-                interpret_node(current_branch->conditional.condition, env);
-
-            if (cond_res.is_error) {
+            if (interpret(current_branch->conditional.condition, env, out) ==
+                FLOW_ERROR) {
                 // Propagate the error
-                return cond_res;
+                return FLOW_ERROR;
             }
 
             // Check for valid condition types
-            if (cond_res.value.type != TYPE_INTEGER &&
-                cond_res.value.type != TYPE_BOOLEAN) {
-                return raise_error(
-                    "Condition expression must be boolean or integer.\n");
-            }
-
-            bool condition_true = false;
-            if (cond_res.value.type == TYPE_BOOLEAN) {
-                condition_true = cond_res.value.data.boolean;
-            } else if (cond_res.value.type == TYPE_INTEGER) {
-                condition_true = (cond_res.value.data.integer != 0);
+            if (out->type != TYPE_INTEGER && out->type != TYPE_BOOLEAN) {
+                return result_to_flow(
+                    raise_error(
+                        "Condition expression must be boolean or integer.\n"),
+                    out);
             }
 
-            if (condition_true) {
-                // Interpret the conditional body
-                ASTNode *cs = current_branch->conditional.body;
-                while (cs) {
-                    InterpretResult body_res = interpret_node(cs, env);
-
-                    if (body_res.is_error || body_res.did_return ||
-                        body_res.did_break) {
-                        return body_res;
-                    }
-                    cs = cs->next;
-                }
-                condition_met = true;
-
-                // Exit after the first true condition
-                break;
+            bool condition_true = out->type == TYPE_BOOLEAN
+                                      ? out->data.boolean
+                                      : out->data.integer != 0;
+            if (!condition_true) {
+                current_branch = current_branch->conditional.else_branch;
+                continue;
             }
-        } else {
-            // Else branch
-            if (!condition_met) {
-                ASTNode *cs = current_branch->conditional.body;
-                while (cs) {
-                    InterpretResult body_res = interpret_node(cs, env);
-
-                    if (body_res.is_error || body_res.did_return ||
-                        body_res.did_break) {
-                        return body_res;
-                    }
-                    cs = cs->next;
-                }
-            }
-
-            // Exit after else
-            break;
         }
 
-        current_branch = current_branch->conditional.else_branch;
+        // Interpret the first true branch (or the `else` branch), passing
+        // any `break`, `deliver` or error upwards
+        return interpret_block(current_branch->conditional.body, env, out);
     }
 
     debug_print_int("`interpret_conditional()` completed\n");
 
     // Return a default value if no conditions met
-    return make_result(create_default_value(), false, false);
+    *out = create_default_value();
+    return FLOW_NORMAL;
+}
+
+ControlFlow interpret_while_loop(ASTNode *node, Environment *env,
+                                 LiteralValue *out) {
+    HoistFrame frame;
+    bool hoisting = hoist_enter(node, env, &frame);
+    ControlFlow flow = interpret_while_iterations(node, env, out);
+    if (hoisting) {
+        hoist_leave(&frame);
+    }
+    return flow;
 }
 
-InterpretResult interpret_while_loop(ASTNode *node, Environment *env) {
+// Checks the condition & runs the body until the loop ends
+ControlFlow interpret_while_iterations(ASTNode *node, Environment *env,
+                                       LiteralValue *out) {
     ASTNode *condition = node->while_loop.condition;
     ASTNode *body = node->while_loop.body;
 
     while (1) {
-        // Check condition
-        InterpretResult cond_r = interpret_node(condition, env);
-        if (cond_r.did_return || cond_r.did_break) {
-            // Propagate break or return upwards
-            return cond_r;
-        }
+        // Check condition (a failed one isn't true, so it ends the loop)
+        interpret(condition, env, out);
 
         // Evaluate condition as boolean/integer
         bool condition_true = false;
-        if (cond_r.value.type == TYPE_BOOLEAN) {
-            condition_true = cond_r.value.data.boolean;
-        } else if (cond_r.value.type == TYPE_INTEGER) {
-            condition_true = (cond_r.value.data.integer != 0);
+        if (out->type == TYPE_BOOLEAN) {
+            condition_true = out->data.boolean;
+        } else if (out->type == TYPE_INTEGER) {
+            condition_true = (out->data.integer != 0);
         }
 
         // Exit if condition is false
@@ -1150,79 +1341,121 @@ InterpretResult interpret_while_loop(ASTNode *node, Environment *env) {
             break;
         }
 
-        // Interpret the loop body
-        ASTNode *current = body;
-        while (current) {
-            InterpretResult body_r = interpret_node(current, env);
-
-            // If there's a return or break, propagate it up
-            if (body_r.did_return || body_r.did_break) {
-                return body_r;
-            }
-
-            current = current->next;
+        // Interpret the loop body; a `break` ends the loop, while a
+        // `deliver` carries on upwards
+        ControlFlow flow = interpret_loop_body(body, env, out);
+        if (flow == FLOW_BREAK) {
+            break;
+        }
+        if (flow == FLOW_RETURN) {
+            return flow;
         }
     }
 
-    return make_result(create_default_value(), false, false);
+    *out = create_default_value();
+    return FLOW_NORMAL;
 }
 
-InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
+ControlFlow interpret_for_loop(ASTNode *node, Environment *env,
+                               LiteralValue *out) {
     if (node->type != AST_FOR_LOOP) {
-        return raise_error(
-            "`interpret_for_loop` called with non-`for`-loop ASTNode\n");
+        return result_to_flow(
+            raise_error(
+                "`interpret_for_loop` called with non-`for`-loop ASTNode\n"),
+            out);
+    }
+
+    if (node->for_loop.is_parallel) {
+        return result_to_flow(interpret_parallel_for_loop(node, env), out);
+    }
+
+    HoistFrame frame;
+    bool hoisting = hoist_enter(node, env, &frame);
+    ControlFlow flow = interpret_for_iterations(node, env, out);
+    if (hoisting) {
+        hoist_leave(&frame);
     }
+    return flow;
+}
 
+// Runs a sequential `for` loop
+ControlFlow interpret_for_iterations(ASTNode *node, Environment *env,
+                                     LiteralValue *out) {
     // If it's an iterable loop: "for item in collection { ... }"
     if (node->for_loop.is_iterable_loop) {
-        InterpretResult coll_res =
-            interpret_node(node->for_loop.collection_expr, env);
-        if (coll_res.is_error) {
-            return coll_res;
+        LiteralValue collection;
+        if (interpret(node->for_loop.collection_expr, env, &collection) ==
+            FLOW_ERROR) {
+            *out = collection;
+            return FLOW_ERROR;
         }
-        if (coll_res.value.type != TYPE_ARRAY) {
-            return raise_error("For loop iterable must be an array.\n");
+        // Maps are iterated over by key, in insertion order (from a snapshot,
+        // so the body may modify the map)
+        if (collection.type == TYPE_MAP) {
+            collection.type = TYPE_ARRAY;
+            collection.data.array = array_box(map_keys(collection.data.map));
         }
-        ArrayValue *array = &coll_res.value.data.array;
+        if (collection.type != TYPE_ARRAY) {
+            return result_to_flow(
+                raise_error("For loop iterable must be an array or a map.\n"),
+                out);
+        }
+
+        // Arrays are iterated over through their own box, so appending to
+        // the array in the body doesn't extend the loop
+        collection.data.array = array_box(*collection.data.array);
+        ArrayValue *array = collection.data.array;
 
         char *loop_var = strdup(node->for_loop.loop_variable);
         if (!loop_var) {
-            return raise_error("Memory allocation failed for loop variable\n");
+            return result_to_flow(
+                raise_error("Memory allocation failed for loop variable\n"),
+                out);
         }
         InterpretResult var_res = allocate_variable(env, loop_var);
         if (var_res.is_error) {
             free(loop_var);
-            return var_res;
+            return result_to_flow(var_res, out);
         }
+
+        // The collection may be a temporary (e.g. `for x in [1, 2, 3]`), so
+        // keep it reachable while the body runs
+        gc_push_root(&collection);
+
         // Iterate over each element in the array
+        ControlFlow flow = FLOW_NORMAL;
         for (size_t i = 0; i < array->count; i++) {
             Variable *var = get_variable(env, loop_var);
             if (!var) {
+                gc_pop_roots(1);
                 free(loop_var);
-                return raise_error(
-                    "Loop variable `%s` not found in environment\n", loop_var);
+                return result_to_flow(
+                    raise_error("Loop variable `%s` not found in environment\n",
+                                loop_var),
+                    out);
             }
-            var->value = array->elements[i];
+            var->value = array_get(array, i);
             // Execute loop body
-            ASTNode *current_stmt = node->for_loop.body;
-            while (current_stmt) {
-                InterpretResult body_res = interpret_node(current_stmt, env);
-                if (body_res.did_return || body_res.did_break) {
-                    free(loop_var);
-                    return body_res;
-                }
-                current_stmt = current_stmt->next;
+            flow = interpret_loop_body(node->for_loop.body, env, out);
+            if (flow != FLOW_NORMAL) {
+                break;
             }
         }
+        gc_pop_roots(1);
         free(loop_var);
-        return make_result(create_default_value(), false, false);
+        if (flow == FLOW_RETURN) {
+            return flow;
+        }
+        *out = create_default_value();
+        return FLOW_NORMAL;
     }
 
     // Otherwise, handle range-based loop: "for i in start_expr ..[=] end_expr
     // [by step] { ... }"
     char *loop_var = strdup(node->for_loop.loop_variable);
     if (!loop_var) {
-        return raise_error("Memory allocation failed for loop variable\n");
+        return result_to_flow(
+            raise_error("Memory allocation failed for loop variable\n"), out);
     }
     ASTNode *start_expr = node->for_loop.start_expr;
     ASTNode *end_expr = node->for_loop.end_expr;
@@ -1230,71 +1463,79 @@ InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
     ASTNode *step_expr = node->for_loop.step_expr; // may be NULL
     ASTNode *body = node->for_loop.body;
 
-    InterpretResult start_res = interpret_node(start_expr, env);
-    if (start_res.is_error) {
+    LiteralValue start_value, end_value;
+    if (interpret(start_expr, env, &start_value) == FLOW_ERROR) {
         free(loop_var);
-        return start_res;
+        *out = start_value;
+        return FLOW_ERROR;
     }
-    InterpretResult end_res = interpret_node(end_expr, env);
-    if (end_res.is_error) {
+    if (interpret(end_expr, env, &end_value) == FLOW_ERROR) {
         free(loop_var);
-        return end_res;
+        *out = end_value;
+        return FLOW_ERROR;
     }
 
     FLOAT_SIZE start_val, end_val;
-    if (start_res.value.type == TYPE_FLOAT) {
-        start_val = start_res.value.data.floating_point;
-    } else if (start_res.value.type == TYPE_INTEGER) {
-        start_val = (FLOAT_SIZE)start_res.value.data.integer;
+    if (start_value.type == TYPE_FLOAT) {
+        start_val = start_value.data.floating_point;
+    } else if (start_value.type == TYPE_INTEGER) {
+        start_val = (FLOAT_SIZE)start_value.data.integer;
     } else {
         free(loop_var);
-        return raise_error("Start expression in `for` loop must be numeric\n");
-    }
-    if (end_res.value.type == TYPE_FLOAT) {
-        end_val = end_res.value.data.floating_point;
-    } else if (end_res.value.type == TYPE_INTEGER) {
-        end_val = (FLOAT_SIZE)end_res.value.data.integer;
+        return result_to_flow(
+            raise_error("Start expression in `for` loop must be numeric\n"),
+            out);
+    }
+    if (end_value.type == TYPE_FLOAT) {
+        end_val = end_value.data.floating_point;
+    } else if (end_value.type == TYPE_INTEGER) {
+        end_val = (FLOAT_SIZE)end_value.data.integer;
     } else {
         free(loop_var);
-        return raise_error("End expression in `for` loop must be numeric\n");
+        return result_to_flow(
+            raise_error("End expression in `for` loop must be numeric\n"), out);
     }
 
     FLOAT_SIZE step = 1.0;
     if (step_expr) {
-        InterpretResult step_res = interpret_node(step_expr, env);
-        if (step_res.is_error) {
+        LiteralValue step_value;
+        if (interpret(step_expr, env, &step_value) == FLOW_ERROR) {
             free(loop_var);
-            return step_res;
+            *out = step_value;
+            return FLOW_ERROR;
         }
-        if (step_res.value.type == TYPE_FLOAT) {
-            step = step_res.value.data.floating_point;
-        } else if (step_res.value.type == TYPE_INTEGER) {
-            step = (FLOAT_SIZE)step_res.value.data.integer;
+        if (step_value.type == TYPE_FLOAT) {
+            step = step_value.data.floating_point;
+        } else if (step_value.type == TYPE_INTEGER) {
+            step = (FLOAT_SIZE)step_value.data.integer;
         } else {
             free(loop_var);
-            return raise_error(
-                "Step expression in `for` loop must be numeric\n");
+            return result_to_flow(
+                raise_error("Step expression in `for` loop must be numeric\n"),
+                out);
         }
     } else {
         step = (start_val < end_val) ? 1.0 : -1.0;
     }
     if (step < 1e-9 && step > -1e-9) {
         free(loop_var);
-        return raise_error("Step value cannot be zero in `for` loop\n");
+        return result_to_flow(
+            raise_error("Step value cannot be zero in `for` loop\n"), out);
     }
 
     InterpretResult var_res = allocate_variable(env, loop_var);
     if (var_res.is_error) {
         free(loop_var);
-        return var_res;
+        return result_to_flow(var_res, out);
     }
     Variable *var = get_variable(env, loop_var);
     if (!var) {
         free(loop_var);
-        return raise_error("Failed to retrieve loop variable `%s`.\n",
-                           loop_var);
+        return result_to_flow(
+            raise_error("Failed to retrieve loop variable `%s`.\n", loop_var),
+            out);
     }
-    if (start_res.value.type == TYPE_FLOAT) {
+    if (start_value.type == TYPE_FLOAT) {
         var->value.type = TYPE_FLOAT;
         var->value.data.floating_point = start_val;
     } else {
@@ -1306,8 +1547,10 @@ InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
         var = get_variable(env, loop_var);
         if (!var) {
             free(loop_var);
-            return raise_error("Loop variable `%s` not found in environment\n",
-                               loop_var);
+            return result_to_flow(
+                raise_error("Loop variable `%s` not found in environment\n",
+                            loop_var),
+                out);
         }
         FLOAT_SIZE current_val;
         if (var->value.type == TYPE_FLOAT) {
@@ -1316,8 +1559,9 @@ InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
             current_val = (FLOAT_SIZE)var->value.data.integer;
         } else {
             free(loop_var);
-            return raise_error("Loop variable `%s` must be numeric\n",
-                               loop_var);
+            return result_to_flow(
+                raise_error("Loop variable `%s` must be numeric\n", loop_var),
+                out);
         }
         bool condition_true = false;
         if (is_ascending) {
@@ -1330,20 +1574,21 @@ InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
         if (!condition_true) {
             break;
         }
-        ASTNode *current_stmt = body;
-        while (current_stmt) {
-            InterpretResult body_res = interpret_node(current_stmt, env);
-            if (body_res.did_return || body_res.did_break) {
-                free(loop_var);
-                return body_res;
-            }
-            current_stmt = current_stmt->next;
+        ControlFlow flow = interpret_loop_body(body, env, out);
+        if (flow == FLOW_BREAK) {
+            break;
+        }
+        if (flow == FLOW_RETURN) {
+            free(loop_var);
+            return flow;
         }
         var = get_variable(env, loop_var);
         if (!var) {
             free(loop_var);
-            return raise_error("Loop variable `%s` not found after loop body\n",
-                               loop_var);
+            return result_to_flow(
+                raise_error("Loop variable `%s` not found after loop body\n",
+                            loop_var),
+                out);
         }
         if (var->value.type == TYPE_FLOAT) {
             var->value.data.floating_point += step;
@@ -1352,133 +1597,440 @@ InterpretResult interpret_for_loop(ASTNode *node, Environment *env) {
         }
     }
     free(loop_var);
+    *out = create_default_value();
+    return FLOW_NORMAL;
+}
+
+/**
+ * @brief Evaluates a loop-invariant expression, once per run of its loop
+ * where possible (see `hoist_enter()`).
+ *
+ * @param node The `AST_INVARIANT` node.
+ * @param env  The current environment.
+ * @param out  The caller's result slot.
+ * @return ControlFlow How the expression finished.
+ */
+ControlFlow interpret_invariant(ASTNode *node, Environment *env,
+                                LiteralValue *out) {
+    HoistFrame *frame = hoist_frame(node->invariant.loop);
+    size_t slot = node->invariant.slot;
+    if (frame && frame->states[slot] == HOIST_CACHED) {
+        *out = frame->values[slot];
+        return FLOW_NORMAL;
+    }
+
+    // A failed evaluation is repeated next time, raising the error again
+    ControlFlow flow = interpret(node->invariant.expression, env, out);
+    if (frame && flow == FLOW_NORMAL &&
+        frame->states[slot] == HOIST_PENDING) {
+        hoist_store(frame, node, env, *out);
+    }
+    return flow;
+}
+
+// Shared state of a parallel `for` loop
+typedef struct {
+    ASTNode *node;
+    Environment *env;
+    INT_SIZE start;
+    INT_SIZE step;
+    size_t reduction_count;
+    LiteralValue *initial;  // each reduction's starting value per chunk,
+                            // GC roots meanwhile
+    LiteralValue *partials; // chunk * reduction_count + reduction
+
+    // The first failure stops the remaining chunks
+    pthread_mutex_t lock;
+    bool failed;
+    InterpretResult error;
+} ParallelLoop;
+
+static void parallel_loop_fail(ParallelLoop *loop, InterpretResult error) {
+    pthread_mutex_lock(&loop->lock);
+    if (!loop->failed) {
+        loop->error = error;
+        __atomic_store_n(&loop->failed, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&loop->lock);
+}
+
+// Runs one chunk of iterations with a private loop variable, locals &
+// reduction variables
+static void parallel_loop_task(void *context, size_t chunk, size_t begin,
+                               size_t end) {
+    ParallelLoop *loop = context;
+    Environment local_env;
+    init_environment_with_parent(&local_env, loop->env);
+
+    // The loop variable is always slot 0, followed by the reductions
+    Variable index_var = {.variable_name = loop->node->for_loop.loop_variable,
+                          .value = {.type = TYPE_INTEGER},
+                          .is_constant = false};
+    InterpretResult res = add_variable(&local_env, index_var);
+    size_t r = 0;
+    for (ASTReduction *reduction = loop->node->for_loop.reductions;
+         reduction && !res.is_error; reduction = reduction->next, r++) {
+        Variable reduction_var = {.variable_name = reduction->variable_name,
+                                  .value = loop->initial[r],
+                                  .is_constant = false};
+        if (reduction->kind == REDUCE_APPEND) {
+            // Allocated here so the chunk owns it & can append to it
+            reduction_var.value.data.array = array_box(array_new(0));
+        }
+        res = add_variable(&local_env, reduction_var);
+    }
+
+    for (size_t i = begin; i < end && !res.is_error; i++) {
+        if (__atomic_load_n(&loop->failed, __ATOMIC_ACQUIRE)) {
+            free_environment(&local_env);
+            return;
+        }
+        local_env.variables[0].value.type = TYPE_INTEGER;
+        local_env.variables[0].value.data.integer =
+            loop->start + (INT_SIZE)i * loop->step;
+
+        LiteralValue value;
+        TailCall *outer_tail = current_tail_call;
+        current_tail_call = NULL;
+        ControlFlow flow =
+            interpret_block(loop->node->for_loop.body, &local_env, &value);
+        current_tail_call = outer_tail;
+        if (flow == FLOW_BREAK || flow == FLOW_RETURN) {
+            res = raise_error(
+                "`break` & `deliver` can't leave a parallel loop.\n");
+        } else {
+            res = flow_to_result(flow, value);
+        }
+    }
+
+    if (res.is_error) {
+        parallel_loop_fail(loop, res);
+    } else {
+        for (size_t j = 0; j < loop->reduction_count; j++) {
+            loop->partials[chunk * loop->reduction_count + j] =
+                local_env.variables[1 + j].value;
+        }
+    }
+    free_environment(&local_env);
+}
+
+// Evaluates a parallel loop's start, end or step, which must be an integer
+InterpretResult parallel_loop_bound(ASTNode *expr, Environment *env,
+                                    const char *what, INT_SIZE *out) {
+    InterpretResult res = interpret_node(expr, env);
+    if (res.is_error) {
+        return res;
+    }
+    if (res.value.type != TYPE_INTEGER) {
+        return raise_error(
+            "%s expression in a parallel `for` loop must be an integer\n",
+            what);
+    }
+    *out = res.value.data.integer;
+    return res;
+}
+
+// Checks a reduction's variable & picks the value each chunk starts from
+InterpretResult parallel_loop_initial(ASTReduction *reduction,
+                                      Environment *env, LiteralValue *out) {
+    const char *name = reduction->variable_name;
+    Variable *var = get_variable(env, name);
+    if (!var) {
+        return raise_error(
+            "Reduction variable `%s` must be declared before the loop.\n",
+            name);
+    }
+    if (var->is_constant || variable_is_read_only(env, name)) {
+        return raise_error("Cannot reduce into `%s`; it isn't writable.\n",
+                           name);
+    }
+
+    LiteralType type = var->value.type;
+    switch (reduction->kind) {
+    case REDUCE_SUM:
+        if (type == TYPE_INTEGER) {
+            out->type = TYPE_INTEGER;
+            out->data.integer = 0;
+            break;
+        } else if (type == TYPE_FLOAT) {
+            out->type = TYPE_FLOAT;
+            out->data.floating_point = 0.0;
+            break;
+        }
+        return raise_error("`sum` reduction variable `%s` must be a number.\n",
+                           name);
+    case REDUCE_MIN:
+    case REDUCE_MAX:
+        if (type != TYPE_INTEGER && type != TYPE_FLOAT) {
+            return raise_error(
+                "`%s` reduction variable `%s` must be a number.\n",
+                reduction->kind == REDUCE_MIN ? "min" : "max", name);
+        }
+        *out = var->value;
+        break;
+    case REDUCE_APPEND:
+        if (type != TYPE_ARRAY) {
+            return raise_error(
+                "`append` reduction variable `%s` must be an array.\n", name);
+        }
+        // Each chunk appends to its own array, created by its own task
+        *out = var->value;
+        break;
+    }
+    return make_result(*out, false, false);
+}
+
+// Merges one chunk's value of a reduction into its running total
+InterpretResult parallel_loop_merge(ReductionKind kind, LiteralValue total,
+                                    LiteralValue partial) {
+    switch (kind) {
+    case REDUCE_SUM:
+    case REDUCE_APPEND:
+        return evaluate_operator("+", total, partial);
+    case REDUCE_MIN:
+    case REDUCE_MAX: {
+        InterpretResult better =
+            evaluate_operator(kind == REDUCE_MIN ? "<" : ">", partial, total);
+        if (better.is_error || !better.value.data.boolean) {
+            return better.is_error ? better : make_result(total, false, false);
+        }
+        return make_result(partial, false, false);
+    }
+    }
+    return make_result(total, false, false);
+}
+
+/**
+ * @brief Interprets `for i in start..end [by step] parallel [reductions]`.
+ *
+ * The iterations are split into chunks run across the worker pool. Each chunk
+ * gets its own environment holding the loop variable, any locals & a private
+ * copy of every reduction variable (`0` for `sum`, the current value for
+ * `min` / `max` & an empty array for `append`). Afterwards the chunks' copies
+ * are merged into the real variables in iteration order, so the results
+ * match a sequential loop.
+ *
+ * @param node The `for` loop node.
+ * @param env  The current environment.
+ * @return InterpretResult The result of the loop.
+ */
+InterpretResult interpret_parallel_for_loop(ASTNode *node, Environment *env) {
+    INT_SIZE start, end, step;
+    InterpretResult bound_res =
+        parallel_loop_bound(node->for_loop.start_expr, env, "Start", &start);
+    if (!bound_res.is_error) {
+        bound_res =
+            parallel_loop_bound(node->for_loop.end_expr, env, "End", &end);
+    }
+    if (!bound_res.is_error) {
+        if (node->for_loop.step_expr) {
+            bound_res = parallel_loop_bound(node->for_loop.step_expr, env,
+                                            "Step", &step);
+        } else {
+            step = start < end ? 1 : -1;
+        }
+    }
+    if (bound_res.is_error) {
+        return bound_res;
+    }
+    if (step == 0) {
+        return raise_error("Step value cannot be zero in `for` loop\n");
+    }
+
+    // Number of iterations, matching the sequential loop's bounds
+    size_t count = 0;
+    if (step > 0) {
+        INT_SIZE limit = node->for_loop.inclusive ? end + 1 : end;
+        if (start < limit) {
+            count = (size_t)((limit - start + step - 1) / step);
+        }
+    } else {
+        INT_SIZE limit = node->for_loop.inclusive ? end - 1 : end;
+        if (start > limit) {
+            count = (size_t)((start - limit - step - 1) / -step);
+        }
+    }
+
+    ParallelLoop loop = {.node = node,
+                         .env = env,
+                         .start = start,
+                         .step = step,
+                         .reduction_count = 0,
+                         .failed = false};
+    for (ASTReduction *reduction = node->for_loop.reductions; reduction;
+         reduction = reduction->next) {
+        loop.reduction_count++;
+    }
+
+    LiteralValue initial[loop.reduction_count ? loop.reduction_count : 1];
+    size_t root_depth = gc_root_depth();
+    size_t r = 0;
+    for (ASTReduction *reduction = node->for_loop.reductions; reduction;
+         reduction = reduction->next, r++) {
+        InterpretResult init_res =
+            parallel_loop_initial(reduction, env, &initial[r]);
+        if (init_res.is_error) {
+            gc_restore_roots(root_depth);
+            return init_res;
+        }
+        gc_push_root(&initial[r]);
+    }
+    loop.initial = initial;
+
+    size_t chunk_size = parallel_chunk_size(count);
+    size_t chunks = (count + chunk_size - 1) / chunk_size;
+    LiteralValue partials = {
+        .type = TYPE_ARRAY,
+        .data.array = array_box(array_new(chunks * loop.reduction_count))};
+    partials.data.array->count = chunks * loop.reduction_count;
+    loop.partials =
+        partials.data.array->count ? partials.data.array->buffer->items : NULL;
+    gc_push_root(&partials);
+    pthread_mutex_init(&loop.lock, NULL);
+
+    parallel_for(count, chunk_size, parallel_loop_task, &loop, env);
+
+    pthread_mutex_destroy(&loop.lock);
+    if (loop.failed) {
+        gc_restore_roots(root_depth);
+        return loop.error;
+    }
+
+    // Merge every chunk's copy into the variable, in iteration order
+    r = 0;
+    for (ASTReduction *reduction = node->for_loop.reductions; reduction;
+         reduction = reduction->next, r++) {
+        Variable *var = get_variable(env, reduction->variable_name);
+        LiteralValue total = var->value;
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            InterpretResult merge_res = parallel_loop_merge(
+                reduction->kind, total,
+                loop.partials[chunk * loop.reduction_count + r]);
+            if (merge_res.is_error) {
+                gc_restore_roots(root_depth);
+                return merge_res;
+            }
+            total = merge_res.value;
+        }
+        var->value = total;
+    }
+
+    gc_restore_roots(root_depth);
     return make_result(create_default_value(), false, false);
 }
 
-InterpretResult interpret_switch(ASTNode *node, Environment *env) {
+ControlFlow interpret_switch(ASTNode *node, Environment *env,
+                             LiteralValue *out) {
     debug_print_int("`interpret_switch()`\n");
 
     // Evaluate the switch expression
-    InterpretResult switch_r =
-        interpret_node(node->switch_case.expression, env);
-    LiteralValue switch_val = switch_r.value;
+    LiteralValue switch_val;
+    interpret(node->switch_case.expression, env, &switch_val);
     debug_print_int("Switch expression evaluated\n");
 
+    // Case conditions & bodies may allocate, so keep the subject reachable
+    gc_push_root(&switch_val);
+
     ASTCaseNode *current_case = node->switch_case.cases;
+    ASTNode *body = NULL;
 
     while (current_case) {
         if (current_case->condition == NULL) {
             // `else` case
             debug_print_int("Executing `else` case\n");
-            ASTNode *current_statement = current_case->body;
-            while (current_statement) {
-                if (current_statement->type == AST_BREAK) {
-                    // Return InterpretResult with did_break = true
-                    debug_print_int("Break encountered in else case\n");
-                    return make_result(create_default_value(), false, true);
-                }
-                // Interpret the statement
-                InterpretResult stmt_res =
-                    interpret_node(current_statement, env);
-                if (stmt_res.did_return || stmt_res.did_break) {
-                    // Propagate the flags upwards
-                    return stmt_res;
-                }
-                current_statement = current_statement->next;
-            }
-            // After else, no more cases to execute
+            body = current_case->body;
             break;
-        } else {
-            // Evaluate the case condition
-            InterpretResult case_r =
-                interpret_node(current_case->condition, env);
-            LiteralValue case_val = case_r.value;
-
-            bool values_match = false;
-
-            // Handle type comparison
-            if (switch_val.type == case_val.type) {
-                if (switch_val.type == TYPE_BOOLEAN) {
-                    values_match =
-                        (switch_val.data.boolean == case_val.data.boolean);
-                } else if (switch_val.type == TYPE_FLOAT) {
-                    values_match = (switch_val.data.floating_point ==
-                                    case_val.data.floating_point);
-                } else if (switch_val.type == TYPE_INTEGER) {
-                    values_match =
-                        (switch_val.data.integer == case_val.data.integer);
-                } else if (switch_val.type == TYPE_STRING) {
-                    values_match = (strcmp(switch_val.data.string,
-                                           case_val.data.string) == 0);
-                }
-            }
+        }
 
-            if (values_match) {
-                debug_print_int("Match found, executing case body\n");
-
-                ASTNode *current_statement = current_case->body;
-                while (current_statement) {
-                    if (current_statement->type == AST_BREAK) {
-                        // Return InterpretResult with did_break = true
-                        debug_print_int("Break encountered in matched case\n");
-                        return make_result(create_default_value(), false, true);
-                    }
-                    // Interpret the statement
-                    InterpretResult stmt_res =
-                        interpret_node(current_statement, env);
-                    if (stmt_res.did_return || stmt_res.did_break) {
-                        // Propagate the flags upwards
-                        return stmt_res;
-                    }
-                    current_statement = current_statement->next;
-                }
-                // After matched case, no more cases to execute
-                break;
+        // Evaluate the case condition
+        LiteralValue case_val;
+        interpret(current_case->condition, env, &case_val);
+
+        bool values_match = false;
+
+        // Handle type comparison
+        if (switch_val.type == case_val.type) {
+            if (switch_val.type == TYPE_BOOLEAN) {
+                values_match =
+                    (switch_val.data.boolean == case_val.data.boolean);
+            } else if (switch_val.type == TYPE_FLOAT) {
+                values_match = (switch_val.data.floating_point ==
+                                case_val.data.floating_point);
+            } else if (switch_val.type == TYPE_INTEGER) {
+                values_match =
+                    (switch_val.data.integer == case_val.data.integer);
+            } else if (switch_val.type == TYPE_STRING) {
+                values_match = fl_string_equals(switch_val.data.string,
+                                                case_val.data.string);
             }
         }
 
+        if (values_match) {
+            debug_print_int("Match found, executing case body\n");
+            body = current_case->body;
+            break;
+        }
+
         current_case = current_case->next;
     }
 
+    // A `break` just ends the case; a `deliver` or an error carries on
+    // upwards
+    ControlFlow flow = interpret_block(body, env, out);
+    gc_pop_roots(1);
     debug_print_int("Switch statement interpretation complete\n");
-
-    // Return a default value, no break or return encountered
-    return make_result(create_default_value(), false, false);
+    if (flow == FLOW_BREAK) {
+        *out = create_default_value();
+        return FLOW_NORMAL;
+    }
+    return flow;
 }
 
 /**
  * Function to call a user-defined function
  */
-InterpretResult call_user_defined_function(Function *func_ref,
-                                           ASTNode *call_node,
-                                           Environment *env) {
+ControlFlow call_user_defined_function(Function *func_ref, ASTNode *call_node,
+                                       Environment *env, LiteralValue *out) {
     debug_print_int("Calling user-defined function: `%s`\n", func_ref->name);
 
     // Create a new local environment with 'env' as its parent
     Environment local_env;
     init_environment_with_parent(&local_env, env);
 
-    // Bind function parameters with arguments
+    if (bind_arguments(func_ref, call_node, env, &local_env, out) ==
+        FLOW_ERROR) {
+        free_environment(&local_env);
+        return FLOW_ERROR; // Propagate the error
+    }
+
+    if (func_ref->memo && !parallel_in_task()) {
+        return execute_memoized_body(func_ref, &local_env, out);
+    }
+    return execute_function_body(func_ref, &local_env, out);
+}
+
+// Evaluates a call's arguments in `env` & binds them to the function's
+// parameters in `local_env`
+ControlFlow bind_arguments(Function *func_ref, ASTNode *call_node,
+                           Environment *env, Environment *local_env,
+                           LiteralValue *out) {
     ASTFunctionParameter *param = func_ref->parameters;
     ASTNode *arg = call_node->function_call.arguments;
 
     while (param && arg) {
-        InterpretResult arg_res = interpret_node(arg, env);
-        if (arg_res.is_error) {
-            free_environment(&local_env);
-            return arg_res; // Propagate the error
+        LiteralValue arg_value;
+        if (interpret(arg, env, &arg_value) == FLOW_ERROR) {
+            *out = arg_value;
+            return FLOW_ERROR;
         }
 
-        LiteralValue arg_value = arg_res.value;
-
         // Bind the argument to the parameter in the local environment
-        Variable param_var = {.variable_name = strdup(param->parameter_name),
+        Variable param_var = {.variable_name = param->parameter_name,
                               .value = arg_value,
                               .is_constant = false};
-        InterpretResult add_res = add_variable(&local_env, param_var);
+        InterpretResult add_res = add_variable(local_env, param_var);
         if (add_res.is_error) {
-            free_environment(&local_env);
-            return add_res;
+            return result_to_flow(add_res, out);
         }
 
         param = param->next;
@@ -1487,38 +2039,249 @@ InterpretResult call_user_defined_function(Function *func_ref,
 
     // Check for argument count mismatch
     if (param || arg) {
-        free_environment(&local_env);
-        return raise_error(
-            "Argument count mismatch when calling function `%s`\n",
-            func_ref->name);
+        return result_to_flow(
+            raise_error("Argument count mismatch when calling function `%s`\n",
+                        func_ref->name),
+            out);
+    }
+
+    *out = create_default_value();
+    return FLOW_NORMAL;
+}
+
+/**
+ * @brief Runs a function's body in its (already populated) local environment,
+ * which it frees afterwards.
+ *
+ * The call is where a `deliver` stops, so this only ever finishes normally
+ * (with the delivered value, or `0` without one) or with an error. Calls
+ * nested deeper than `--max-depth` (or than the stack has room for) fail
+ * with a stack overflow error instead of crashing.
+ *
+ * A `deliver f(...)` hands `f` back here with its arguments already bound
+ * (`interpret_tail_call()`), so `f` runs in this call's place: tail-recursive
+ * functions use the same C stack & the same two environments however many
+ * times they recurse.
+ */
+ControlFlow execute_function_body(Function *func_ref, Environment *local_env,
+                                  LiteralValue *out) {
+    if (!call_stack_enter()) {
+        free_environment(local_env);
+        return result_to_flow(call_stack_overflow(), out);
+    }
+
+    Environment spare;
+    TailCall tail = {.frame = local_env, .next = &spare, .function = NULL};
+    TailCall *outer_tail = current_tail_call;
+    current_tail_call = &tail;
+
+    ControlFlow flow = interpret_block(func_ref->body, tail.frame, out);
+    while (tail.function) {
+        // Swap in the handed over call's frame & reuse the old one for the
+        // next hand over
+        func_ref = tail.function;
+        tail.function = NULL;
+        Environment *done = tail.frame;
+        free_environment(done);
+        tail.frame = tail.next;
+        tail.next = done;
+
+        flow = interpret_block(func_ref->body, tail.frame, out);
+    }
+
+    current_tail_call = outer_tail;
+    free_environment(tail.frame);
+    call_stack_leave();
+    return flow == FLOW_ERROR ? FLOW_ERROR : FLOW_NORMAL;
+}
+
+/**
+ * @brief Runs a `memoize()`d function's body, or skips it if the function's
+ * result for these arguments (the first variables of `local_env`) is already
+ * known. Like `execute_function_body()`, it frees `local_env`.
+ *
+ * Calls with arguments that can't be keys run as usual, & only results that
+ * can be stored are remembered. Parallel tasks call the function as usual,
+ * as the table isn't shared between threads.
+ */
+ControlFlow execute_memoized_body(Function *func_ref, Environment *local_env,
+                                  LiteralValue *out) {
+    MemoTable *memo = func_ref->memo;
+    size_t num_params = 0;
+    for (ASTFunctionParameter *param = func_ref->parameters; param;
+         param = param->next) {
+        num_params++;
+    }
+    if (!memo_key_supported(local_env, num_params)) {
+        return execute_function_body(func_ref, local_env, out);
+    }
+
+    size_t hash = memo_hash(local_env, num_params);
+    if (memo_get(memo, local_env, num_params, hash, out)) {
+        free_environment(local_env);
+        return FLOW_NORMAL;
     }
 
-    // Interpret the function body
-    ASTNode *stmt = func_ref->body;
-    InterpretResult func_res =
-        make_result(create_default_value(), false, false);
+    // The key is copied first, as the body may assign to its parameters
+    MemoEntry *entry = memo_entry_new(local_env, num_params, hash);
+    ControlFlow flow = execute_function_body(func_ref, local_env, out);
+    if (flow == FLOW_ERROR) {
+        memo_entry_free(entry);
+    } else {
+        memo_put(memo, entry, *out);
+    }
+    return flow;
+}
 
-    while (stmt) {
-        InterpretResult r = interpret_node(stmt, &local_env);
-        if (r.did_return) {
-            func_res = r;
+// Whether `func` is declared outside the running function's frame (or any
+// scope inside it), so it's still around once that frame is freed
+bool function_outlives_frame(Function *func, Environment *env,
+                             Environment *frame) {
+    for (Environment *scope = env; scope; scope = scope->parent) {
+        if (func >= scope->functions &&
+            func < scope->functions + scope->function_count) {
+            return false;
+        }
+        if (scope == frame) {
             break;
         }
-        if (r.did_break) {
-            free_environment(&local_env);
-            return r;
+    }
+    return true;
+}
+
+// Whether `func` could still see everything it can see from `env` if it ran
+// in place of the current function, i.e. under `frame`'s parent. Names
+// declared in `frame` (or a scope inside it) are only hidden from it if it
+// doesn't bind them as parameters & it, or a function it calls, may look them
+// up (see `free_names_scan()`).
+bool tail_call_keeps_scope(Function *func, Environment *env,
+                           Environment *frame) {
+    // Parallel tasks share functions, so they work the names out each time
+    FreeNames *names = func->free_names;
+    bool in_task = parallel_in_task();
+    if (in_task || !names || names->version != function_version()) {
+        names = free_names_scan(func, env);
+        if (!in_task) {
+            free_names_free(func->free_names);
+            func->free_names = names;
+        }
+    }
+
+    bool keeps = true;
+    for (Environment *scope = env; scope && keeps; scope = scope->parent) {
+        for (size_t i = 0; i < scope->variable_count && keeps; i++) {
+            const char *name = scope->variables[i].variable_name;
+            bool is_parameter = false;
+            for (ASTFunctionParameter *param = func->parameters; param;
+                 param = param->next) {
+                if (strcmp(param->parameter_name, name) == 0) {
+                    is_parameter = true;
+                    break;
+                }
+            }
+            keeps = is_parameter ||
+                    (!names->unknown && !free_names_contains(names, name));
         }
-        if (r.is_error) {
+        for (size_t i = 0; i < scope->function_count && keeps; i++) {
+            keeps = !names->unknown &&
+                    !free_names_contains(names, scope->functions[i].name);
+        }
+        if (scope == frame) {
+            break;
+        }
+    }
+
+    if (in_task) {
+        free_names_free(names);
+    }
+    return keeps;
+}
+
+/**
+ * @brief Runs `deliver f(...)` in a function.
+ *
+ * If `f` is a user-defined function, its arguments are bound into a new frame
+ * & it's handed over to `execute_function_body()`, which runs it in place of
+ * the current function (a tail call). Like any call, `f`'s frame sits under
+ * the environment the current function was called from. Built-ins, record
+ * constructors, functions declared inside the current function & functions
+ * that may use its variables or functions (`tail_call_keeps_scope()`) are
+ * simply called.
+ */
+ControlFlow interpret_tail_call(ASTNode *node, Environment *env,
+                                LiteralValue *out) {
+    Function *func;
+    ControlFlow flow = resolve_function_call(node, env, &func, out);
+    if (flow != FLOW_NORMAL) {
+        return flow;
+    }
+
+    TailCall *tail = current_tail_call;
+    bool in_place = !func->is_builtin && !func->record && !func->memo &&
+                    function_outlives_frame(func, env, tail->frame) &&
+                    tail_call_keeps_scope(func, env, tail->frame);
+
+    // An inlined call needs no frame at all. Like the tail call it replaces,
+    // it skips the current function's scope when that's safe.
+    ASTNode *inlined = inlined_call_body(node, func, env);
+    if (inlined) {
+        flow = interpret_inline_call(node, inlined, env,
+                                     in_place ? tail->frame->parent : env, out);
+        return flow == FLOW_ERROR ? FLOW_ERROR : FLOW_RETURN;
+    }
+
+    if (!in_place) {
+        flow = call_function(func, node, env, out);
+        return flow == FLOW_ERROR ? FLOW_ERROR : FLOW_RETURN;
+    }
+
+    init_environment_with_parent(tail->next, tail->frame->parent);
+    if (bind_arguments(func, node, env, tail->next, out) == FLOW_ERROR) {
+        free_environment(tail->next);
+        return FLOW_ERROR;
+    }
+    tail->function = func;
+    return FLOW_RETURN;
+}
+
+/**
+ * @brief Calls a user-defined function with already evaluated arguments (for
+ * built-ins that take a function, like `sort_by()`).
+ *
+ * @return InterpretResult The function's result, as a plain value.
+ */
+InterpretResult call_function_with_values(Function *func_ref,
+                                          LiteralValue *args, size_t num_args,
+                                          Environment *env) {
+    Environment local_env;
+    init_environment_with_parent(&local_env, env);
+
+    ASTFunctionParameter *param = func_ref->parameters;
+    size_t i = 0;
+    for (; param && i < num_args; param = param->next, i++) {
+        Variable param_var = {.variable_name = param->parameter_name,
+                              .value = args[i],
+                              .is_constant = false};
+        InterpretResult add_res = add_variable(&local_env, param_var);
+        if (add_res.is_error) {
             free_environment(&local_env);
-            return r;
+            return add_res;
         }
-        stmt = stmt->next;
     }
 
-    free_environment(&local_env);
+    if (param || i < num_args) {
+        free_environment(&local_env);
+        return raise_error(
+            "Argument count mismatch when calling function `%s`\n",
+            func_ref->name);
+    }
 
-    // If no explicit return, return default value (e.g., `0`)
-    return func_res;
+    LiteralValue value;
+    ControlFlow flow =
+        func_ref->memo && !parallel_in_task()
+            ? execute_memoized_body(func_ref, &local_env, &value)
+            : execute_function_body(func_ref, &local_env, &value);
+    return flow_to_result(flow, value);
 }
 
 InterpretResult interpret_function_declaration(ASTNode *node,
@@ -1579,208 +2342,722 @@ InterpretResult interpret_function_declaration(ASTNode *node,
     return make_result(create_default_value(), false, false);
 }
 
-InterpretResult interpret_function_call(ASTNode *node, Environment *env) {
+ControlFlow interpret_function_call(ASTNode *node, Environment *env,
+                                    LiteralValue *out) {
     debug_print_int("Starting function call interpretation\n");
 
+    Function *func;
+    ControlFlow flow = resolve_function_call(node, env, &func, out);
+    if (flow != FLOW_NORMAL) {
+        return flow;
+    }
+
+    ASTNode *inlined = inlined_call_body(node, func, env);
+    if (inlined) {
+        return interpret_inline_call(node, inlined, env, env, out);
+    }
+    return call_function(func, node, env, out);
+}
+
+// The inlined body of a call that resolved to `func` (see `inliner_expand()`),
+// or NULL. It's built the first time the call site's cache holds `func`, &
+// again once functions have changed. A call site that calls several
+// functions isn't inlined until then. Parallel tasks share the AST, so they
+// always make the call.
+ASTNode *inlined_call_body(ASTNode *node, Function *func, Environment *env) {
+    ASTFunctionCall *call = &node->function_call;
+    if (parallel_in_task() || func->memo || call->cached_function != func) {
+        return NULL;
+    }
+
+    if (call->inlined_version == call->cached_version) {
+        if (call->inlined_function != func) {
+            free_ast(call->inlined_body);
+            call->inlined_body = NULL;
+            call->inlined_function = NULL;
+        }
+        return call->inlined_body;
+    }
+
+    free_ast(call->inlined_body);
+    call->inlined_body = inliner_expand(func, node, env);
+    call->inlined_function = func;
+    call->inlined_version = call->cached_version;
+    return call->inlined_body;
+}
+
+/**
+ * @brief Evaluates an inlined call: its arguments (in `env`), in order, then
+ * the function's `deliver` expression with its parameters reading them.
+ *
+ * No environment is created. The expression runs in `body_env`, the parent
+ * the function's own environment would have had (the caller's, or the
+ * caller's caller for a tail call), where it would have looked up everything
+ * but its parameters.
+ */
+ControlFlow interpret_inline_call(ASTNode *node, ASTNode *inlined,
+                                  Environment *env, Environment *body_env,
+                                  LiteralValue *out) {
+    LiteralValue args[INLINER_MAX_ARGUMENTS];
+    size_t depth = gc_root_depth();
+    size_t count = 0;
+    for (ASTNode *arg = node->function_call.arguments; arg; arg = arg->next) {
+        if (interpret(arg, env, &args[count]) == FLOW_ERROR) {
+            gc_restore_roots(depth);
+            *out = args[count];
+            return FLOW_ERROR;
+        }
+        gc_push_root(&args[count]);
+        count++;
+    }
+
+    LiteralValue *outer_arguments = inline_arguments;
+    inline_arguments = args;
+    ControlFlow flow = interpret(inlined, body_env, out);
+    inline_arguments = outer_arguments;
+    gc_restore_roots(depth);
+    return flow == FLOW_ERROR ? FLOW_ERROR : FLOW_NORMAL;
+}
+
+// Finds the function a call node refers to
+ControlFlow resolve_function_call(ASTNode *node, Environment *env,
+                                  Function **func, LiteralValue *out) {
     if (!node || node->type != AST_FUNCTION_CALL ||
         !node->function_call.function_ref) {
-        return raise_error("Invalid function call");
+        return result_to_flow(raise_error("Invalid function call"), out);
+    }
+
+    // A name only functions are given always refers to a function of that
+    // name, so skip walking every caller's variables to find it (which made
+    // deep recursion quadratic). Parallel tasks share the AST, so they always
+    // look the name up.
+    ASTFunctionCall *call = &node->function_call;
+    bool use_cache = !parallel_in_task();
+    size_t version = function_version();
+    if (use_cache && call->cached_direct && call->cached_version == version) {
+        *func = call->cached_function;
+        return FLOW_NORMAL;
     }
 
     // Interpret the function reference to get the function name
-    InterpretResult func_ref_result =
-        interpret_node(node->function_call.function_ref, env);
-    if (func_ref_result.is_error) {
-        return func_ref_result; // Propagate the error
+    LiteralValue func_ref;
+    if (interpret(node->function_call.function_ref, env, &func_ref) ==
+        FLOW_ERROR) {
+        *out = func_ref;
+        return FLOW_ERROR; // Propagate the error
+    }
+
+    const char *func_name = NULL;
+    if (func_ref.type == TYPE_FUNCTION) {
+        // If it's a function type, get the name
+        func_name = func_ref.data.function_name;
+    } else if (func_ref.type == TYPE_STRING) {
+        // If it's a string, use it directly
+        func_name = func_ref.data.string->bytes;
+    } else {
+        return result_to_flow(
+            raise_error(
+                "Function reference must evaluate to a string or function.\n"),
+            out);
+    }
+
+    // Otherwise reuse the function this call site found last time if no
+    // function has been declared or freed since
+    if (use_cache && call->cached_version == version &&
+        strcmp(call->cached_function->name, func_name) == 0) {
+        *func = call->cached_function;
+        return FLOW_NORMAL;
+    }
+
+    // Lookup the function by name
+    *func = get_function(env, func_name);
+    if (!*func) {
+        return result_to_flow(
+            raise_error("Undefined function `%s`\n", func_name), out);
+    }
+    if (use_cache) {
+        ASTNode *ref = call->function_ref;
+        call->cached_function = *func;
+        call->cached_version = version;
+        call->cached_direct = ref->type == AST_VARIABLE_REFERENCE &&
+                              strcmp(ref->variable_name, func_name) == 0 &&
+                              bindings_count(func_name) == 0;
+    }
+    return FLOW_NORMAL;
+}
+
+// Calls a resolved function with a call node's arguments
+ControlFlow call_function(Function *func, ASTNode *node, Environment *env,
+                          LiteralValue *out) {
+    // Record constructors
+    if (func->record) {
+        return result_to_flow(
+            interpret_record_construction(node, func->record, env), out);
+    }
+
+    // Handle built-in functions
+    if (func->is_builtin) {
+        return result_to_flow(call_builtin_function(func, node, env), out);
+    }
+
+    // Handle user-defined functions
+    return call_user_defined_function(func, node, env, out);
+}
+
+// Runs a built-in (or a plugin's C function) on a call's argument nodes
+InterpretResult call_builtin_function(Function *func, ASTNode *node,
+                                      Environment *env) {
+    if (func->builtin) {
+        return call_builtin(func->builtin, node, env);
+    }
+    if (!func->c_function) {
+        return raise_error("Unknown built-in function `%s`\n", func->name);
+    }
+    return func->c_function(node, env);
+}
+
+ControlFlow interpret_ternary(ASTNode *node, Environment *env,
+                              LiteralValue *out) {
+    if (!node || node->type != AST_TERNARY) {
+        return result_to_flow(
+            raise_error("Invalid ternary operation node.\n"), out);
+    }
+
+    ControlFlow flow = interpret(node->ternary.condition, env, out);
+    if (flow != FLOW_NORMAL) {
+        return flow;
+    }
+
+    bool is_true = false;
+    if (out->type == TYPE_BOOLEAN) {
+        is_true = out->data.boolean;
+    } else if (out->type == TYPE_INTEGER) {
+        is_true = (out->data.integer != 0);
+    } else {
+        return result_to_flow(
+            raise_error("Ternary condition must be boolean or integer.\n"),
+            out);
+    }
+
+    return interpret(is_true ? node->ternary.true_expr
+                             : node->ternary.false_expr,
+                     env, out);
+}
+
+ControlFlow interpret_try(ASTNode *node, Environment *env, LiteralValue *out) {
+    if (!node || node->type != AST_TRY) {
+        return result_to_flow(raise_error("Invalid AST node for try block."),
+                              out);
+    }
+
+    size_t root_depth = gc_root_depth();
+
+    // Execute try block; a `deliver` or `break` skips the rest of the
+    // statement (including the finish block). Calls in it can't replace the
+    // current function, or the rescue block wouldn't see their errors.
+    TailCall *outer_tail = current_tail_call;
+    current_tail_call = NULL;
+    ControlFlow flow = interpret_block(node->try_block.try_block, env, out);
+    current_tail_call = outer_tail;
+    if (flow == FLOW_RETURN || flow == FLOW_BREAK) {
+        return flow;
+    }
+
+    // If exception occurred, handle rescue blocks
+    if (flow == FLOW_ERROR) {
+        // Drop any temporaries the failed evaluation left behind & keep the
+        // error value alive instead
+        LiteralValue exception_value = *out;
+        gc_restore_roots(root_depth);
+        gc_push_root(&exception_value);
+
+        ASTCatchNode *catch = node->try_block.catch_blocks;
+        if (!catch) {
+            // No rescue block handles the exception, propagate it
+            gc_restore_roots(root_depth);
+            *out = exception_value;
+            return FLOW_ERROR;
+        }
+
+        // Currently handling only one catch block
+        Environment catch_env;
+        init_environment_with_parent(&catch_env, env);
+
+        // If there's an error variable, bind the exception to it
+        if (catch->error_variable) {
+            Variable error_var = {
+                .variable_name = strdup(catch->error_variable),
+                .value = exception_value,
+                .is_constant = false};
+            add_variable(&catch_env, error_var);
+        }
+
+        // Execute catch block; a nested exception, `deliver` or `break`
+        // propagates
+        flow = interpret_block(catch->body, &catch_env, out);
+        free_environment(&catch_env);
+        gc_restore_roots(root_depth);
+        if (flow != FLOW_NORMAL) {
+            return flow;
+        }
+    }
+
+    // Execute finish block if it exists; an exception in it takes priority
+    flow = interpret_block(node->try_block.finally_block, env, out);
+    if (flow != FLOW_NORMAL) {
+        return flow;
+    }
+
+    // Normal execution
+    *out = create_default_value();
+    return FLOW_NORMAL;
+}
+
+// ==================================================
+// RECORDS
+// ==================================================
+
+/**
+ * @brief Declares a record type & its constructor function, which takes one
+ * argument per field (in declaration order).
+ *
+ * @param node
+ * @param env
+ * @return InterpretResult
+ */
+InterpretResult interpret_record_declaration(ASTNode *node, Environment *env) {
+    const ASTRecordDeclaration *decl = &node->record_declaration;
+    RecordType *type =
+        record_type_new(decl->name, decl->field_names, decl->field_ids,
+                        decl->field_count);
+
+    Function constructor = {.name = type->name,
+                            .parameters = NULL,
+                            .body = NULL,
+                            .is_builtin = true,
+                            .c_function = NULL,
+                            .record = type};
+    add_function(env, constructor);
+
+    // Also add the constructor as a variable holding its name
+    LiteralValue func_ref = {.type = TYPE_FUNCTION,
+                             .data.function_name = safe_strdup(type->name)};
+    Variable var = {.variable_name = safe_strdup(type->name),
+                    .value = func_ref,
+                    .is_constant = false};
+    InterpretResult add_var_res = add_variable(env, var);
+    if (add_var_res.is_error) {
+        return add_var_res;
+    }
+
+    return make_result(create_default_value(), false, false);
+}
+
+/**
+ * @brief Interprets a call to a record constructor, like `Point(1, 2)`.
+ *
+ * @param node The AST_FUNCTION_CALL node.
+ * @param type The record type being constructed.
+ * @param env  The current environment.
+ * @return InterpretResult The new record.
+ */
+InterpretResult interpret_record_construction(ASTNode *node,
+                                              const RecordType *type,
+                                              Environment *env) {
+    if (helper_count_arguments(node) != type->field_count) {
+        return raise_error("`%s()` expects exactly %zu argument%s (one per "
+                           "field).\n",
+                           type->name, type->field_count,
+                           type->field_count == 1 ? "" : "s");
+    }
+
+    // Fields are evaluated straight into the (rooted) record
+    LiteralValue result;
+    result.type = TYPE_RECORD;
+    result.data.record = record_new(type);
+    gc_push_root(&result);
+
+    size_t slot = 0;
+    for (ASTNode *arg = node->function_call.arguments; arg; arg = arg->next) {
+        InterpretResult r = interpret_node(arg, env);
+        if (r.is_error) {
+            gc_pop_roots(1);
+            return r;
+        }
+        result.data.record->fields[slot++] = r.value;
+    }
+    gc_pop_roots(1);
+
+    return make_result(result, false, false);
+}
+
+// Evaluates the record whose field is being accessed
+InterpretResult field_access_record(ASTNode *node, Environment *env,
+                                    size_t *slot) {
+    InterpretResult object_res = interpret_node(node->field_access.object, env);
+    if (object_res.is_error) {
+        return object_res;
+    }
+    if (object_res.value.type != TYPE_RECORD) {
+        return raise_error("Cannot access field `%s` of type `%s`; fields "
+                           "need a record.\n",
+                           node->field_access.field_name,
+                           literal_type_to_string(object_res.value.type));
     }
 
-    const char *func_name = NULL;
-    Function *func = NULL;
+    const RecordType *type = object_res.value.data.record->type;
+    if (!record_find_slot(type, node->field_access.field_id,
+                          node->field_access.slot, slot)) {
+        return raise_error("Record `%s` has no field `%s`.\n", type->name,
+                           node->field_access.field_name);
+    }
+    return object_res;
+}
+
+/**
+ * @brief Interprets `record.field`, which loads the field's slot directly.
+ *
+ * @param node
+ * @param env
+ * @return InterpretResult
+ */
+InterpretResult interpret_field_access(ASTNode *node, Environment *env) {
+    size_t slot;
+    InterpretResult record_res = field_access_record(node, env, &slot);
+    if (record_res.is_error) {
+        return record_res;
+    }
+    return make_result(record_res.value.data.record->fields[slot], false,
+                       false);
+}
+
+/**
+ * @brief Interprets `record.field = value` (including `xs[i].field = value`
+ * & `a.b.c = value`, since records are shared by reference).
+ *
+ * @param lhs_node The AST_FIELD_ACCESS on the left of the assignment.
+ * @param env      The current environment.
+ * @param value    The value being assigned.
+ * @return InterpretResult The assigned value.
+ */
+InterpretResult interpret_field_assignment(ASTNode *lhs_node, Environment *env,
+                                           LiteralValue value) {
+    gc_push_root(&value);
+    size_t slot;
+    InterpretResult record_res = field_access_record(lhs_node, env, &slot);
+    gc_pop_roots(1);
+    if (record_res.is_error) {
+        return record_res;
+    }
+
+    RecordValue *record = record_res.value.data.record;
+    if (!record_writable(record)) {
+        return raise_error("Cannot modify a record in a parallel task; "
+                           "records created outside the task are "
+                           "read-only.\n");
+    }
+    record->fields[slot] = value;
+    return make_result(value, false, false);
+}
+
+// ==================================================
+// MAPS
+// ==================================================
+
+/**
+ * @brief Interprets map literals like `{"salt": 2, "sugar": 1}`.
+ *
+ * @param node
+ * @param env
+ * @return InterpretResult
+ */
+InterpretResult interpret_map_literal(ASTNode *node, Environment *env) {
+    if (node->type != AST_MAP_LITERAL) {
+        return raise_error("Expected AST_MAP_LITERAL node.\n");
+    }
+
+    // Keep the partially built map (& each key) reachable while the entries
+    // are evaluated
+    LiteralValue result;
+    result.type = TYPE_MAP;
+    result.data.map = map_new(node->map_literal.count);
+    gc_push_root(&result);
+
+    for (size_t i = 0; i < node->map_literal.count; i++) {
+        InterpretResult key_res = interpret_node(node->map_literal.keys[i], env);
+        if (key_res.is_error) {
+            gc_pop_roots(1);
+            return key_res;
+        }
+        if (!map_key_supported(key_res.value)) {
+            gc_pop_roots(1);
+            return raise_error("Map keys must be strings, integers, floats or "
+                               "booleans, not %s.\n",
+                               literal_type_to_string(key_res.value.type));
+        }
+
+        gc_push_root(&key_res.value);
+        InterpretResult value_res =
+            interpret_node(node->map_literal.values[i], env);
+        gc_pop_roots(1);
+        if (value_res.is_error) {
+            gc_pop_roots(1);
+            return value_res;
+        }
+
+        map_set(result.data.map, key_res.value, value_res.value);
+    }
+    gc_pop_roots(1);
+
+    return make_result(result, false, false);
+}
+
+// Raises the error for looking up a key that isn't in a map
+InterpretResult map_key_error(LiteralValue key) {
+    char *key_str = literal_value_to_string(key);
+    InterpretResult error =
+        raise_error("Key `%s` not found in map.\n", key_str ? key_str : "?");
+    free(key_str);
+    return error;
+}
+
+// ==================================================
+// MATRICES
+// ==================================================
 
-    if (func_ref_result.value.type == TYPE_FUNCTION) {
-        // If it's a function type, get the name
-        func_name = func_ref_result.value.data.function_name;
-    } else if (func_ref_result.value.type == TYPE_STRING) {
-        // If it's a string, use it directly
-        func_name = func_ref_result.value.data.string;
-    } else {
-        return raise_error(
-            "Function reference must evaluate to a string or function.\n");
-    }
+/**
+ * @brief Evaluates the column of `m[i, j]` & finds the element it names.
+ *
+ * @param node   The index access node (which has a column).
+ * @param env    The current environment.
+ * @param matrix The already evaluated matrix (rooted by the caller).
+ * @param row    The already evaluated row index.
+ * @param offset Receives the element's offset in `matrix->cells`.
+ * @return InterpretResult An error if an index isn't an integer or is out of
+ * bounds.
+ */
+InterpretResult matrix_element_offset(ASTNode *node, Environment *env,
+                                      const MatrixValue *matrix,
+                                      LiteralValue row, size_t *offset) {
+    InterpretResult col_res =
+        interpret_node(node->array_index_access.column, env);
+    if (col_res.is_error) {
+        return col_res;
+    }
+    if (row.type != TYPE_INTEGER || col_res.value.type != TYPE_INTEGER) {
+        return raise_error("Matrix indices must be integers.\n");
+    }
+    if (!matrix_offset(matrix, row.data.integer, col_res.value.data.integer,
+                       offset)) {
+        return raise_error("Matrix index `[" INT_FORMAT ", " INT_FORMAT
+                           "]` out of bounds for a %zux%zu matrix.\n",
+                           row.data.integer, col_res.value.data.integer,
+                           matrix->rows, matrix->cols);
+    }
+    return col_res;
+}
 
-    // Lookup the function by name
-    func = get_function(env, func_name);
-    if (!func) {
-        return raise_error("Undefined function `%s`\n", func_name);
-    }
+// Handles `m[i, j]` (an element) & `m[i]` (a copy of a row, as a float array)
+InterpretResult interpret_matrix_index_access(ASTNode *node, Environment *env,
+                                              LiteralValue operand,
+                                              LiteralValue index) {
+    const MatrixValue *matrix = operand.data.matrix;
+    LiteralValue result;
 
-    // Handle built-in functions
-    if (func->is_builtin) {
-        if (func->c_function != NULL) { // externally imported function
-            return func->c_function(node, env);
-        } else if (strcmp(func->name, "sample") == 0) {
-            return builtin_input(node, env);
-        } else if (strcmp(func->name, "serve") == 0) {
-            return builtin_output(node, env);
-        } else if (strcmp(func->name, "burn") == 0) {
-            return builtin_error(node, env);
-        } else if (strcmp(func->name, "random") == 0) {
-            return builtin_random(node, env);
-        } else if (strcmp(func->name, "string") == 0 ||
-                   strcmp(func->name, "int") == 0 ||
-                   strcmp(func->name, "float") == 0) {
-            return builtin_cast(node, env);
-        } else if (strcmp(func->name, "get_time") == 0) {
-            return builtin_time();
-        } else if (strcmp(func->name, "taste_file") == 0) {
-            return builtin_file_read(node, env);
-        } else if (strcmp(func->name, "plate_file") == 0) {
-            return builtin_file_write(node, env);
-        } else if (strcmp(func->name, "garnish_file") == 0) {
-            return builtin_file_append(node, env);
-        } else if (strcmp(func->name, "length") == 0) {
-            return builtin_length(node, env);
-        } else if (strcmp(func->name, "sleep") == 0) {
-            return builtin_sleep(node, env);
-        } else if (strcmp(func->name, "floor") == 0) {
-            return builtin_floor(node, env);
-        } else if (strcmp(func->name, "ceil") == 0) {
-            return builtin_ceil(node, env);
-        } else if (strcmp(func->name, "round") == 0) {
-            return builtin_round(node, env);
-        } else if (strcmp(func->name, "abs") == 0) {
-            return builtin_abs(node, env);
-        } else {
-            return raise_error("Unknown built-in function `%s`\n", func->name);
+    if (node->array_index_access.column) {
+        size_t offset;
+        gc_push_root(&operand);
+        InterpretResult res =
+            matrix_element_offset(node, env, matrix, index, &offset);
+        gc_pop_roots(1);
+        if (res.is_error) {
+            return res;
         }
-    } else {
-        // Handle user-defined functions
-        return call_user_defined_function(func, node, env);
+        result.type = TYPE_FLOAT;
+        result.data.floating_point = matrix->cells[offset];
+        return make_result(result, false, false);
     }
-}
 
-InterpretResult interpret_ternary(ASTNode *node, Environment *env) {
-    if (!node || node->type != AST_TERNARY) {
-        return raise_error("Invalid ternary operation node.\n");
+    if (index.type != TYPE_INTEGER) {
+        return raise_error("Matrix row index must be an integer.\n");
     }
-
-    InterpretResult cond_res = interpret_node(node->ternary.condition, env);
-    if (cond_res.is_error || cond_res.did_return || cond_res.did_break) {
-        return cond_res;
+    INT_SIZE row = index.data.integer;
+    if (row < 0) {
+        row += (INT_SIZE)matrix->rows;
     }
+    if (row < 0 || (size_t)row >= matrix->rows) {
+        return raise_error("Matrix row `" INT_FORMAT "` out of bounds.\n",
+                           index.data.integer);
+    }
+    result.type = TYPE_ARRAY;
+    result.data.array = array_box(matrix_row(matrix, (size_t)row));
+    return make_result(result, false, false);
+}
 
-    bool is_true = false;
-    if (cond_res.value.type == TYPE_BOOLEAN) {
-        is_true = cond_res.value.data.boolean;
-    } else if (cond_res.value.type == TYPE_INTEGER) {
-        is_true = (cond_res.value.data.integer != 0);
-    } else {
-        return raise_error("Ternary condition must be boolean or integer.\n");
+/**
+ * @brief Handles assignments to matrix elements, like `m[i, j] = x`.
+ *
+ * @param lhs_node The index access node (which has a column).
+ * @param env      The current environment.
+ * @param value    The already evaluated value to store (a number).
+ * @return InterpretResult The stored value.
+ */
+InterpretResult interpret_matrix_assignment(ASTNode *lhs_node, Environment *env,
+                                            LiteralValue value) {
+    ASTNode *object_node = lhs_node->array_index_access.array;
+    if (object_node->type == AST_VARIABLE_REFERENCE) {
+        Variable *var = get_variable(env, object_node->variable_name);
+        if (var && var->is_constant) {
+            return raise_error("Cannot mutate a constant matrix `%s`.\n",
+                               object_node->variable_name);
+        }
+    }
+
+    gc_push_root(&value);
+    InterpretResult matrix_res = interpret_node(object_node, env);
+    if (matrix_res.is_error) {
+        gc_pop_roots(1);
+        return matrix_res;
+    }
+    gc_push_root(&matrix_res.value);
+    InterpretResult row_res =
+        interpret_node(lhs_node->array_index_access.index, env);
+    if (row_res.is_error) {
+        gc_pop_roots(2);
+        return row_res;
+    }
+    if (matrix_res.value.type != TYPE_MATRIX) {
+        gc_pop_roots(2);
+        return raise_error("Only matrices take two indices, not %s.\n",
+                           literal_type_to_string(matrix_res.value.type));
+    }
+
+    MatrixValue *matrix = matrix_res.value.data.matrix;
+    size_t offset;
+    InterpretResult res =
+        matrix_element_offset(lhs_node, env, matrix, row_res.value, &offset);
+    gc_pop_roots(2);
+    if (res.is_error) {
+        return res;
     }
 
-    if (is_true) {
-        InterpretResult true_res = interpret_node(node->ternary.true_expr, env);
-        return true_res;
+    if (!matrix_writable(matrix)) {
+        return raise_error("Cannot modify a matrix in a parallel task; "
+                           "matrices created outside the task are "
+                           "read-only.\n");
+    }
+    if (value.type == TYPE_INTEGER) {
+        matrix->cells[offset] = (FLOAT_SIZE)value.data.integer;
+    } else if (value.type == TYPE_FLOAT) {
+        matrix->cells[offset] = value.data.floating_point;
     } else {
-        InterpretResult false_res =
-            interpret_node(node->ternary.false_expr, env);
-        return false_res;
+        return raise_error("Matrix elements must be numbers, not %s.\n",
+                           literal_type_to_string(value.type));
     }
+    return make_result(value, false, false);
 }
 
-InterpretResult interpret_try(ASTNode *node, Environment *env) {
-    if (!node || node->type != AST_TRY) {
-        return raise_error("Invalid AST node for try block.");
+/**
+ * @brief Applies `+`, `-`, `*` or `/` element by element, to two matrices of
+ * the same shape or to a matrix & a number.
+ */
+InterpretResult handle_matrix_operator(const char *op, LiteralValue left,
+                                       LiteralValue right) {
+    MatrixOp kind;
+    if (strcmp(op, "+") == 0) {
+        kind = MATRIX_ADD;
+    } else if (strcmp(op, "-") == 0) {
+        kind = MATRIX_SUBTRACT;
+    } else if (strcmp(op, "*") == 0) {
+        kind = MATRIX_MULTIPLY;
+    } else if (strcmp(op, "/") == 0) {
+        kind = MATRIX_DIVIDE;
+    } else {
+        return raise_error("Operator `%s` is not supported for matrices.\n",
+                           op);
     }
 
-    InterpretResult result = make_result(create_default_value(), false, false);
-    bool exception_occurred = false;
-    LiteralValue exception_value = create_default_value();
-
-    // Execute try block
-    ASTNode *stmt = node->try_block.try_block;
-    while (stmt) {
-        InterpretResult res = interpret_node(stmt, env);
-        if (res.is_error) {
-            // An exception has been thrown
-            exception_occurred = true;
-            exception_value = res.value;
-            break;
-        }
-        if (res.did_return) {
-            // Propagate return up
-            return res;
+    LiteralValue result = {.type = TYPE_MATRIX};
+    if (left.type == TYPE_MATRIX && right.type == TYPE_MATRIX) {
+        const MatrixValue *a = left.data.matrix;
+        const MatrixValue *b = right.data.matrix;
+        if (a->rows != b->rows || a->cols != b->cols) {
+            return raise_error("Matrix shapes don't match for `%s` (%zux%zu "
+                               "and %zux%zu).\n",
+                               op, a->rows, a->cols, b->rows, b->cols);
         }
-        stmt = stmt->next;
+        result.data.matrix = matrix_elementwise(kind, a, b);
+        return make_result(result, false, false);
     }
 
-    // If exception occurred, handle rescue blocks
-    if (exception_occurred) {
-        ASTCatchNode *catch = node->try_block.catch_blocks;
-        bool handled = false;
-
-        while (catch && !handled) {
-            Environment catch_env;
-            init_environment_with_parent(&catch_env, env);
-
-            // If there's an error variable, bind the exception to it
-            if (catch->error_variable) {
-                Variable error_var = {.variable_name =
-                                          strdup(catch->error_variable),
-                                      .value = exception_value,
-                                      .is_constant = false};
-                add_variable(&catch_env, error_var);
-            }
-
-            // Execute catch block
-            ASTNode *catch_stmt = catch->body;
-            while (catch_stmt) {
-                InterpretResult res = interpret_node(catch_stmt, &catch_env);
-                if (res.is_error) {
-                    // Nested exception, propagate
-                    free_environment(&catch_env);
-                    return res;
-                }
-                if (res.did_return) {
-                    // Propagate return up
-                    free_environment(&catch_env);
-                    return res;
-                }
-                catch_stmt = catch_stmt->next;
-            }
+    bool scalar_first = left.type != TYPE_MATRIX;
+    LiteralValue scalar = scalar_first ? left : right;
+    const MatrixValue *matrix =
+        scalar_first ? right.data.matrix : left.data.matrix;
+    if (scalar.type == TYPE_INTEGER) {
+        result.data.matrix = matrix_scalar(
+            kind, matrix, (FLOAT_SIZE)scalar.data.integer, scalar_first);
+    } else if (scalar.type == TYPE_FLOAT) {
+        result.data.matrix = matrix_scalar(
+            kind, matrix, scalar.data.floating_point, scalar_first);
+    } else {
+        return raise_error("Matrices can only be combined with matrices or "
+                           "numbers, not %s.\n",
+                           literal_type_to_string(scalar.type));
+    }
+    return make_result(result, false, false);
+}
 
-            handled = true; // Currently handling only one catch block
-            free_environment(&catch_env);
-            catch = catch->next;
-        }
+// ==================================================
+// BITSETS
+// ==================================================
 
-        if (!handled) {
-            // No rescue block handled the exception, propagate it
-            result.value = exception_value;
-            result.is_error = true;
-            return result;
-        }
+// Checks a bitset index (negative ones count from the end)
+InterpretResult bitset_position(const BitsetValue *bitset, LiteralValue index,
+                                size_t *position) {
+    if (index.type != TYPE_INTEGER) {
+        return raise_error("Bitset index must be an integer.\n");
     }
+    INT_SIZE bit = index.data.integer;
+    if (bit < 0) {
+        bit += (INT_SIZE)bitset->bits;
+    }
+    if (bit < 0 || (size_t)bit >= bitset->bits) {
+        return raise_error("Bitset index `" INT_FORMAT "` out of bounds.\n",
+                           index.data.integer);
+    }
+    *position = (size_t)bit;
+    return make_result(index, false, false);
+}
 
-    // Execute finish block if it exists
-    if (node->try_block.finally_block) {
-        ASTNode *finish_stmt = node->try_block.finally_block;
-        while (finish_stmt) {
-            InterpretResult res = interpret_node(finish_stmt, env);
-            if (res.is_error) {
-                // If an exception occurs in finish, prioritize it
-                return res;
-            }
-            if (res.did_return) {
-                // Propagate return up
-                return res;
-            }
-            finish_stmt = finish_stmt->next;
-        }
+// Applies `&`, `|` or `^` to two bitsets of the same size
+InterpretResult handle_bitset_operator(const char *op, LiteralValue left,
+                                       LiteralValue right) {
+    BitsetOp kind;
+    if (strcmp(op, "&") == 0) {
+        kind = BITSET_AND;
+    } else if (strcmp(op, "|") == 0) {
+        kind = BITSET_OR;
+    } else if (strcmp(op, "^") == 0) {
+        kind = BITSET_XOR;
+    } else {
+        return raise_error("Operator `%s` is not supported for bitsets.\n",
+                           op);
+    }
+    if (left.type != TYPE_BITSET || right.type != TYPE_BITSET) {
+        return raise_error("Bitsets can only be combined with bitsets.\n");
+    }
+    if (left.data.bitset->bits != right.data.bitset->bits) {
+        return raise_error("Bitset sizes don't match for `%s` (%zu and "
+                           "%zu).\n",
+                           op, left.data.bitset->bits,
+                           right.data.bitset->bits);
     }
 
-    // Normal execution
-    return result;
+    LiteralValue result = {.type = TYPE_BITSET};
+    result.data.bitset =
+        bitset_combine(kind, left.data.bitset, right.data.bitset);
+    return make_result(result, false, false);
 }
 
 // ==================================================
@@ -1799,135 +3076,111 @@ InterpretResult interpret_array_literal(ASTNode *node, Environment *env) {
         return raise_error("Expected AST_ARRAY_LITERAL node.\n");
     }
 
-    ArrayValue array;
-    array.count = 0;
-    array.capacity = node->array_literal.count > 4 ? node->array_literal.count
-                                                   : 4; // initial capacity
-    array.elements = malloc(array.capacity * sizeof(LiteralValue));
-    if (!array.elements) {
-        return raise_error("Memory allocation failed for array elements.\n");
-    }
+    // Keep the partially built array reachable while elements are evaluated
+    LiteralValue result;
+    result.type = TYPE_ARRAY;
+    result.data.array =
+        array_box(array_new(node->array_literal.count > ARRAY_MIN_CAPACITY
+                                ? node->array_literal.count
+                                : ARRAY_MIN_CAPACITY));
+    gc_push_root(&result);
 
     for (size_t i = 0; i < node->array_literal.count; i++) {
         ASTNode *element_node = node->array_literal.elements[i];
         InterpretResult elem_res = interpret_node(element_node, env);
         if (elem_res.is_error) {
-            // Free previously allocated elements if necessary
-            // For simplicity, assume no deep copies needed here
-            free(array.elements);
+            gc_pop_roots(1);
             return elem_res; // propagate the error
         }
 
         // Add the element to the array
-        if (array.count == array.capacity) {
-            size_t new_capacity = array.capacity * 2;
-            LiteralValue *new_elements =
-                realloc(array.elements, new_capacity * sizeof(LiteralValue));
-            if (!new_elements) {
-                free(array.elements);
-                return raise_error(
-                    "Memory allocation failed while expanding array.\n");
-            }
-            array.elements = new_elements;
-            array.capacity = new_capacity;
-        }
-
-        array.elements[array.count++] = elem_res.value;
+        array_push(result.data.array, elem_res.value);
     }
-
-    LiteralValue result;
-    result.type = TYPE_ARRAY;
-    result.data.array = array; // by value
+    gc_pop_roots(1);
 
     return make_result(result, false, false);
 }
 
-InterpretResult interpret_array_operation(ASTNode *node, Environment *env) {
-    if (node->type == AST_ASSIGNMENT) {
-        // Handle assignment-based array operations (append, prepend)
-        ASTNode *lhs_node = node->assignment.lhs;
-        ASTNode *rhs_node = node->assignment.rhs;
-
-        if (lhs_node->type != AST_ARRAY_OPERATION) {
-            return raise_error("Expected AST_ARRAY_OPERATION in assignment.\n");
-        }
-
-        const char *operator= lhs_node->array_operation.operator;
-        ASTNode *array_node = lhs_node->array_operation.array;
+/**
+ * @brief Appends (`xs[^+] = value`) or prepends (`xs[+^] = value`) an
+ * already evaluated value to an array variable.
+ *
+ * @param lhs_node The AST_ARRAY_OPERATION on the left of the assignment.
+ * @param env      The current environment.
+ * @param operand  The value being added.
+ * @return InterpretResult The modified array.
+ */
+InterpretResult interpret_array_push_assignment(ASTNode *lhs_node,
+                                                Environment *env,
+                                                LiteralValue operand) {
+    if (lhs_node->type != AST_ARRAY_OPERATION) {
+        return raise_error("Expected AST_ARRAY_OPERATION in assignment.\n");
+    }
 
-        if (array_node->type != AST_VARIABLE_REFERENCE) {
-            return raise_error("Array operation requires a variable reference "
-                               "as the array.\n");
-        }
+    const char *operator= lhs_node->array_operation.operator;
+    ASTNode *array_node = lhs_node->array_operation.array;
 
-        const char *var_name = array_node->variable_name;
+    if (array_node->type != AST_VARIABLE_REFERENCE) {
+        return raise_error("Array operation requires a variable reference "
+                           "as the array.\n");
+    }
 
-        // Retrieve variable from environment
-        Variable *var = get_variable(env, var_name);
-        if (!var) {
-            return raise_error("Undefined variable `%s`.\n", var_name);
-        }
+    const char *var_name = array_node->variable_name;
 
-        if (var->value.type != TYPE_ARRAY) {
-            return raise_error("Array operation requires an array variable.\n");
-        }
+    // Retrieve variable from environment
+    Variable *var = get_variable(env, var_name);
+    if (!var) {
+        return raise_error("Undefined variable `%s`.\n", var_name);
+    }
 
-        // Check for `const`-ness
-        if (var->is_constant) {
-            return raise_error("Cannot mutate a constant array `%s`.\n",
-                               var_name);
-        }
+    if (var->value.type != TYPE_ARRAY) {
+        return raise_error("Array operation requires an array variable.\n");
+    }
 
-        // Access the ArrayValue by reference
-        ArrayValue *array = &var->value.data.array;
+    // Check for `const`-ness
+    if (var->is_constant) {
+        return raise_error("Cannot mutate a constant array `%s`.\n",
+                           var_name);
+    }
+    if (variable_is_read_only(env, var_name)) {
+        return raise_error("Cannot modify `%s` in a parallel task; outer "
+                           "variables are read-only.\n",
+                           var_name);
+    }
+
+    ArrayValue *array = var->value.data.array;
+    if (!array_writable(array)) {
+        return raise_error("Cannot modify an array in a parallel task; "
+                           "arrays created outside the task are "
+                           "read-only.\n");
+    }
+
+    // Perform operation based on operator
+    if (strcmp(operator, "^+") == 0) { // Append
+        array_push(array, operand);
+        // Return the modified array
+        return make_result(var->value, false, false);
+    } else if (strcmp(operator, "+^") == 0) { // Prepend
+        array_prepend(array, operand);
+        // Return the modified array
+        return make_result(var->value, false, false);
+    } else {
+        return raise_error(
+            "Unsupported array operation operator `%s` in assignment.\n",
+            operator);
+    }
+}
 
-        // Interpret the operand (RHS of assignment)
-        InterpretResult operand_res = interpret_node(rhs_node, env);
+InterpretResult interpret_array_operation(ASTNode *node, Environment *env) {
+    if (node->type == AST_ASSIGNMENT) {
+        // Handle assignment-based array operations (append, prepend)
+        InterpretResult operand_res =
+            interpret_node(node->assignment.rhs, env);
         if (operand_res.is_error) {
             return operand_res;
         }
-
-        // Perform operation based on operator
-        if (strcmp(operator, "^+") == 0) { // Append
-            if (array->count == array->capacity) {
-                size_t new_capacity = array->capacity * 2;
-                LiteralValue *new_elements = realloc(
-                    array->elements, new_capacity * sizeof(LiteralValue));
-                if (!new_elements) {
-                    return raise_error(
-                        "Memory allocation failed while expanding array.\n");
-                }
-                array->elements = new_elements;
-                array->capacity = new_capacity;
-            }
-            array->elements[array->count++] = operand_res.value;
-            // Return the modified array
-            return make_result(var->value, false, false);
-        } else if (strcmp(operator, "+^") == 0) { // Prepend
-            if (array->count == array->capacity) {
-                size_t new_capacity = array->capacity * 2;
-                LiteralValue *new_elements = realloc(
-                    array->elements, new_capacity * sizeof(LiteralValue));
-                if (!new_elements) {
-                    return raise_error(
-                        "Memory allocation failed while expanding array.\n");
-                }
-                array->elements = new_elements;
-                array->capacity = new_capacity;
-            }
-
-            // Shift elements to the right
-            memmove(&array->elements[1], &array->elements[0],
-                    array->count * sizeof(LiteralValue));
-            array->elements[0] = operand_res.value;
-            array->count++;
-            // Return the modified array
-            return make_result(var->value, false, false);
-        } else {
-            return raise_error(
-                "Unsupported array operation operator `%s` in assignment.\n",
-                operator);
-        }
+        return interpret_array_push_assignment(node->assignment.lhs, env,
+                                               operand_res.value);
     } else if (node->type == AST_ARRAY_OPERATION) {
         // Handle standalone array operations (remove last, remove first)
         const char *operator= node->array_operation.operator;
@@ -1955,27 +3208,31 @@ InterpretResult interpret_array_operation(ASTNode *node, Environment *env) {
             return raise_error("Cannot mutate a constant array `%s`.\n",
                                var_name);
         }
+        if (variable_is_read_only(env, var_name)) {
+            return raise_error("Cannot modify `%s` in a parallel task; outer "
+                               "variables are read-only.\n",
+                               var_name);
+        }
 
-        // Access the ArrayValue by reference
-        ArrayValue *array = &var->value.data.array;
+        ArrayValue *array = var->value.data.array;
+        if (!array_writable(array)) {
+            return raise_error("Cannot modify an array in a parallel task; "
+                               "arrays created outside the task are "
+                               "read-only.\n");
+        }
 
         // Perform operation based on operator
         if (strcmp(operator, "^-") == 0) { // Remove Last Element
             if (array->count == 0) {
                 return raise_error("Cannot remove from an empty array.\n");
             }
-            LiteralValue removed = array->elements[array->count - 1];
-            array->count--;
+            LiteralValue removed = array_pop(array);
             return make_result(removed, false, false);
         } else if (strcmp(operator, "-^") == 0) { // Remove First Element
             if (array->count == 0) {
                 return raise_error("Cannot remove from an empty array.\n");
             }
-            LiteralValue removed = array->elements[0];
-            // Shift elements to the left
-            memmove(&array->elements[0], &array->elements[1],
-                    (array->count - 1) * sizeof(LiteralValue));
-            array->count--;
+            LiteralValue removed = array_shift(array);
             return make_result(removed, false, false);
         } else {
             return raise_error(
@@ -2008,9 +3265,13 @@ InterpretResult interpret_array_index_access(ASTNode *node, Environment *env) {
         return array_res;
     }
 
+    // Keep the operand reachable while the index is evaluated
+    gc_push_root(&array_res.value);
+    InterpretResult index_res = interpret_node(index_node, env);
+    gc_pop_roots(1);
+
     // First, handle the case where the operand is a string
     if (array_res.value.type == TYPE_STRING) {
-        InterpretResult index_res = interpret_node(index_node, env);
         if (index_res.is_error) {
             return index_res;
         }
@@ -2018,8 +3279,8 @@ InterpretResult interpret_array_index_access(ASTNode *node, Environment *env) {
             return raise_error("String index must be an integer.\n");
         }
         INT_SIZE idx = index_res.value.data.integer;
-        const char *str = array_res.value.data.string;
-        size_t len = strlen(str);
+        const char *str = array_res.value.data.string->bytes;
+        size_t len = array_res.value.data.string->length;
 
         // Handle negative indices (e.g., `-1` refers to the last character)
         if (idx < 0) {
@@ -2030,31 +3291,61 @@ InterpretResult interpret_array_index_access(ASTNode *node, Environment *env) {
                                idx);
         }
 
-        // Extract the character at the specified index
-        char single[2];
-        single[0] = str[idx];
-        single[1] = '\0';
-
-        // Wrap the character into a new LiteralValue (string)
+        // Wrap the character at the specified index into a new string
         LiteralValue element;
         element.type = TYPE_STRING;
-        element.data.string = strdup(single);
-        if (!element.data.string) {
-            return raise_error(
-                "Memory allocation failed in string indexing.\n");
-        }
+        element.data.string = fl_string_from_bytes(&str[idx], 1);
         return make_result(element, false, false);
     }
 
+    // Matrices take one index for a row or two for an element
+    if (array_res.value.type == TYPE_MATRIX) {
+        if (index_res.is_error) {
+            return index_res;
+        }
+        return interpret_matrix_index_access(node, env, array_res.value,
+                                             index_res.value);
+    }
+    if (node->array_index_access.column) {
+        return raise_error("Only matrices take two indices, not %s.\n",
+                           literal_type_to_string(array_res.value.type));
+    }
+
+    // Bitsets test a bit
+    if (array_res.value.type == TYPE_BITSET) {
+        if (index_res.is_error) {
+            return index_res;
+        }
+        size_t position;
+        InterpretResult r = bitset_position(array_res.value.data.bitset,
+                                            index_res.value, &position);
+        if (r.is_error) {
+            return r;
+        }
+        LiteralValue bit = {.type = TYPE_BOOLEAN};
+        bit.data.boolean = bitset_test(array_res.value.data.bitset, position);
+        return make_result(bit, false, false);
+    }
+
+    // Maps look up their key
+    if (array_res.value.type == TYPE_MAP) {
+        if (index_res.is_error) {
+            return index_res;
+        }
+        LiteralValue value;
+        if (!map_get(array_res.value.data.map, index_res.value, &value)) {
+            return map_key_error(index_res.value);
+        }
+        return make_result(value, false, false);
+    }
+
     // Otherwise, expect the operand to be an array
     if (array_res.value.type != TYPE_ARRAY) {
         return raise_error(
-            "Index access requires an array or string operand.\n");
+            "Index access requires an array, map or string operand.\n");
     }
-    ArrayValue *array = &array_res.value.data.array;
+    ArrayValue *array = array_res.value.data.array;
 
-    // Interpret the index expression
-    InterpretResult index_res = interpret_node(index_node, env);
     if (index_res.is_error) {
         return index_res;
     }
@@ -2073,7 +3364,7 @@ InterpretResult interpret_array_index_access(ASTNode *node, Environment *env) {
     }
 
     // Access the element and return it
-    LiteralValue element = array->elements[index];
+    LiteralValue element = array_get(array, index);
     return make_result(element, false, false);
 }
 
@@ -2082,50 +3373,23 @@ InterpretResult interpret_array_index_access(ASTNode *node, Environment *env) {
  *
  * @param node The AST node representing the LHS of the assignment.
  * @param env The current execution environment.
- * @param indices Pointer to store the array of indices.
- * @param count Pointer to store the number of indices collected.
+ * @param indices Receives the index values, outermost first (so `a[i][j]`
+ * gives `[j, i]`). The caller keeps it rooted.
  * @return InterpretResult indicating success or error.
  */
 InterpretResult collect_indices(ASTNode *node, Environment *env,
-                                INT_SIZE **indices, size_t *count) {
-    size_t capacity = 4;
-    *indices = malloc(capacity * sizeof(INT_SIZE));
-    if (!(*indices)) {
-        return raise_error("Memory allocation failed.\n");
-    }
-    *count = 0;
-
+                                ArrayValue *indices) {
     ASTNode *current_node = node;
 
     while (current_node->type == AST_ARRAY_INDEX_ACCESS) {
         ASTNode *index_node = current_node->array_index_access.index;
 
-        // Interpret the index
+        // Interpret the index (an integer for arrays, any key for maps)
         InterpretResult index_res = interpret_node(index_node, env);
         if (index_res.is_error) {
-            free(*indices);
             return index_res;
         }
-
-        if (index_res.value.type != TYPE_INTEGER) {
-            free(*indices);
-            return raise_error("Array index must be an integer.\n");
-        }
-
-        INT_SIZE index = index_res.value.data.integer;
-
-        // Add to the indices array
-        if (*count == capacity) {
-            capacity *= 2;
-            INT_SIZE *temp = realloc(*indices, capacity * sizeof(INT_SIZE));
-            if (!temp) {
-                free(*indices);
-                return raise_error("Memory allocation failed.\n");
-            }
-            *indices = temp;
-        }
-
-        (*indices)[(*count)++] = index;
+        array_push(indices, index_res.value);
 
         // Move to the next array node
         current_node = current_node->array_index_access.array;
@@ -2133,7 +3397,6 @@ InterpretResult collect_indices(ASTNode *node, Environment *env,
 
     // After traversal, current_node should be AST_VARIABLE_REFERENCE
     if (current_node->type != AST_VARIABLE_REFERENCE) {
-        free(*indices);
         return raise_error("Index assignment requires a variable reference.\n");
     }
 
@@ -2142,8 +3405,58 @@ InterpretResult collect_indices(ASTNode *node, Environment *env,
         false);
 }
 
+// Resolves one level of a nested index assignment to the slot it names
+InterpretResult index_assignment_slot(LiteralValue *container,
+                                      LiteralValue index,
+                                      LiteralValue **slot) {
+    if (container->type == TYPE_MAP) {
+        if (!map_writable(container->data.map)) {
+            return raise_error("Cannot modify a map in a parallel task; maps "
+                               "created outside the task are read-only.\n");
+        }
+        *slot = map_slot(container->data.map, index);
+        if (!*slot) {
+            return map_key_error(index);
+        }
+        return make_result(index, false, false);
+    }
+
+    if (container->type != TYPE_ARRAY) {
+        return raise_error("Cannot index into a non-array, non-map element "
+                           "in nested assignment.\n");
+    }
+    if (index.type != TYPE_INTEGER) {
+        return raise_error("Array index must be an integer.\n");
+    }
+
+    ArrayValue *array = container->data.array;
+    if (!array_writable(array)) {
+        return raise_error("Cannot modify an array in a parallel task; arrays "
+                           "created outside the task are read-only.\n");
+    }
+    INT_SIZE position = index.data.integer;
+
+    // Handle negative indices
+    if (position < 0) {
+        position = (INT_SIZE)array->count + position;
+    }
+    if (position < 0 || (size_t)position >= array->count) {
+        return raise_error("Array index `" INT_FORMAT "` out of bounds.\n",
+                           position);
+    }
+
+    array_make_writable(array);
+    *slot = array_slot(array, (size_t)position);
+    if (!*slot) {
+        return raise_error("Cannot index into a non-array, non-map element "
+                           "in nested assignment.\n");
+    }
+    return make_result(index, false, false);
+}
+
 /**
- * @brief Handles assignments to array indices, supporting nested assignments.
+ * @brief Handles assignments to array indices & map keys, supporting nested
+ * assignments like `grid[1][2] = x` or `totals["a"][0] = x`.
  *
  * @param node The AST node representing the LHS of the assignment.
  * @param env The current execution environment.
@@ -2153,17 +3466,19 @@ InterpretResult collect_indices(ASTNode *node, Environment *env,
 InterpretResult interpret_array_index_assignment(ASTNode *node,
                                                  Environment *env,
                                                  LiteralValue new_value) {
-    INT_SIZE *indices = NULL;
-    size_t count = 0;
-
-    // Collect the indices from the AST
-    InterpretResult res = collect_indices(node, env, &indices, &count);
+    // Collect the indices from the AST (index expressions may allocate)
+    LiteralValue indices = {.type = TYPE_ARRAY,
+                            .data.array = array_box(array_new(0))};
+    gc_push_root(&new_value);
+    gc_push_root(&indices);
+    InterpretResult res = collect_indices(node, env, indices.data.array);
+    gc_pop_roots(2);
     if (res.is_error) {
         return res;
     }
 
+    size_t count = indices.data.array->count;
     if (count == 0) {
-        free(indices);
         return raise_error("No indices provided for array assignment.\n");
     }
 
@@ -2176,65 +3491,95 @@ InterpretResult interpret_array_index_assignment(ASTNode *node,
     const char *var_name = current_node->variable_name;
     Variable *var = get_variable(env, var_name);
     if (!var) {
-        free(indices);
         return raise_error("Undefined variable `%s`.\n", var_name);
     }
 
     if (var->is_constant) {
-        free(indices);
-        return raise_error("Cannot mutate a constant array `%s`.\n", var_name);
+        return raise_error("Cannot mutate a constant %s `%s`.\n",
+                           literal_type_to_string(var->value.type), var_name);
     }
-
-    if (var->value.type != TYPE_ARRAY) {
-        free(indices);
-        return raise_error("Assignment requires an array variable.\n");
+    if (variable_is_read_only(env, var_name)) {
+        return raise_error("Cannot modify `%s` in a parallel task; outer "
+                           "variables are read-only.\n",
+                           var_name);
     }
 
-    ArrayValue *current_array = &var->value.data.array;
-
-    // Traverse the array using indices up to the penultimate index
-    for (size_t i = 0; i < count - 1; i++) {
-        INT_SIZE index = indices[i];
+    if (var->value.type != TYPE_ARRAY && var->value.type != TYPE_MAP &&
+        var->value.type != TYPE_BITSET) {
+        return raise_error(
+            "Assignment requires an array, map or bitset variable.\n");
+    }
 
-        // Handle negative indices
-        if (index < 0) {
-            index = (INT_SIZE)current_array->count + index;
+    // Walk down from the variable (the innermost index is collected last)
+    LiteralValue *container = &var->value;
+    for (size_t i = count - 1; i > 0; i--) {
+        res = index_assignment_slot(
+            container, array_get(indices.data.array, i), &container);
+        if (res.is_error) {
+            return res;
         }
+    }
 
-        if (index < 0 || (size_t)index >= current_array->count) {
-            free(indices);
-            return raise_error("Array index `" INT_FORMAT "` out of bounds.\n",
-                               index);
+    LiteralValue final_index = array_get(indices.data.array, 0);
+    if (container->type == TYPE_BITSET) {
+        BitsetValue *bitset = container->data.bitset;
+        if (!bitset_writable(bitset)) {
+            return raise_error("Cannot modify a bitset in a parallel task; "
+                               "bitsets created outside the task are "
+                               "read-only.\n");
         }
-
-        LiteralValue *elem = &current_array->elements[index];
-        if (elem->type != TYPE_ARRAY) {
-            free(indices);
-            return raise_error(
-                "Cannot assign to a non-array element in nested assignment.\n");
+        if (new_value.type != TYPE_BOOLEAN) {
+            return raise_error("Bitset bits must be set to True or False.\n");
         }
-
-        current_array = &elem->data.array;
+        size_t position;
+        res = bitset_position(bitset, final_index, &position);
+        if (res.is_error) {
+            return res;
+        }
+        bitset_assign(bitset, position, new_value.data.boolean);
+        return make_result(new_value, false, false);
+    }
+    if (container->type == TYPE_MAP) {
+        if (!map_writable(container->data.map)) {
+            return raise_error("Cannot modify a map in a parallel task; maps "
+                               "created outside the task are read-only.\n");
+        }
+        if (!map_key_supported(final_index)) {
+            return raise_error("Map keys must be strings, integers, floats or "
+                               "booleans, not %s.\n",
+                               literal_type_to_string(final_index.type));
+        }
+        map_set(container->data.map, final_index, new_value);
+        return make_result(new_value, false, false);
     }
 
-    // Handle last index for assignment
-    INT_SIZE final_index = indices[count - 1];
+    // The last index must name an existing array element
+    if (container->type != TYPE_ARRAY) {
+        return raise_error("Cannot index into a non-array, non-map element "
+                           "in nested assignment.\n");
+    }
+    if (final_index.type != TYPE_INTEGER) {
+        return raise_error("Array index must be an integer.\n");
+    }
+    ArrayValue *current_array = container->data.array;
+    if (!array_writable(current_array)) {
+        return raise_error("Cannot modify an array in a parallel task; arrays "
+                           "created outside the task are read-only.\n");
+    }
+    INT_SIZE position = final_index.data.integer;
 
     // Handle negative indices
-    if (final_index < 0) {
-        final_index = (INT_SIZE)current_array->count + final_index;
+    if (position < 0) {
+        position = (INT_SIZE)current_array->count + position;
     }
 
-    if (final_index < 0 || (size_t)final_index >= current_array->count) {
-        free(indices);
+    if (position < 0 || (size_t)position >= current_array->count) {
         return raise_error("Array index `" INT_FORMAT "` out of bounds.\n",
-                           final_index);
+                           position);
     }
 
     // Assign new value
-    current_array->elements[final_index] = new_value;
-
-    free(indices);
+    array_set(current_array, (size_t)position, new_value);
 
     return make_result(new_value, false, false);
 }
@@ -2266,9 +3611,6 @@ InterpretResult interpret_array_slice_access(ASTNode *node, Environment *env) {
     }
 
     ASTNode *operand_node = node->array_slice_access.array;
-    ASTNode *start_node = node->array_slice_access.start;
-    ASTNode *end_node = node->array_slice_access.end;
-    ASTNode *step_node = node->array_slice_access.step;
 
     // Interpret the operand (array or string)
     InterpretResult operand_res = interpret_node(operand_node, env);
@@ -2276,15 +3618,35 @@ InterpretResult interpret_array_slice_access(ASTNode *node, Environment *env) {
         return operand_res;
     }
 
+    // Keep the operand reachable while the bounds are evaluated
+    gc_push_root(&operand_res.value);
+    InterpretResult slice_res = slice_operand(node, env, operand_res.value);
+    gc_pop_roots(1);
+    return slice_res;
+}
+
+/**
+ * @brief Evaluates the slice bounds & copies the selected elements/characters
+ * out of an already evaluated operand.
+ */
+InterpretResult slice_operand(ASTNode *node, Environment *env,
+                              LiteralValue operand) {
+    ASTNode *start_node = node->array_slice_access.start;
+    ASTNode *end_node = node->array_slice_access.end;
+    ASTNode *step_node = node->array_slice_access.step;
+    InterpretResult operand_res = make_result(operand, false, false);
+
     bool isString = (operand_res.value.type == TYPE_STRING);
     size_t total_count;
     if (isString) {
-        total_count = strlen(operand_res.value.data.string);
+        total_count = operand_res.value.data.string->length;
     } else if (operand_res.value.type == TYPE_ARRAY) {
-        total_count = operand_res.value.data.array.count;
+        total_count = operand_res.value.data.array->count;
+    } else if (operand_res.value.type == TYPE_MATRIX) {
+        total_count = operand_res.value.data.matrix->rows;
     } else {
         return raise_error(
-            "Slice access requires an array or string operand.\n");
+            "Slice access requires an array, matrix or string operand.\n");
     }
 
     debug_print_int("Operand has %zu elements/characters.\n", total_count);
@@ -2355,8 +3717,8 @@ InterpretResult interpret_array_slice_access(ASTNode *node, Environment *env) {
                     start_val, end_val, step_val);
 
     // Convert to integer indices
-    INT_SIZE start_index = (INT_SIZE)floor(start_val);
-    INT_SIZE end_index = (INT_SIZE)ceil(end_val);
+    INT_SIZE start_index = (INT_SIZE)FLOAT_FLOOR(start_val);
+    INT_SIZE end_index = (INT_SIZE)FLOAT_CEIL(end_val);
     INT_SIZE step = (INT_SIZE)step_val;
 
     // Adjust negative indices:
@@ -2411,76 +3773,50 @@ InterpretResult interpret_array_slice_access(ASTNode *node, Environment *env) {
         }
     }
 
+    // A negative step stops at the first element, which can come before
+    // `end_index`
+    if (step < 0 && slice_count > 0) {
+        size_t reachable =
+            start_index < 0 ? 0 : (size_t)(start_index / -step) + 1;
+        if (reachable < slice_count) {
+            slice_count = reachable;
+        }
+    }
+    size_t start = slice_count ? (size_t)start_index : 0;
+
     debug_print_int("Calculated slice_count=%zu\n", slice_count);
 
     // Branch based on operand type
-    if (!isString) {
-        // Operand is an array
-        ArrayValue slice;
-        slice.count = 0;
-        slice.capacity = slice_count > 4 ? slice_count : 4;
-        slice.elements = malloc(slice.capacity * sizeof(LiteralValue));
-        if (!slice.elements) {
-            return raise_error("Memory allocation failed for array slice.\n");
-        }
-
-        // For arrays, use the array field
-        for (INT_SIZE i = start_index;
-             (step > 0 && i < end_index) || (step < 0 && i > end_index);
-             i += step) {
-            if (i < 0 || (size_t)i >= total_count) {
-                break;
-            }
-            if (slice.count == slice.capacity) {
-                size_t new_capacity = slice.capacity * 2;
-                LiteralValue *new_elements = realloc(
-                    slice.elements, new_capacity * sizeof(LiteralValue));
-                if (!new_elements) {
-                    free(slice.elements);
-                    return raise_error("Memory allocation failed while "
-                                       "expanding slice array.\n");
-                }
-                slice.elements = new_elements;
-                slice.capacity = new_capacity;
-            }
-            slice.elements[slice.count++] =
-                operand_res.value.data.array.elements[i];
-        }
-
+    if (operand_res.value.type == TYPE_MATRIX) {
+        // Matrix slices select rows (copied, since matrices are references)
+        LiteralValue result;
+        result.type = TYPE_MATRIX;
+        result.data.matrix = matrix_select_rows(operand_res.value.data.matrix,
+                                                start, step, slice_count);
+        return make_result(result, false, false);
+    } else if (!isString) {
+        // Operand is an array; the slice is a view onto its buffer
         LiteralValue result;
         result.type = TYPE_ARRAY;
-        result.data.array = slice;
+        result.data.array = array_box(array_slice(
+            operand_res.value.data.array, start, step, slice_count));
         return make_result(result, false, false);
     } else {
         // Operand is a string
-        const char *str = operand_res.value.data.string;
-        size_t str_len = strlen(str);
-
-        // Compute the number of characters to extract
-        size_t char_count = 0;
-        for (INT_SIZE i = start_index;
-             (step > 0 && i < end_index) || (step < 0 && i > end_index);
-             i += step) {
-            if (i < 0 || (size_t)i >= str_len) {
-                break;
-            }
-            char_count++;
-        }
+        FlavorString *str = operand_res.value.data.string;
+        FlavorString *sub;
 
-        char *sub = malloc(char_count + 1);
-        if (!sub) {
-            return raise_error("Memory allocation failed for string slice.\n");
-        }
-        size_t pos = 0;
-        for (INT_SIZE i = start_index;
-             (step > 0 && i < end_index) || (step < 0 && i > end_index);
-             i += step) {
-            if (i < 0 || (size_t)i >= str_len) {
-                break;
+        if (step == 1 && slice_count == str->length) {
+            sub = str; // Strings are immutable, so the whole one can be shared
+        } else if (step == 1) {
+            sub = fl_string_from_bytes(str->bytes + start, slice_count);
+        } else {
+            sub = gc_alloc_string(slice_count);
+            for (size_t i = 0; i < slice_count; i++) {
+                sub->bytes[i] =
+                    str->bytes[(INT_SIZE)start + (INT_SIZE)i * step];
             }
-            sub[pos++] = str[i];
         }
-        sub[pos] = '\0';
 
         LiteralValue result;
         result.type = TYPE_STRING;
@@ -2497,6 +3833,9 @@ void merge_module_exports(Environment *dest_env, Environment *export_env) {
         // Check if it's a variable in `export_env`
         Variable *var = get_variable(export_env, exported_name);
         if (var) {
+            if (var->value.type == TYPE_STRING) {
+                fl_string_freeze(var->value.data.string);
+            }
             add_variable(dest_env, *var);
         }
 
@@ -2575,8 +3914,15 @@ InterpretResult interpret_import(ASTNode *node, Environment *env) {
     Environment module_env;
     init_environment_with_parent(&module_env, env);
 
-    // Interpret module
+    // Interpret module (which isn't part of any function being run)
+    TailCall *outer_tail = current_tail_call;
+    current_tail_call = NULL;
     interpret_program(module_ast, &module_env);
+    current_tail_call = outer_tail;
+
+    // The module's functions outlive it in the module cache but can no longer
+    // be reached from here, so calls made inside it mustn't find them again
+    functions_changed();
     free_ast(module_ast);
 
     // Store module's exported symbols in cache
@@ -2619,6 +3965,9 @@ InterpretResult interpret_export(ASTNode *node, Environment *env) {
     case AST_FUNCTION_DECLARATION:
         register_export(env, node->export.decl->function_declaration.name);
         break;
+    case AST_RECORD_DECLARATION:
+        register_export(env, node->export.decl->record_declaration.name);
+        break;
     default:
         fprintf(stderr, "Warning: Export is a non-declaration type");
         break;
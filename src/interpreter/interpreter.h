@@ -3,9 +3,19 @@
 
 #include "../shared/ast_types.h"
 #include "../shared/data_types.h"
+#include "array.h"
+#include "bindings.h"
 #include "builtins.h"
+#include "call_stack.h"
+#include "flavor_string.h"
+#include "free_names.h"
+#include "gc.h"
+#include "hoist.h"
+#include "inliner.h"
 #include "interpreter_types.h"
+#include "memo.h"
 #include "module_cache.h"
+#include "parallel.h"
 #include "utils.h"
 #include <errno.h>
 #include <limits.h>
@@ -14,30 +24,122 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Longest `s = s + a + b ...` chain that is appended in place
+#define MAX_APPEND_OPERANDS 16
+
+ControlFlow interpret(ASTNode *node, Environment *env, LiteralValue *out);
 InterpretResult interpret_node(ASTNode *node, Environment *env);
-InterpretResult interpret_literal(ASTNode *node);
-InterpretResult interpret_variable_reference(ASTNode *node, Environment *env);
+ControlFlow interpret_block(ASTNode *stmt, Environment *env,
+                            LiteralValue *out);
+ControlFlow interpret_loop_body(ASTNode *stmt, Environment *env,
+                                LiteralValue *out);
+ControlFlow interpret_literal(ASTNode *node, LiteralValue *out);
+ControlFlow interpret_variable_reference(ASTNode *node, Environment *env,
+                                         LiteralValue *out);
 InterpretResult interpret_var_declaration(ASTNode *node, Environment *env);
 InterpretResult interpret_const_declaration(ASTNode *node, Environment *env);
-InterpretResult interpret_assignment(ASTNode *node, Environment *env);
-InterpretResult interpret_binary_op(ASTNode *node, Environment *env);
-InterpretResult interpret_conditional(ASTNode *node, Environment *env);
-InterpretResult interpret_while_loop(ASTNode *node, Environment *env);
-InterpretResult interpret_for_loop(ASTNode *node, Environment *env);
-InterpretResult interpret_switch(ASTNode *node, Environment *env);
+ControlFlow interpret_assignment(ASTNode *node, Environment *env,
+                                 LiteralValue *out);
+bool interpret_string_append(ASTNode *node, Environment *env,
+                             InterpretResult *out);
+const char *concatenation_text(LiteralValue value, char *buffer,
+                               size_t buffer_size, size_t *length);
+ControlFlow interpret_binary_op(ASTNode *node, Environment *env,
+                                LiteralValue *out);
+ControlFlow interpret_conditional(ASTNode *node, Environment *env,
+                                  LiteralValue *out);
+ControlFlow interpret_while_loop(ASTNode *node, Environment *env,
+                                 LiteralValue *out);
+ControlFlow interpret_while_iterations(ASTNode *node, Environment *env,
+                                       LiteralValue *out);
+ControlFlow interpret_for_loop(ASTNode *node, Environment *env,
+                               LiteralValue *out);
+ControlFlow interpret_for_iterations(ASTNode *node, Environment *env,
+                                     LiteralValue *out);
+ControlFlow interpret_invariant(ASTNode *node, Environment *env,
+                                LiteralValue *out);
+InterpretResult interpret_parallel_for_loop(ASTNode *node, Environment *env);
+InterpretResult parallel_loop_bound(ASTNode *expr, Environment *env,
+                                    const char *what, INT_SIZE *out);
+InterpretResult parallel_loop_initial(ASTReduction *reduction,
+                                      Environment *env, LiteralValue *out);
+InterpretResult parallel_loop_merge(ReductionKind kind, LiteralValue total,
+                                    LiteralValue partial);
+ControlFlow interpret_switch(ASTNode *node, Environment *env,
+                             LiteralValue *out);
 InterpretResult interpret_function_declaration(ASTNode *node, Environment *env);
-InterpretResult interpret_function_call(ASTNode *node, Environment *env);
-InterpretResult interpret_unary_op(ASTNode *node, Environment *env);
-InterpretResult evaluate_unary_operator(const char *op,
-                                        InterpretResult operand_res);
-InterpretResult interpret_ternary(ASTNode *node, Environment *env);
-InterpretResult call_user_defined_function(Function *func_ref,
-                                           ASTNode *call_node,
-                                           Environment *env);
-InterpretResult interpret_try(ASTNode *node, Environment *env);
+ControlFlow interpret_function_call(ASTNode *node, Environment *env,
+                                    LiteralValue *out);
+ControlFlow resolve_function_call(ASTNode *node, Environment *env,
+                                  Function **func, LiteralValue *out);
+ControlFlow call_function(Function *func, ASTNode *node, Environment *env,
+                          LiteralValue *out);
+ASTNode *inlined_call_body(ASTNode *node, Function *func, Environment *env);
+ControlFlow interpret_inline_call(ASTNode *node, ASTNode *inlined,
+                                  Environment *env, Environment *body_env,
+                                  LiteralValue *out);
+InterpretResult call_builtin_function(Function *func, ASTNode *node,
+                                      Environment *env);
+ControlFlow interpret_unary_op(ASTNode *node, Environment *env,
+                               LiteralValue *out);
+InterpretResult evaluate_unary_operator(const char *op, LiteralValue operand);
+ControlFlow interpret_ternary(ASTNode *node, Environment *env,
+                              LiteralValue *out);
+ControlFlow call_user_defined_function(Function *func_ref, ASTNode *call_node,
+                                       Environment *env, LiteralValue *out);
+ControlFlow bind_arguments(Function *func_ref, ASTNode *call_node,
+                           Environment *env, Environment *local_env,
+                           LiteralValue *out);
+ControlFlow execute_function_body(Function *func_ref, Environment *local_env,
+                                  LiteralValue *out);
+ControlFlow execute_memoized_body(Function *func_ref, Environment *local_env,
+                                  LiteralValue *out);
+bool function_outlives_frame(Function *func, Environment *env,
+                             Environment *frame);
+bool tail_call_keeps_scope(Function *func, Environment *env,
+                           Environment *frame);
+ControlFlow interpret_tail_call(ASTNode *node, Environment *env,
+                                LiteralValue *out);
+InterpretResult call_function_with_values(Function *func_ref,
+                                          LiteralValue *args, size_t num_args,
+                                          Environment *env);
+ControlFlow interpret_try(ASTNode *node, Environment *env, LiteralValue *out);
 InterpretResult interpret_import(ASTNode *node, Environment *env);
 InterpretResult interpret_export(ASTNode *node, Environment *env);
 
+// Records
+InterpretResult interpret_record_declaration(ASTNode *node, Environment *env);
+InterpretResult interpret_record_construction(ASTNode *node,
+                                              const RecordType *type,
+                                              Environment *env);
+InterpretResult field_access_record(ASTNode *node, Environment *env,
+                                    size_t *slot);
+InterpretResult interpret_field_access(ASTNode *node, Environment *env);
+InterpretResult interpret_field_assignment(ASTNode *lhs_node, Environment *env,
+                                           LiteralValue value);
+
+// Maps
+InterpretResult interpret_map_literal(ASTNode *node, Environment *env);
+InterpretResult map_key_error(LiteralValue key);
+
+// Bitsets
+InterpretResult bitset_position(const BitsetValue *bitset, LiteralValue index,
+                                size_t *position);
+InterpretResult handle_bitset_operator(const char *op, LiteralValue left,
+                                       LiteralValue right);
+
+// Matrices
+InterpretResult matrix_element_offset(ASTNode *node, Environment *env,
+                                      const MatrixValue *matrix,
+                                      LiteralValue row, size_t *offset);
+InterpretResult interpret_matrix_index_access(ASTNode *node, Environment *env,
+                                              LiteralValue operand,
+                                              LiteralValue index);
+InterpretResult interpret_matrix_assignment(ASTNode *lhs_node, Environment *env,
+                                            LiteralValue value);
+InterpretResult handle_matrix_operator(const char *op, LiteralValue left,
+                                       LiteralValue right);
+
 // Arrays
 typedef struct {
     ArrayValue *array; // Pointer to target array where assignment occurs
@@ -45,13 +147,21 @@ typedef struct {
 } AssignmentTargetInfo;
 InterpretResult interpret_array_literal(ASTNode *node, Environment *env);
 InterpretResult interpret_array_operation(ASTNode *node, Environment *env);
+InterpretResult interpret_array_push_assignment(ASTNode *lhs_node,
+                                                Environment *env,
+                                                LiteralValue operand);
 InterpretResult collect_indices(ASTNode *node, Environment *env,
-                                INT_SIZE **indices, size_t *count);
+                                ArrayValue *indices);
+InterpretResult index_assignment_slot(LiteralValue *container,
+                                      LiteralValue index,
+                                      LiteralValue **slot);
 InterpretResult interpret_array_index_access(ASTNode *node, Environment *env);
 InterpretResult interpret_array_index_assignment(ASTNode *node,
                                                  Environment *env,
                                                  LiteralValue new_value);
 InterpretResult interpret_array_slice_access(ASTNode *node, Environment *env);
+InterpretResult slice_operand(ASTNode *node, Environment *env,
+                              LiteralValue operand);
 
 // Interpret program
 void interpret_program(ASTNode *program, Environment *env);
@@ -59,6 +169,7 @@ void interpret_program(ASTNode *program, Environment *env);
 // Helpers
 LiteralValue create_default_value(void);
 Variable *get_variable(Environment *env, const char *variable_name);
+bool variable_is_read_only(Environment *env, const char *variable_name);
 InterpretResult add_variable(Environment *env, Variable var);
 ASTFunctionParameter *copy_function_parameters(ASTFunctionParameter *params);
 void merge_module_exports(Environment *dest_env, Environment *export_env);
@@ -1,9 +1,12 @@
 #ifndef INTERPRETER_TYPES_H
 #define INTERPRETER_TYPES_H
 
+#include "../shared/data_types.h"
 #include <math.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,32 +25,159 @@ typedef enum {
     TYPE_STRING,
     TYPE_ARRAY,
     TYPE_FUNCTION,
-    TYPE_ERROR
+    TYPE_ERROR,
+    TYPE_BUILDER,
+    TYPE_MAP,
+    TYPE_HEAP,
+    TYPE_RECORD,
+    TYPE_MATRIX,
+    TYPE_BITSET
 } LiteralType;
 
 // Enum for Return Types
 typedef enum { RETURN_NORMAL, RETURN_ERROR } ReturnType;
 
-// Structure for Array Values
+// Structure for Array Values (slices share their base array's buffer).
+// Values hold them boxed (see `array_box()`), so arrays are references.
 typedef struct ArrayValue {
-    struct LiteralValue *elements; // Dynamic array of LiteralValue
-    size_t count;                  // Number of elements
-    size_t capacity;               // Allocated capacity
+    struct ArrayBuffer *buffer; // Element storage (NULL until first needed)
+    size_t offset;              // Slot holding element 0 (elements wrap)
+    ptrdiff_t step;             // Slot distance between consecutive elements
+    size_t count;               // Number of elements
+    size_t owner;               // `parallel_task_owner()` of its creator
 } ArrayValue;
 
+// Structure for String Values (immutable once frozen)
+typedef struct FlavorString {
+    size_t length;   // Length in bytes, excluding the NULL terminator
+    size_t capacity; // Bytes available for contents
+    size_t hash;     // FNV-1a hash, computed on first use (0 = not yet)
+    bool frozen;     // False only while a single owner may append in place
+
+    // Parallel tasks may hash & freeze strings they share, so once a string
+    // can be seen by other threads, `hash` & `frozen` are only accessed
+    // atomically (`fl_string_hash()`, `fl_string_freeze()`)
+    char bytes[];    // NULL-terminated contents
+} FlavorString;
+
+// Structure for String Builders (shared by reference, like a file handle)
+typedef struct StringBuilder {
+    FlavorString *buffer; // Unfrozen until handed out by `build()`
+} StringBuilder;
+
+// Structure for Maps (shared by reference, like builders). Entries are kept
+// in insertion order, with an open-addressing table of entry indices.
+typedef struct MapValue {
+    size_t count;             // Live entries
+    size_t used;              // Entries in use, including removed ones
+    size_t capacity;          // Entry slots
+    size_t mask;              // Table slots - 1 (a power of two)
+    struct MapEntry *entries; // Insertion-ordered entries
+    size_t *slots;            // Entry index + 1 per table slot (0 = empty)
+    size_t owner;             // `parallel_task_owner()` of its creator
+} MapValue;
+
+// Structure for Heaps (priority queues, shared by reference). Entries form
+// an implicit d-ary heap, with the entry that comes out first at index 0.
+typedef struct HeapValue {
+    size_t count;              // Entries in the heap
+    size_t capacity;           // Entry slots
+    struct HeapEntry *entries; // Heap-ordered entries
+    FlavorString *comparator;  // User function's name (NULL = ascending)
+    size_t owner;              // `parallel_task_owner()` of its creator
+} HeapValue;
+
+// Structure for Record Types (one per `record` declaration, never freed)
+typedef struct RecordType {
+    char *name;
+    size_t field_count;
+    char **field_names; // In slot order
+    size_t *field_ids;  // Parser-wide id of each field name
+} RecordType;
+
 // Structure for Literal Values
 typedef struct LiteralValue {
     LiteralType type;
     union {
-        char *string;
-        long double floating_point;
+        FlavorString *string; // Also used for TYPE_ERROR messages
+        StringBuilder *builder;
+        MapValue *map;
+        HeapValue *heap;
+        struct RecordValue *record;
+        struct MatrixValue *matrix;
+        struct BitsetValue *bitset;
+        ArrayValue *array;
+        FLOAT_SIZE floating_point;
         long long integer;
         bool boolean;
         char *function_name;
-        ArrayValue array; // By value
-    } data;
+    } data; // One word (with doubles), so a whole value is 16 bytes
 } LiteralValue;
 
+// Structure for Map Entries
+typedef struct MapEntry {
+    LiteralValue key;
+    LiteralValue value;
+    size_t hash;  // Cached hash of `key`
+    bool removed; // Removed entries stay in place until the table is rebuilt
+} MapEntry;
+
+// Structure for Heap Entries
+typedef struct HeapEntry {
+    LiteralValue priority; // What entries are ordered by
+    LiteralValue value;    // What `pop()` returns
+} HeapEntry;
+
+// Structure for Records (shared by reference, like maps). Fields sit in
+// fixed slots right after the header, in declaration order.
+typedef struct RecordValue {
+    const RecordType *type;
+    size_t owner;          // `parallel_task_owner()` of its creator
+    LiteralValue fields[]; // One per field
+} RecordValue;
+
+// Structure for Matrices (dense & row-major, shared by reference like maps)
+typedef struct MatrixValue {
+    size_t rows;
+    size_t cols;
+    size_t owner;        // `parallel_task_owner()` of its creator
+    FLOAT_SIZE cells[];  // `rows * cols` elements, row after row
+} MatrixValue;
+
+// Structure for Bitsets (shared by reference like maps). Bit `i` is bit
+// `i % 64` of word `i / 64`; bits past the end of the last word stay 0.
+typedef struct BitsetValue {
+    size_t bits;      // Number of bits
+    size_t owner;     // `parallel_task_owner()` of its creator
+    uint64_t words[]; // `ceil(bits / 64)` words
+} BitsetValue;
+
+// Enum for Array Element Storage
+typedef enum {
+    ARRAY_BOXED, // Any values, each a full LiteralValue
+    ARRAY_INT,   // Unboxed INT_SIZE integers
+    ARRAY_FLOAT, // Unboxed FLOAT_SIZE floats
+    ARRAY_BOOL   // Unboxed booleans, one byte each
+} ArrayKind;
+
+// Structure for Array Element Buffers
+typedef struct ArrayBuffer {
+    size_t capacity;      // Number of element slots
+    ArrayKind kind;       // How the slots are stored
+    bool shared;          // Referenced by a slice view: copy before writing
+    LiteralValue items[]; // Element slots (unused ones are zeroed); typed
+                          // buffers reinterpret this storage
+} ArrayBuffer;
+
+// How evaluating a node finished. The node's value (or the `deliver`ed value,
+// or the error) goes into the result slot the caller passed in.
+typedef enum {
+    FLOW_NORMAL, // Carry on with the next statement
+    FLOW_RETURN, // A `deliver` is leaving the current function
+    FLOW_BREAK,  // A `break` is leaving the current loop or `check`
+    FLOW_ERROR   // The slot holds an error value
+} ControlFlow;
+
 // Structure for Interpreted Results
 typedef struct {
     LiteralValue value; // Using the complete type name
@@ -60,6 +190,29 @@ typedef struct {
 typedef InterpretResult (*FlavorLangCFunc)(struct ASTNode *args,
                                            Environment *env);
 
+// A built-in's C function. It gets its arguments evaluated & checked against
+// its spec, unless the spec says it evaluates its own (then `args` is NULL).
+typedef InterpretResult (*BuiltinFunction)(struct ASTNode *node,
+                                           Environment *env,
+                                           LiteralValue *args);
+
+// The types an argument may have, or-ed together
+typedef enum {
+    ARG_TYPE_ANY = 0,
+    ARG_TYPE_INTEGER = 1 << 0,
+    ARG_TYPE_FLOAT = 1 << 1,
+    ARG_TYPE_STRING = 1 << 2,
+    ARG_TYPE_BOOLEAN = 1 << 3,
+    ARG_TYPE_ARRAY = 1 << 4,
+    ARG_TYPE_NUMERIC = ARG_TYPE_INTEGER | ARG_TYPE_FLOAT, // Either float or int
+    ARG_TYPE_FUNCTION = 1 << 5,
+    ARG_TYPE_BUILDER = 1 << 6,
+    ARG_TYPE_MAP = 1 << 7,
+    ARG_TYPE_HEAP = 1 << 8,
+    ARG_TYPE_MATRIX = 1 << 9,
+    ARG_TYPE_BITSET = 1 << 10
+} ArgType;
+
 // Structure for Function Results
 typedef struct {
     LiteralValue value;
@@ -74,6 +227,22 @@ typedef struct {
     bool is_constant;
 } Variable;
 
+#define BUILTIN_TYPED_ARGS 3
+
+// Describes a built-in function: the C function that runs it & the arguments
+// it takes, which are checked before it's called
+typedef struct BuiltinSpec {
+    const char *name;
+    BuiltinFunction function;
+    size_t min_args;
+    size_t max_args;       // `BUILTIN_VARIADIC` for no limit
+    const char *arguments; // What it expects, for errors ("a heap, ...")
+    ArgType types[BUILTIN_TYPED_ARGS]; // Per argument; any for the rest
+    bool lazy; // Evaluates its own arguments, so only their count is checked
+} BuiltinSpec;
+
+#define BUILTIN_VARIADIC SIZE_MAX
+
 // Structure for Functions
 typedef struct Function {
     char *name;
@@ -82,6 +251,10 @@ typedef struct Function {
     FunctionResult return_value;
     bool is_builtin;
     FlavorLangCFunc c_function;
+    const BuiltinSpec *builtin; // Set for the standard library's built-ins
+    const RecordType *record;   // Set for record constructors
+    struct MemoTable *memo;     // Set by `memoize()`
+    struct FreeNames *free_names; // Set by the first tail call to it
 } Function;
 
 // Structure for Environment
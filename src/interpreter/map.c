@@ -0,0 +1,244 @@
+#include "map.h"
+#include "array.h"
+#include "flavor_string.h"
+#include "gc.h"
+#include "parallel.h"
+#include <stdint.h>
+
+// Allocates the entries & table for `slots` table slots. At most 3/4 of the
+// slots are ever used, which keeps probe sequences short.
+static void map_allocate(MapValue *map, size_t slots) {
+    map->capacity = slots / 4 * 3;
+    map->mask = slots - 1;
+    map->entries = gc_alloc(GC_MAP, map->capacity * sizeof(MapEntry));
+    memset(map->entries, 0, map->capacity * sizeof(MapEntry));
+    map->slots = gc_alloc(GC_MAP, slots * sizeof(size_t));
+    memset(map->slots, 0, slots * sizeof(size_t));
+}
+
+MapValue *map_new(size_t capacity) {
+    size_t slots = MAP_MIN_SLOTS;
+    while (slots / 4 * 3 < capacity) {
+        slots *= 2;
+    }
+
+    MapValue *map = gc_alloc(GC_MAP, sizeof(MapValue));
+    map->count = 0;
+    map->used = 0;
+    map->owner = parallel_task_owner();
+    map_allocate(map, slots);
+    return map;
+}
+
+bool map_key_supported(LiteralValue key) {
+    return key.type == TYPE_STRING || key.type == TYPE_INTEGER ||
+           key.type == TYPE_FLOAT || key.type == TYPE_BOOLEAN;
+}
+
+// Mixes the bits of an integer key (from SplitMix64), so keys like 0, 8,
+// 16, ... don't all land in the same table slot
+static size_t map_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (size_t)x;
+}
+
+size_t map_key_hash(LiteralValue key) {
+    switch (key.type) {
+    case TYPE_STRING:
+        return fl_string_hash(key.data.string);
+    case TYPE_INTEGER:
+        return map_mix((uint64_t)key.data.integer);
+    case TYPE_BOOLEAN:
+        return map_mix(key.data.boolean);
+    case TYPE_FLOAT: {
+        // Hash the value's bytes, treating -0.0 as 0.0 (they compare equal)
+        double value = (double)key.data.floating_point;
+        uint64_t bits = 0;
+        if (value != 0.0) {
+            memcpy(&bits, &value, sizeof(bits));
+        }
+        return map_mix(bits);
+    }
+    default:
+        return 0;
+    }
+}
+
+// Keys are equal if they have the same type & value
+bool map_keys_equal(LiteralValue a, LiteralValue b) {
+    if (a.type != b.type) {
+        return false;
+    }
+    switch (a.type) {
+    case TYPE_STRING:
+        return fl_string_equals(a.data.string, b.data.string);
+    case TYPE_INTEGER:
+        return a.data.integer == b.data.integer;
+    case TYPE_FLOAT:
+        return a.data.floating_point == b.data.floating_point;
+    case TYPE_BOOLEAN:
+        return a.data.boolean == b.data.boolean;
+    default:
+        return false;
+    }
+}
+
+// Returns the table slot holding `key`, or the empty slot that ends its probe
+// sequence. Slots of removed entries are probed past, so they act as
+// tombstones until the next rebuild.
+static size_t map_find_slot(const MapValue *map, LiteralValue key,
+                            size_t hash) {
+    size_t slot = hash & map->mask;
+    while (map->slots[slot] != 0) {
+        const MapEntry *entry = &map->entries[map->slots[slot] - 1];
+        if (!entry->removed && entry->hash == hash &&
+            map_keys_equal(entry->key, key)) {
+            return slot;
+        }
+        slot = (slot + 1) & map->mask;
+    }
+    return slot;
+}
+
+bool map_get(const MapValue *map, LiteralValue key, LiteralValue *value) {
+    if (!map_key_supported(key)) {
+        return false;
+    }
+    size_t slot = map_find_slot(map, key, map_key_hash(key));
+    if (map->slots[slot] == 0) {
+        return false;
+    }
+    *value = map->entries[map->slots[slot] - 1].value;
+    return true;
+}
+
+// Returns the value stored for `key` (valid until the map next grows), or
+// NULL if it's missing
+LiteralValue *map_slot(MapValue *map, LiteralValue key) {
+    if (!map_key_supported(key)) {
+        return NULL;
+    }
+    size_t slot = map_find_slot(map, key, map_key_hash(key));
+    if (map->slots[slot] == 0) {
+        return NULL;
+    }
+    return &map->entries[map->slots[slot] - 1].value;
+}
+
+/**
+ * @brief Steps through a map's entries in insertion order.
+ *
+ * @param map      The map.
+ * @param position Cursor, starting at 0.
+ * @param key      Receives the next key.
+ * @param value    Receives the next value.
+ * @return bool False once every entry has been visited.
+ */
+bool map_next(const MapValue *map, size_t *position, LiteralValue *key,
+              LiteralValue *value) {
+    while (*position < map->used) {
+        const MapEntry *entry = &map->entries[(*position)++];
+        if (!entry->removed) {
+            *key = entry->key;
+            *value = entry->value;
+            return true;
+        }
+    }
+    return false;
+}
+
+ArrayValue map_keys(const MapValue *map) {
+    ArrayValue keys = array_new(map->count);
+    size_t position = 0;
+    LiteralValue key, value;
+    while (map_next(map, &position, &key, &value)) {
+        array_push(&keys, key);
+    }
+    return keys;
+}
+
+ArrayValue map_values(const MapValue *map) {
+    ArrayValue values = array_new(map->count);
+    size_t position = 0;
+    LiteralValue key, value;
+    while (map_next(map, &position, &key, &value)) {
+        array_push(&values, value);
+    }
+    return values;
+}
+
+// Moves the live entries into a table sized for twice as many, dropping
+// removed ones
+static void map_rebuild(MapValue *map) {
+    MapEntry *old_entries = map->entries;
+    size_t old_used = map->used;
+
+    size_t slots = MAP_MIN_SLOTS;
+    while (slots / 4 * 3 < map->count * 2 + 1) {
+        slots *= 2;
+    }
+    map_allocate(map, slots);
+
+    map->used = 0;
+    for (size_t i = 0; i < old_used; i++) {
+        if (old_entries[i].removed) {
+            continue;
+        }
+        size_t slot = old_entries[i].hash & map->mask;
+        while (map->slots[slot] != 0) {
+            slot = (slot + 1) & map->mask;
+        }
+        map->entries[map->used] = old_entries[i];
+        map->slots[slot] = ++map->used;
+    }
+}
+
+// Parallel tasks may read any map, but only modify maps they created
+bool map_writable(const MapValue *map) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || map->owner == owner;
+}
+
+void map_set(MapValue *map, LiteralValue key, LiteralValue value) {
+    size_t hash = map_key_hash(key);
+    size_t slot = map_find_slot(map, key, hash);
+    if (map->slots[slot] != 0) {
+        map->entries[map->slots[slot] - 1].value = value;
+        return;
+    }
+
+    if (map->used == map->capacity) {
+        map_rebuild(map);
+        slot = map_find_slot(map, key, hash);
+    }
+
+    MapEntry *entry = &map->entries[map->used];
+    entry->key = key;
+    entry->value = value;
+    entry->hash = hash;
+    entry->removed = false;
+    map->slots[slot] = ++map->used;
+    map->count++;
+}
+
+bool map_remove(MapValue *map, LiteralValue key) {
+    if (!map_key_supported(key)) {
+        return false;
+    }
+    size_t slot = map_find_slot(map, key, map_key_hash(key));
+    if (map->slots[slot] == 0) {
+        return false;
+    }
+
+    // Clear the entry so the collector can free what it held
+    MapEntry *entry = &map->entries[map->slots[slot] - 1];
+    entry->removed = true;
+    entry->key = (LiteralValue){.type = TYPE_BOOLEAN};
+    entry->value = (LiteralValue){.type = TYPE_BOOLEAN};
+    map->count--;
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef MAP_H
+#define MAP_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Smallest hash table allocated for a map (always a power of two)
+#define MAP_MIN_SLOTS 8
+
+// Creation
+MapValue *map_new(size_t capacity);
+
+// Keys (strings, integers, floats & booleans)
+bool map_key_supported(LiteralValue key);
+size_t map_key_hash(LiteralValue key);
+bool map_keys_equal(LiteralValue a, LiteralValue b);
+
+// Access
+bool map_get(const MapValue *map, LiteralValue key, LiteralValue *value);
+LiteralValue *map_slot(MapValue *map, LiteralValue key);
+bool map_next(const MapValue *map, size_t *position, LiteralValue *key,
+              LiteralValue *value);
+ArrayValue map_keys(const MapValue *map);
+ArrayValue map_values(const MapValue *map);
+
+// Mutation (keys must be supported)
+bool map_writable(const MapValue *map);
+void map_set(MapValue *map, LiteralValue key, LiteralValue value);
+bool map_remove(MapValue *map, LiteralValue key);
+
+#endif
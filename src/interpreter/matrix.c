@@ -0,0 +1,242 @@
+#include "matrix.h"
+#include "array.h"
+#include "gc.h"
+#include "parallel.h"
+
+MatrixValue *matrix_new(size_t rows, size_t cols) {
+    size_t cells = rows * cols;
+    MatrixValue *matrix =
+        gc_alloc(GC_MATRIX, sizeof(MatrixValue) + cells * sizeof(FLOAT_SIZE));
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->owner = parallel_task_owner();
+    memset(matrix->cells, 0, cells * sizeof(FLOAT_SIZE));
+    return matrix;
+}
+
+// Parallel tasks may read any matrix, but only modify matrices they created
+bool matrix_writable(const MatrixValue *matrix) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || matrix->owner == owner;
+}
+
+bool matrix_offset(const MatrixValue *matrix, INT_SIZE row, INT_SIZE col,
+                   size_t *offset) {
+    if (row < 0) {
+        row += (INT_SIZE)matrix->rows;
+    }
+    if (col < 0) {
+        col += (INT_SIZE)matrix->cols;
+    }
+    if (row < 0 || (size_t)row >= matrix->rows || col < 0 ||
+        (size_t)col >= matrix->cols) {
+        return false;
+    }
+    *offset = (size_t)row * matrix->cols + (size_t)col;
+    return true;
+}
+
+// ==================================================
+// SLICING
+// ==================================================
+
+MatrixValue *matrix_select_rows(const MatrixValue *matrix, size_t start,
+                                ptrdiff_t step, size_t count) {
+    MatrixValue *result = matrix_new(count, matrix->cols);
+    for (size_t i = 0; i < count; i++) {
+        size_t row = (size_t)((ptrdiff_t)start + (ptrdiff_t)i * step);
+        memcpy(&result->cells[i * matrix->cols],
+               &matrix->cells[row * matrix->cols],
+               matrix->cols * sizeof(FLOAT_SIZE));
+    }
+    return result;
+}
+
+// A float array with `count` elements for the caller to fill in
+static ArrayValue float_result(size_t count, FLOAT_SIZE **cells) {
+    ArrayValue result = array_new_typed(ARRAY_FLOAT, count);
+    result.count = count;
+    *cells = count ? (FLOAT_SIZE *)result.buffer->items : NULL;
+    return result;
+}
+
+ArrayValue matrix_row(const MatrixValue *matrix, size_t row) {
+    FLOAT_SIZE *dst;
+    ArrayValue result = float_result(matrix->cols, &dst);
+    if (matrix->cols > 0) {
+        memcpy(dst, &matrix->cells[row * matrix->cols],
+               matrix->cols * sizeof(FLOAT_SIZE));
+    }
+    return result;
+}
+
+ArrayValue matrix_column(const MatrixValue *matrix, size_t col) {
+    FLOAT_SIZE *dst;
+    ArrayValue result = float_result(matrix->rows, &dst);
+    for (size_t i = 0; i < matrix->rows; i++) {
+        dst[i] = matrix->cells[i * matrix->cols + col];
+    }
+    return result;
+}
+
+// ==================================================
+// MULTIPLICATION
+// ==================================================
+
+typedef struct {
+    const MatrixValue *left;
+    const MatrixValue *right;
+    MatrixValue *result;
+} MatrixProduct;
+
+/**
+ * @brief Computes rows [begin, end) of a product, one tile of `right` at a
+ * time.
+ *
+ * The innermost loop runs along a row of `right` & of the result, so both
+ * are read contiguously, and each tile of `right` is reused for every row in
+ * the range before moving on.
+ */
+static void matrix_product_rows(void *context, size_t chunk, size_t begin,
+                                size_t end) {
+    (void)chunk;
+    const MatrixProduct *product = context;
+    const MatrixValue *a = product->left;
+    const MatrixValue *b = product->right;
+    MatrixValue *c = product->result;
+    size_t inner = a->cols;
+    size_t cols = b->cols;
+
+    for (size_t kk = 0; kk < inner; kk += MATRIX_BLOCK) {
+        size_t k_end = kk + MATRIX_BLOCK < inner ? kk + MATRIX_BLOCK : inner;
+        for (size_t jj = 0; jj < cols; jj += MATRIX_BLOCK) {
+            size_t j_end = jj + MATRIX_BLOCK < cols ? jj + MATRIX_BLOCK : cols;
+            for (size_t i = begin; i < end; i++) {
+                const FLOAT_SIZE *a_row = &a->cells[i * inner];
+                FLOAT_SIZE *c_row = &c->cells[i * cols];
+                for (size_t k = kk; k < k_end; k++) {
+                    FLOAT_SIZE x = a_row[k];
+                    const FLOAT_SIZE *b_row = &b->cells[k * cols];
+                    for (size_t j = jj; j < j_end; j++) {
+                        c_row[j] += x * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiplies two matrices (`left->cols` must equal `right->rows`).
+ *
+ * Large products are split into bands of rows that run on the worker pool.
+ * The workers only read the operands & write their own rows of the result,
+ * so they never touch the collector or the interpreter.
+ */
+MatrixValue *matrix_multiply(const MatrixValue *left,
+                             const MatrixValue *right) {
+    MatrixValue *result = matrix_new(left->rows, right->cols);
+    MatrixProduct product = {.left = left, .right = right, .result = result};
+
+    size_t work = left->rows * left->cols * right->cols;
+    if (work >= MATRIX_PARALLEL_THRESHOLD && parallel_thread_count() > 1) {
+        parallel_for(left->rows, parallel_chunk_size(left->rows),
+                     matrix_product_rows, &product, NULL);
+    } else if (left->rows > 0) {
+        matrix_product_rows(&product, 0, 0, left->rows);
+    }
+    return result;
+}
+
+// ==================================================
+// OTHER KERNELS
+// ==================================================
+
+// Copies one tile at a time, so the strided writes stay within a few pages
+MatrixValue *matrix_transpose(const MatrixValue *matrix) {
+    size_t rows = matrix->rows;
+    size_t cols = matrix->cols;
+    MatrixValue *result = matrix_new(cols, rows);
+    for (size_t ii = 0; ii < rows; ii += MATRIX_BLOCK) {
+        size_t i_end = ii + MATRIX_BLOCK < rows ? ii + MATRIX_BLOCK : rows;
+        for (size_t jj = 0; jj < cols; jj += MATRIX_BLOCK) {
+            size_t j_end = jj + MATRIX_BLOCK < cols ? jj + MATRIX_BLOCK : cols;
+            for (size_t i = ii; i < i_end; i++) {
+                for (size_t j = jj; j < j_end; j++) {
+                    result->cells[j * rows + i] = matrix->cells[i * cols + j];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static FLOAT_SIZE matrix_apply(MatrixOp op, FLOAT_SIZE x, FLOAT_SIZE y) {
+    switch (op) {
+    case MATRIX_ADD:
+        return x + y;
+    case MATRIX_SUBTRACT:
+        return x - y;
+    case MATRIX_MULTIPLY:
+        return x * y;
+    default:
+        return x / y;
+    }
+}
+
+// Both matrices must have the same shape
+MatrixValue *matrix_elementwise(MatrixOp op, const MatrixValue *left,
+                                const MatrixValue *right) {
+    MatrixValue *result = matrix_new(left->rows, left->cols);
+    size_t cells = left->rows * left->cols;
+    for (size_t i = 0; i < cells; i++) {
+        result->cells[i] = matrix_apply(op, left->cells[i], right->cells[i]);
+    }
+    return result;
+}
+
+// Applies `op` to every element & `scalar` (as the left operand if
+// `scalar_first`, e.g. `1 - m`)
+MatrixValue *matrix_scalar(MatrixOp op, const MatrixValue *matrix,
+                           FLOAT_SIZE scalar, bool scalar_first) {
+    MatrixValue *result = matrix_new(matrix->rows, matrix->cols);
+    size_t cells = matrix->rows * matrix->cols;
+    for (size_t i = 0; i < cells; i++) {
+        result->cells[i] =
+            scalar_first ? matrix_apply(op, scalar, matrix->cells[i])
+                         : matrix_apply(op, matrix->cells[i], scalar);
+    }
+    return result;
+}
+
+// Reduces each row to one value (`MATRIX_MIN` & `MATRIX_MAX` need at least
+// one column)
+ArrayValue matrix_reduce_rows(const MatrixValue *matrix,
+                              MatrixReduction reduction) {
+    FLOAT_SIZE *dst;
+    ArrayValue result = float_result(matrix->rows, &dst);
+    size_t cols = matrix->cols;
+    for (size_t i = 0; i < matrix->rows; i++) {
+        const FLOAT_SIZE *row = &matrix->cells[i * cols];
+        FLOAT_SIZE total;
+        if (reduction == MATRIX_MIN || reduction == MATRIX_MAX) {
+            total = row[0];
+            for (size_t j = 1; j < cols; j++) {
+                if (reduction == MATRIX_MIN ? row[j] < total
+                                            : row[j] > total) {
+                    total = row[j];
+                }
+            }
+        } else {
+            total = 0;
+            for (size_t j = 0; j < cols; j++) {
+                total += row[j];
+            }
+            if (reduction == MATRIX_MEAN) {
+                total /= (FLOAT_SIZE)cols;
+            }
+        }
+        dst[i] = total;
+    }
+    return result;
+}
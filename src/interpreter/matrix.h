@@ -0,0 +1,58 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "../shared/data_types.h"
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Side of the square tiles the kernels work through, so the tiles of each
+// operand they touch at once stay in cache
+#define MATRIX_BLOCK 64
+
+// Multiplications with at least this many multiply-adds run on the worker
+// pool (see `parallel_for()`)
+#define MATRIX_PARALLEL_THRESHOLD (MATRIX_BLOCK * MATRIX_BLOCK * MATRIX_BLOCK)
+
+// Element-wise operators
+typedef enum {
+    MATRIX_ADD,
+    MATRIX_SUBTRACT,
+    MATRIX_MULTIPLY,
+    MATRIX_DIVIDE
+} MatrixOp;
+
+// Row reductions
+typedef enum {
+    MATRIX_SUM,
+    MATRIX_MEAN,
+    MATRIX_MIN,
+    MATRIX_MAX
+} MatrixReduction;
+
+// Creation (every element starts at 0)
+MatrixValue *matrix_new(size_t rows, size_t cols);
+bool matrix_writable(const MatrixValue *matrix);
+
+// Elements (negative indices count from the end)
+bool matrix_offset(const MatrixValue *matrix, INT_SIZE row, INT_SIZE col,
+                   size_t *offset);
+
+// Slicing (each result is a new matrix or float array)
+MatrixValue *matrix_select_rows(const MatrixValue *matrix, size_t start,
+                                ptrdiff_t step, size_t count);
+ArrayValue matrix_row(const MatrixValue *matrix, size_t row);
+ArrayValue matrix_column(const MatrixValue *matrix, size_t col);
+
+// Kernels (each result is a new matrix or float array)
+MatrixValue *matrix_multiply(const MatrixValue *left,
+                             const MatrixValue *right);
+MatrixValue *matrix_transpose(const MatrixValue *matrix);
+MatrixValue *matrix_elementwise(MatrixOp op, const MatrixValue *left,
+                                const MatrixValue *right);
+MatrixValue *matrix_scalar(MatrixOp op, const MatrixValue *matrix,
+                           FLOAT_SIZE scalar, bool scalar_first);
+ArrayValue matrix_reduce_rows(const MatrixValue *matrix,
+                              MatrixReduction reduction);
+
+#endif
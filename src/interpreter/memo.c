@@ -0,0 +1,682 @@
+#include "memo.h"
+#include "../parser/utils.h"
+#include "flavor_string.h"
+#include "interpreter.h"
+#include "map.h"
+#include "utils.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A key or result, copied out of the interpreter's values so the table never
+// holds anything the garbage collector manages
+typedef struct {
+    LiteralType type;
+    union {
+        long long integer;
+        FLOAT_SIZE floating_point;
+        bool boolean;
+        struct {
+            char *bytes;
+            size_t length;
+        } string;
+    } data;
+} MemoValue;
+
+struct MemoEntry {
+    size_t hash;
+    MemoEntry *chain; // Next entry in the same bucket
+    MemoEntry *newer; // Neighbours in the least recently used list
+    MemoEntry *older;
+    MemoValue result;
+    size_t arg_count;
+    MemoValue args[]; // One per parameter
+};
+
+// ==================================================
+// VALUES
+// ==================================================
+
+static bool memo_value_supported(LiteralType type) {
+    return type == TYPE_INTEGER || type == TYPE_FLOAT ||
+           type == TYPE_BOOLEAN || type == TYPE_STRING;
+}
+
+static MemoValue memo_value_copy(LiteralValue value) {
+    MemoValue copy = {.type = value.type};
+    switch (value.type) {
+    case TYPE_INTEGER:
+        copy.data.integer = value.data.integer;
+        break;
+    case TYPE_FLOAT:
+        copy.data.floating_point = value.data.floating_point;
+        break;
+    case TYPE_BOOLEAN:
+        copy.data.boolean = value.data.boolean;
+        break;
+    default: {
+        FlavorString *str = value.data.string;
+        copy.data.string.length = str->length;
+        copy.data.string.bytes = malloc(str->length + 1);
+        if (!copy.data.string.bytes) {
+            fatal_error("Memory allocation failed for a memoized value.\n");
+        }
+        memcpy(copy.data.string.bytes, str->bytes, str->length + 1);
+        break;
+    }
+    }
+    return copy;
+}
+
+// Floats are the same key if they're equal & have the same sign (so `0.0`
+// & `-0.0` differ, as dividing by them does)
+static bool memo_floats_equal(FLOAT_SIZE a, FLOAT_SIZE b) {
+    return a == b && signbit(a) == signbit(b);
+}
+
+static void memo_value_free(MemoValue *value) {
+    if (value->type == TYPE_STRING) {
+        free(value->data.string.bytes);
+    }
+}
+
+// Whether a stored key matches an argument (`1` & `1.0` are different keys,
+// as the function may tell them apart)
+static bool memo_value_matches(const MemoValue *stored, LiteralValue value) {
+    if (stored->type != value.type) {
+        return false;
+    }
+    switch (value.type) {
+    case TYPE_INTEGER:
+        return stored->data.integer == value.data.integer;
+    case TYPE_FLOAT:
+        return memo_floats_equal(stored->data.floating_point,
+                                 value.data.floating_point);
+    case TYPE_BOOLEAN:
+        return stored->data.boolean == value.data.boolean;
+    default:
+        return stored->data.string.length == value.data.string->length &&
+               memcmp(stored->data.string.bytes, value.data.string->bytes,
+                      stored->data.string.length) == 0;
+    }
+}
+
+static LiteralValue memo_value_to_literal(const MemoValue *value) {
+    LiteralValue literal = {.type = value->type};
+    switch (value->type) {
+    case TYPE_INTEGER:
+        literal.data.integer = value->data.integer;
+        break;
+    case TYPE_FLOAT:
+        literal.data.floating_point = value->data.floating_point;
+        break;
+    case TYPE_BOOLEAN:
+        literal.data.boolean = value->data.boolean;
+        break;
+    default:
+        literal.data.string = fl_string_from_bytes(value->data.string.bytes,
+                                                   value->data.string.length);
+        break;
+    }
+    return literal;
+}
+
+void memo_entry_free(MemoEntry *entry) {
+    for (size_t i = 0; i < entry->arg_count; i++) {
+        memo_value_free(&entry->args[i]);
+    }
+    memo_value_free(&entry->result);
+    free(entry);
+}
+
+// ==================================================
+// CREATION
+// ==================================================
+
+MemoTable *memo_new(size_t capacity) {
+    MemoTable *memo = calloc(1, sizeof(MemoTable));
+    if (!memo) {
+        fatal_error("Memory allocation failed for a memo table.\n");
+    }
+
+    // About one bucket per entry, up to a million (chains just get longer)
+    size_t buckets = 16;
+    while (buckets < capacity && buckets < ((size_t)1 << 20)) {
+        buckets <<= 1;
+    }
+    memo->buckets = calloc(buckets, sizeof(MemoEntry *));
+    if (!memo->buckets) {
+        fatal_error("Memory allocation failed for a memo table.\n");
+    }
+    memo->bucket_mask = buckets - 1;
+    memo->capacity = capacity;
+    return memo;
+}
+
+void memo_free(MemoTable *memo) {
+    if (!memo) {
+        return;
+    }
+    MemoEntry *entry = memo->newest;
+    while (entry) {
+        MemoEntry *older = entry->older;
+        memo_entry_free(entry);
+        entry = older;
+    }
+    free(memo->buckets);
+    free(memo);
+}
+
+// ==================================================
+// LOOKUP
+// ==================================================
+
+bool memo_key_supported(const Environment *frame, size_t num_params) {
+    if (frame->variable_count < num_params) {
+        return false; // A parameter name was repeated
+    }
+    for (size_t i = 0; i < num_params; i++) {
+        if (!memo_value_supported(frame->variables[i].value.type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t memo_hash(const Environment *frame, size_t num_params) {
+    size_t hash = num_params;
+    for (size_t i = 0; i < num_params; i++) {
+        hash = (hash ^ map_key_hash(frame->variables[i].value)) *
+               (size_t)1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool memo_entry_matches(const MemoEntry *entry, const Environment *frame,
+                               size_t num_params, size_t hash) {
+    if (entry->hash != hash || entry->arg_count != num_params) {
+        return false;
+    }
+    for (size_t i = 0; i < num_params; i++) {
+        if (!memo_value_matches(&entry->args[i],
+                                frame->variables[i].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void memo_unlink(MemoTable *memo, MemoEntry *entry) {
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        memo->newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        memo->oldest = entry->newer;
+    }
+    entry->newer = entry->older = NULL;
+}
+
+static void memo_link_newest(MemoTable *memo, MemoEntry *entry) {
+    entry->older = memo->newest;
+    entry->newer = NULL;
+    if (memo->newest) {
+        memo->newest->newer = entry;
+    } else {
+        memo->oldest = entry;
+    }
+    memo->newest = entry;
+}
+
+/**
+ * @brief Looks up the result of a call whose arguments are the first
+ * `num_params` variables of `frame`. A hit counts as the most recent use of
+ * the entry.
+ *
+ * @return bool True (with `*result` set) if the call's result is known.
+ */
+bool memo_get(MemoTable *memo, const Environment *frame, size_t num_params,
+              size_t hash, LiteralValue *result) {
+    MemoEntry *entry = memo->buckets[hash & memo->bucket_mask];
+    while (entry && !memo_entry_matches(entry, frame, num_params, hash)) {
+        entry = entry->chain;
+    }
+    if (!entry) {
+        memo->misses++;
+        return false;
+    }
+
+    memo->hits++;
+    if (memo->newest != entry) {
+        memo_unlink(memo, entry);
+        memo_link_newest(memo, entry);
+    }
+    *result = memo_value_to_literal(&entry->result);
+    return true;
+}
+
+// ==================================================
+// STORING
+// ==================================================
+
+MemoEntry *memo_entry_new(const Environment *frame, size_t num_params,
+                          size_t hash) {
+    MemoEntry *entry =
+        calloc(1, sizeof(MemoEntry) + num_params * sizeof(MemoValue));
+    if (!entry) {
+        fatal_error("Memory allocation failed for a memo entry.\n");
+    }
+    entry->hash = hash;
+    entry->arg_count = num_params;
+    for (size_t i = 0; i < num_params; i++) {
+        entry->args[i] = memo_value_copy(frame->variables[i].value);
+    }
+    entry->result.type = TYPE_INTEGER; // Nothing to free until it's set
+    return entry;
+}
+
+static void memo_remove_from_bucket(MemoTable *memo, MemoEntry *entry) {
+    MemoEntry **slot = &memo->buckets[entry->hash & memo->bucket_mask];
+    while (*slot != entry) {
+        slot = &(*slot)->chain;
+    }
+    *slot = entry->chain;
+}
+
+static bool memo_values_equal(const MemoValue *a, const MemoValue *b) {
+    if (a->type != b->type) {
+        return false;
+    }
+    switch (a->type) {
+    case TYPE_INTEGER:
+        return a->data.integer == b->data.integer;
+    case TYPE_FLOAT:
+        return memo_floats_equal(a->data.floating_point,
+                                 b->data.floating_point);
+    case TYPE_BOOLEAN:
+        return a->data.boolean == b->data.boolean;
+    default:
+        return a->data.string.length == b->data.string.length &&
+               memcmp(a->data.string.bytes, b->data.string.bytes,
+                      a->data.string.length) == 0;
+    }
+}
+
+static bool memo_same_key(const MemoEntry *a, const MemoEntry *b) {
+    if (a->hash != b->hash || a->arg_count != b->arg_count) {
+        return false;
+    }
+    for (size_t i = 0; i < a->arg_count; i++) {
+        if (!memo_values_equal(&a->args[i], &b->args[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Stores the result of the call `entry` was made for, evicting the
+ * least recently used entry if the table is full. Takes ownership of
+ * `entry`, which is dropped if the result can't be memoized (or a nested
+ * call already stored the same arguments).
+ */
+void memo_put(MemoTable *memo, MemoEntry *entry, LiteralValue result) {
+    if (!memo_value_supported(result.type)) {
+        memo_entry_free(entry);
+        return;
+    }
+
+    MemoEntry **bucket = &memo->buckets[entry->hash & memo->bucket_mask];
+    for (MemoEntry *other = *bucket; other; other = other->chain) {
+        if (memo_same_key(other, entry)) {
+            memo_entry_free(entry);
+            return;
+        }
+    }
+
+    if (memo->count >= memo->capacity) {
+        MemoEntry *oldest = memo->oldest;
+        memo_unlink(memo, oldest);
+        memo_remove_from_bucket(memo, oldest);
+        memo_entry_free(oldest);
+        memo->count--;
+        memo->evictions++;
+    }
+
+    entry->result = memo_value_copy(result);
+    entry->chain = *bucket;
+    *bucket = entry;
+    memo_link_newest(memo, entry);
+    memo->count++;
+}
+
+// ==================================================
+// PURITY
+// ==================================================
+
+// Built-ins whose result depends on (or changes) something besides their
+// arguments
+static const char *const impure_builtins[] = {
+    "sample",      "serve",      "random", "get_time", "sleep",
+    "taste_file",  "plate_file", "garnish_file",       "cimport",
+    "push",        "pop",        "remove", "append",   "memoize",
+    "memo_stats",
+};
+
+bool memo_builtin_is_impure(const char *name) {
+    for (size_t i = 0; i < sizeof(impure_builtins) / sizeof(*impure_builtins);
+         i++) {
+        if (strcmp(impure_builtins[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct {
+    Environment *env;  // Where functions are looked up
+    Function *current; // Function whose body is being checked
+    const char **locals; // Names declared by `current` start at `local_base`
+    size_t local_base;
+    size_t local_count;
+    size_t local_capacity;
+    Function **checked; // Functions already checked (or being checked)
+    size_t checked_count;
+    size_t checked_capacity;
+    char *reason;
+    size_t reason_size;
+    bool pure;
+} PurityCheck;
+
+static void purity_fail(PurityCheck *check, const char *format,
+                        const char *name) {
+    if (!check->pure) {
+        return;
+    }
+    check->pure = false;
+    int written = snprintf(check->reason, check->reason_size, "`%s()` ",
+                           check->current->name);
+    if (written >= 0 && (size_t)written < check->reason_size) {
+        snprintf(check->reason + written, check->reason_size - written,
+                 format, name);
+    }
+}
+
+static void purity_add_local(PurityCheck *check, const char *name) {
+    if (!name) {
+        return;
+    }
+    if (check->local_count == check->local_capacity) {
+        size_t capacity = check->local_capacity ? check->local_capacity * 2 : 16;
+        const char **locals =
+            realloc((void *)check->locals, capacity * sizeof(const char *));
+        if (!locals) {
+            fatal_error("Memory allocation failed while checking a function "
+                        "for `memoize()`.\n");
+        }
+        check->locals = locals;
+        check->local_capacity = capacity;
+    }
+    check->locals[check->local_count++] = name;
+}
+
+static bool purity_is_local(const PurityCheck *check, const char *name) {
+    for (size_t i = check->local_base; i < check->local_count; i++) {
+        if (strcmp(check->locals[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool purity_is_parameter(const PurityCheck *check, const char *name) {
+    for (ASTFunctionParameter *param = check->current->parameters; param;
+         param = param->next) {
+        if (strcmp(param->parameter_name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Collects the names a function's body declares
+static void purity_collect_locals(ASTNode **slot, void *context) {
+    PurityCheck *check = context;
+    ASTNode *node = *slot;
+    switch (node->type) {
+    case AST_VAR_DECLARATION:
+        purity_add_local(check, node->var_declaration.variable_name);
+        break;
+    case AST_CONST_DECLARATION:
+        purity_add_local(check, node->const_declaration.constant_name);
+        break;
+    case AST_FOR_LOOP:
+        purity_add_local(check, node->for_loop.loop_variable);
+        break;
+    case AST_TRY:
+        for (ASTCatchNode *catch_node = node->try_block.catch_blocks;
+             catch_node; catch_node = catch_node->next) {
+            purity_add_local(check, catch_node->error_variable);
+        }
+        break;
+    default:
+        break;
+    }
+    ast_for_each_child(node, purity_collect_locals, context);
+}
+
+static void purity_check_function(PurityCheck *check, Function *func);
+
+// Checks a write to `target` (a variable, or an element or field of one)
+static void purity_check_write(PurityCheck *check, ASTNode *target) {
+    if (target->type == AST_VARIABLE_REFERENCE) {
+        if (!purity_is_local(check, target->variable_name)) {
+            purity_fail(check, "assigns to `%s`, which isn't one of its "
+                               "variables",
+                        target->variable_name);
+        }
+        return;
+    }
+
+    // Find the variable whose value is being changed in place
+    ASTNode *root = target;
+    for (;;) {
+        if (root->type == AST_ARRAY_INDEX_ACCESS) {
+            root = root->array_index_access.array;
+        } else if (root->type == AST_ARRAY_SLICE_ACCESS) {
+            root = root->array_slice_access.array;
+        } else if (root->type == AST_FIELD_ACCESS) {
+            root = root->field_access.object;
+        } else if (root->type == AST_ARRAY_OPERATION) {
+            root = root->array_operation.array;
+        } else {
+            break;
+        }
+    }
+    if (root->type != AST_VARIABLE_REFERENCE) {
+        purity_fail(check, "changes a value it didn't create%s", "");
+    } else if (!purity_is_local(check, root->variable_name) ||
+               purity_is_parameter(check, root->variable_name)) {
+        purity_fail(check, "changes `%s`, which it didn't create",
+                    root->variable_name);
+    }
+}
+
+// Calls see their callers' variables, so a constant can only be trusted if
+// it's global & nothing else in the program binds its name. Only numbers,
+// booleans & strings: a constant array, map, record or heap can still be
+// changed in place.
+static bool purity_is_global_constant(const PurityCheck *check,
+                                      Variable *var) {
+    if (!memo_value_supported(var->value.type)) {
+        return false;
+    }
+    Environment *global = check->env;
+    while (global->parent) {
+        global = global->parent;
+    }
+    return get_variable(global, var->variable_name) == var &&
+           bindings_count(var->variable_name) == 1;
+}
+
+// Checks a call to (or a reference to) the function `name`
+static void purity_check_callee(PurityCheck *check, const char *name) {
+    if (bindings_count(name)) {
+        purity_fail(check, "calls `%s()`, which a caller's variable could hide",
+                    name);
+        return;
+    }
+    Function *callee = get_function(check->env, name);
+    if (!callee) {
+        purity_fail(check, "calls `%s()`, which isn't defined", name);
+        return;
+    }
+    if (callee->is_builtin) {
+        if (memo_builtin_is_impure(name)) {
+            purity_fail(check, "calls `%s()`", name);
+        }
+        return;
+    }
+    if (!callee->record) {
+        purity_check_function(check, callee);
+    }
+}
+
+static void purity_check_node(ASTNode **slot, void *context) {
+    PurityCheck *check = context;
+    ASTNode *node = *slot;
+    if (!check->pure) {
+        return;
+    }
+
+    switch (node->type) {
+    case AST_ASSIGNMENT:
+        purity_check_write(check, node->assignment.lhs);
+        break;
+    case AST_ARRAY_OPERATION:
+        purity_check_write(check, node);
+        break;
+    case AST_FUNCTION_CALL: {
+        ASTNode *ref = node->function_call.function_ref;
+        if (ref->type != AST_VARIABLE_REFERENCE) {
+            purity_fail(check, "calls a function it works out at run time%s",
+                        "");
+        } else if (purity_is_local(check, ref->variable_name)) {
+            purity_fail(check, "calls `%s()`, which could be any function",
+                        ref->variable_name);
+        } else {
+            purity_check_callee(check, ref->variable_name);
+        }
+        // Check the arguments only (the callee isn't a variable read)
+        for (ASTNode *arg = node->function_call.arguments; arg;
+             arg = arg->next) {
+            purity_check_node(&arg, context);
+        }
+        return;
+    }
+    case AST_VARIABLE_REFERENCE: {
+        const char *name = node->variable_name;
+        if (purity_is_local(check, name)) {
+            break;
+        }
+        Variable *var = get_variable(check->env, name);
+        if (var && var->is_constant && purity_is_global_constant(check, var)) {
+            break;
+        }
+        if (!var && get_function(check->env, name)) {
+            purity_check_callee(check, name); // Passed as a value
+            break;
+        }
+        purity_fail(check, "reads `%s`, which can change between calls",
+                    name);
+        break;
+    }
+    case AST_FUNCTION_DECLARATION:
+        purity_fail(check, "declares the function `%s()`",
+                    node->function_declaration.name);
+        break;
+    case AST_RECORD_DECLARATION:
+        purity_fail(check, "declares the record `%s`",
+                    node->record_declaration.name);
+        break;
+    case AST_IMPORT:
+        purity_fail(check, "imports `%s`", node->import.import_path);
+        break;
+    default:
+        break;
+    }
+
+    ast_for_each_child(node, purity_check_node, context);
+}
+
+static void purity_check_function(PurityCheck *check, Function *func) {
+    for (size_t i = 0; i < check->checked_count; i++) {
+        if (check->checked[i] == func) {
+            return; // Recursion, or already checked
+        }
+    }
+    if (check->checked_count == check->checked_capacity) {
+        size_t capacity =
+            check->checked_capacity ? check->checked_capacity * 2 : 8;
+        Function **checked =
+            realloc(check->checked, capacity * sizeof(Function *));
+        if (!checked) {
+            fatal_error("Memory allocation failed while checking a function "
+                        "for `memoize()`.\n");
+        }
+        check->checked = checked;
+        check->checked_capacity = capacity;
+    }
+    check->checked[check->checked_count++] = func;
+
+    // Each function has its own locals
+    Function *outer = check->current;
+    size_t outer_base = check->local_base;
+    size_t outer_count = check->local_count;
+    check->current = func;
+    check->local_base = outer_count;
+    for (ASTFunctionParameter *param = func->parameters; param;
+         param = param->next) {
+        purity_add_local(check, param->parameter_name);
+    }
+    for (ASTNode *stmt = func->body; stmt; stmt = stmt->next) {
+        purity_collect_locals(&stmt, check);
+    }
+
+    for (ASTNode *stmt = func->body; stmt && check->pure; stmt = stmt->next) {
+        purity_check_node(&stmt, check);
+    }
+
+    check->current = outer;
+    check->local_base = outer_base;
+    check->local_count = outer_count;
+}
+
+/**
+ * @brief Checks (as far as can be told before running it) that a function's
+ * result depends only on its arguments, & that calling it changes nothing
+ * else: it only assigns to its own variables, only changes values it
+ * created, only reads global number, boolean & string constants no caller
+ * can shadow, & only calls functions that are pure too & that no caller's
+ * variable can shadow. Functions it calls are looked up in `env`.
+ *
+ * @return bool True if `func` looks pure; otherwise `reason` says why not.
+ */
+bool memo_check_pure(Function *func, Environment *env, char *reason,
+                     size_t reason_size) {
+    PurityCheck check = {.env = env,
+                         .current = func,
+                         .reason = reason,
+                         .reason_size = reason_size,
+                         .pure = true};
+    if (reason_size) {
+        reason[0] = '\0';
+    }
+    purity_check_function(&check, func);
+    free((void *)check.locals);
+    free(check.checked);
+    return check.pure;
+}
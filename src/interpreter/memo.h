@@ -0,0 +1,51 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Results a memoized function keeps unless `memoize()` is given a size
+#define MEMO_DEFAULT_CAPACITY 4096
+
+typedef struct MemoEntry MemoEntry;
+
+// The results of a memoized function, keyed by its arguments. Only numbers,
+// booleans & strings are used as keys or stored as results: other values
+// are references that could change after they were cached.
+typedef struct MemoTable {
+    MemoEntry **buckets; // Hash chains (`bucket_mask + 1` of them)
+    size_t bucket_mask;
+    MemoEntry *newest; // Least recently used list, evicted from `oldest`
+    MemoEntry *oldest;
+    size_t count;
+    size_t capacity;
+
+    // Statistics (`memo_stats()`)
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+} MemoTable;
+
+// Creation
+MemoTable *memo_new(size_t capacity);
+void memo_free(MemoTable *memo);
+
+// Lookup (the key is a call frame's parameters, its first variables)
+bool memo_key_supported(const Environment *frame, size_t num_params);
+size_t memo_hash(const Environment *frame, size_t num_params);
+bool memo_get(MemoTable *memo, const Environment *frame, size_t num_params,
+              size_t hash, LiteralValue *result);
+
+// Storing (the key is copied before the call runs, as it may change them)
+MemoEntry *memo_entry_new(const Environment *frame, size_t num_params,
+                          size_t hash);
+void memo_put(MemoTable *memo, MemoEntry *entry, LiteralValue result);
+void memo_entry_free(MemoEntry *entry);
+
+// Purity
+bool memo_builtin_is_impure(const char *name);
+bool memo_check_pure(Function *func, Environment *env, char *reason,
+                     size_t reason_size);
+
+#endif
@@ -1,14 +1,21 @@
 #include "module_cache.h"
+#include <pthread.h>
+
+// Modules can be imported from parallel tasks, so the list is locked
+static ModuleCacheEntry *moduleCacheHead = NULL;
+static pthread_mutex_t moduleCacheLock = PTHREAD_MUTEX_INITIALIZER;
 
 ModuleCacheEntry *lookup_module_cache(const char *module_path) {
+    pthread_mutex_lock(&moduleCacheLock);
     ModuleCacheEntry *entry = moduleCacheHead;
     while (entry) {
         if (strcmp(entry->module_path, module_path) == 0) {
-            return entry;
+            break;
         }
         entry = entry->next;
     }
-    return NULL;
+    pthread_mutex_unlock(&moduleCacheLock);
+    return entry;
 }
 
 void store_module_cache(const char *module_path, Environment *export_env) {
@@ -19,6 +26,8 @@ void store_module_cache(const char *module_path, Environment *export_env) {
     entry->module_path = strdup(module_path);
     entry->export_env =
         export_env; // might want to copy export table in the future
+    pthread_mutex_lock(&moduleCacheLock);
     entry->next = moduleCacheHead;
     moduleCacheHead = entry;
+    pthread_mutex_unlock(&moduleCacheLock);
 }
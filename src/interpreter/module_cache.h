@@ -16,8 +16,6 @@ typedef struct ModuleCacheEntry {
     struct ModuleCacheEntry *next;
 } ModuleCacheEntry;
 
-static ModuleCacheEntry *moduleCacheHead = NULL;
-
 ModuleCacheEntry *lookup_module_cache(const char *module_path);
 void store_module_cache(const char *module_path, Environment *export_env);
 
@@ -0,0 +1,292 @@
+#include "parallel.h"
+#include "call_stack.h"
+#include "gc.h"
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Chunks are dealt out to per-thread queues up front. Each thread takes
+// chunks from the front of its own queue, then steals from the back of the
+// others' once it runs out.
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next; // first unclaimed chunk
+    size_t end;  // one past the last unclaimed chunk
+} WorkQueue;
+
+typedef struct {
+    ParallelTask task;
+    void *context;
+    Environment *shared_env;
+    size_t count;
+    size_t chunk_size;
+    size_t participants;
+    WorkQueue queues[PARALLEL_MAX_THREADS];
+} ParallelJob;
+
+// Configuration
+static size_t parallel_threads = 0;
+
+// Pool (worker threads are started on first use & kept until shutdown)
+static pthread_t pool_threads[PARALLEL_MAX_THREADS];
+static size_t pool_size = 0;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static ParallelJob *pool_job = NULL;
+static unsigned long pool_generation = 0;
+static size_t pool_busy = 0; // workers yet to finish the current job
+static bool pool_stopping = false;
+static bool pool_stack_sized = false; // workers have `call_stack_size()`
+
+// State of the thread's current task
+static _Thread_local bool in_task = false;
+static _Thread_local Environment *task_shared_env = NULL;
+static _Thread_local size_t task_owner = 0;
+static size_t last_task_owner = 0;
+
+void parallel_configure(size_t threads) { parallel_threads = threads; }
+
+size_t parallel_thread_count(void) {
+    size_t threads = parallel_threads;
+    if (threads == 0) {
+#ifdef _WIN32
+        threads = 1;
+#else
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+#endif
+    }
+    return threads < PARALLEL_MAX_THREADS ? threads : PARALLEL_MAX_THREADS;
+}
+
+size_t parallel_chunk_size(size_t count) {
+    size_t chunks = parallel_thread_count() * PARALLEL_CHUNKS_PER_THREAD;
+    size_t size = (count + chunks - 1) / chunks;
+    return size ? size : 1;
+}
+
+// Whether the current thread is running a parallel task (e.g. a function
+// called by `parallel_map()`)
+bool parallel_in_task(void) { return in_task; }
+
+/**
+ * @brief Returns the environment a running task shares with other threads,
+ * or NULL outside of tasks. It & its ancestors are read-only to the task.
+ */
+Environment *parallel_shared_environment(void) { return task_shared_env; }
+
+/**
+ * @brief Identifies the thread's current run of tasks (0 outside tasks).
+ * Reference values like maps record it when created, so a task may only
+ * modify the ones it made itself.
+ */
+size_t parallel_task_owner(void) { return task_owner; }
+
+static size_t new_task_owner(void) {
+    return __atomic_add_fetch(&last_task_owner, 1, __ATOMIC_RELAXED);
+}
+
+// ==================================================
+// WORKERS
+// ==================================================
+
+static bool claim_chunk(ParallelJob *job, size_t self, size_t *chunk) {
+    WorkQueue *own = &job->queues[self];
+    pthread_mutex_lock(&own->lock);
+    if (own->next < own->end) {
+        *chunk = own->next++;
+        pthread_mutex_unlock(&own->lock);
+        return true;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (size_t i = 1; i < job->participants; i++) {
+        WorkQueue *victim = &job->queues[(self + i) % job->participants];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->next < victim->end) {
+            *chunk = --victim->end;
+            pthread_mutex_unlock(&victim->lock);
+            return true;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return false;
+}
+
+static void run_chunks(ParallelJob *job, size_t self) {
+    in_task = true;
+    task_shared_env = job->shared_env;
+    task_owner = new_task_owner();
+
+    size_t chunk;
+    while (claim_chunk(job, self, &chunk)) {
+        size_t begin = chunk * job->chunk_size;
+        size_t end = begin + job->chunk_size;
+        job->task(job->context, chunk, begin,
+                  end < job->count ? end : job->count);
+    }
+
+    in_task = false;
+    task_shared_env = NULL;
+    task_owner = 0;
+}
+
+static void *pool_worker(void *arg) {
+    size_t self = (size_t)arg;
+    unsigned long seen = 0;
+    if (pool_stack_sized) {
+        call_stack_attach();
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!pool_stopping && pool_generation == seen) {
+            pthread_cond_wait(&pool_wake, &pool_lock);
+        }
+        if (pool_stopping) {
+            break;
+        }
+        seen = pool_generation;
+        ParallelJob *job = pool_job;
+        pthread_mutex_unlock(&pool_lock);
+
+        if (self < job->participants) {
+            run_chunks(job, self);
+        }
+
+        pthread_mutex_lock(&pool_lock);
+        if (--pool_busy == 0) {
+            pthread_cond_signal(&pool_done);
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    gc_release_thread();
+    return NULL;
+}
+
+// Workers get the same stack size as the interpreter's own thread (if the
+// platform allows it), so tasks can nest calls as deeply as the script can
+static void start_workers(size_t count) {
+    pthread_attr_t attr;
+    bool attr_ready = pthread_attr_init(&attr) == 0;
+    bool sized =
+        attr_ready && pthread_attr_setstacksize(&attr, call_stack_size()) == 0;
+    if (pool_size == 0) {
+        // Running workers read this, so it can only change before any start
+        pool_stack_sized = sized;
+    }
+
+    while (pool_size < count) {
+        if (pthread_create(&pool_threads[pool_size],
+                           pool_stack_sized ? &attr : NULL, pool_worker,
+                           (void *)(pool_size + 1)) != 0) {
+            break; // run with the workers we have
+        }
+        pool_size++;
+    }
+
+    if (attr_ready) {
+        pthread_attr_destroy(&attr);
+    }
+}
+
+// ==================================================
+// RUNNING WORK
+// ==================================================
+
+/**
+ * @brief Runs `task` over the chunks of [0, count) on the worker pool, with
+ * the calling thread helping out, & returns once every chunk is done.
+ *
+ * While it runs, the collector is paused (allocation is locked instead) and
+ * `shared_env` & its ancestors are read-only to the tasks. Calls made from
+ * inside a task run their chunks inline on the same thread.
+ */
+void parallel_for(size_t count, size_t chunk_size, ParallelTask task,
+                  void *context, Environment *shared_env) {
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    size_t threads = parallel_thread_count();
+    if (threads > chunk_count) {
+        threads = chunk_count;
+    }
+    if (!in_task && threads > 1) {
+        start_workers(threads - 1);
+        if (threads > pool_size + 1) {
+            threads = pool_size + 1;
+        }
+    }
+
+    if (in_task || threads < 2) {
+        bool outer_in_task = in_task;
+        Environment *outer_shared_env = task_shared_env;
+        in_task = true;
+        task_shared_env = shared_env;
+        if (!outer_in_task) {
+            task_owner = new_task_owner();
+        }
+        for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+            size_t begin = chunk * chunk_size;
+            size_t end = begin + chunk_size;
+            task(context, chunk, begin, end < count ? end : count);
+        }
+        in_task = outer_in_task;
+        task_shared_env = outer_shared_env;
+        if (!outer_in_task) {
+            task_owner = 0;
+        }
+        return;
+    }
+
+    ParallelJob job = {.task = task,
+                       .context = context,
+                       .shared_env = shared_env,
+                       .count = count,
+                       .chunk_size = chunk_size,
+                       .participants = threads};
+    for (size_t t = 0; t < threads; t++) {
+        pthread_mutex_init(&job.queues[t].lock, NULL);
+        job.queues[t].next = chunk_count * t / threads;
+        job.queues[t].end = chunk_count * (t + 1) / threads;
+    }
+
+    gc_begin_parallel();
+
+    pthread_mutex_lock(&pool_lock);
+    pool_job = &job;
+    pool_generation++;
+    pool_busy = pool_size;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_chunks(&job, 0);
+
+    pthread_mutex_lock(&pool_lock);
+    while (pool_busy > 0) {
+        pthread_cond_wait(&pool_done, &pool_lock);
+    }
+    pool_job = NULL;
+    pthread_mutex_unlock(&pool_lock);
+
+    gc_end_parallel();
+
+    for (size_t t = 0; t < threads; t++) {
+        pthread_mutex_destroy(&job.queues[t].lock);
+    }
+}
+
+// Stops & joins the worker threads
+void parallel_shutdown(void) {
+    pthread_mutex_lock(&pool_lock);
+    pool_stopping = true;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (size_t i = 0; i < pool_size; i++) {
+        pthread_join(pool_threads[i], NULL);
+    }
+    pool_size = 0;
+    pool_stopping = false;
+}
@@ -0,0 +1,32 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Most threads a parallel operation uses (including the calling thread)
+#define PARALLEL_MAX_THREADS 64
+
+// Work is split into about this many chunks per thread, so threads that
+// finish early can steal from the others
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+// Processes one chunk: the indices [begin, end)
+typedef void (*ParallelTask)(void *context, size_t chunk, size_t begin,
+                             size_t end);
+
+// Configuration (0 threads means one per CPU)
+void parallel_configure(size_t threads);
+size_t parallel_thread_count(void);
+size_t parallel_chunk_size(size_t count);
+
+// Running work
+void parallel_for(size_t count, size_t chunk_size, ParallelTask task,
+                  void *context, Environment *shared_env);
+bool parallel_in_task(void);
+Environment *parallel_shared_environment(void);
+size_t parallel_task_owner(void);
+void parallel_shutdown(void);
+
+#endif
@@ -0,0 +1,78 @@
+#include "record.h"
+#include "gc.h"
+#include "parallel.h"
+#include "utils.h"
+
+RecordType *record_type_new(const char *name, char **field_names,
+                            const size_t *field_ids, size_t field_count) {
+    RecordType *type = malloc(sizeof(RecordType));
+    if (!type) {
+        fatal_error("Memory allocation failed for record type `%s`.\n", name);
+    }
+    type->name = safe_strdup(name);
+    type->field_count = field_count;
+    type->field_names = malloc(sizeof(char *) * field_count);
+    type->field_ids = malloc(sizeof(size_t) * field_count);
+    if (!type->field_names || !type->field_ids) {
+        fatal_error("Memory allocation failed for record type `%s`.\n", name);
+    }
+    for (size_t i = 0; i < field_count; i++) {
+        type->field_names[i] = safe_strdup(field_names[i]);
+        type->field_ids[i] = field_ids[i];
+    }
+    return type;
+}
+
+// Allocates a record with every field zeroed, in a single block
+RecordValue *record_new(const RecordType *type) {
+    size_t size = sizeof(RecordValue) + type->field_count * sizeof(LiteralValue);
+    RecordValue *record = gc_alloc(GC_RECORD, size);
+    memset(record, 0, size);
+    record->type = type;
+    record->owner = parallel_task_owner();
+    return record;
+}
+
+/**
+ * @brief Finds the slot of a field.
+ *
+ * @param type     The record's type.
+ * @param field_id The field name's parser-wide id.
+ * @param hint     The slot the parser resolved, or -1.
+ * @param slot     Receives the field's slot.
+ * @return bool False if the record has no such field.
+ */
+bool record_find_slot(const RecordType *type, size_t field_id, int hint,
+                      size_t *slot) {
+    // The parser's slot is right unless records disagree on the field
+    if (hint >= 0 && (size_t)hint < type->field_count &&
+        type->field_ids[hint] == field_id) {
+        *slot = (size_t)hint;
+        return true;
+    }
+    for (size_t i = 0; i < type->field_count; i++) {
+        if (type->field_ids[i] == field_id) {
+            *slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Finds a field by name, for built-ins that take field names as strings
+bool record_find_named_slot(const RecordType *type, const char *name,
+                            size_t *slot) {
+    for (size_t i = 0; i < type->field_count; i++) {
+        if (strcmp(type->field_names[i], name) == 0) {
+            *slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parallel tasks may read any record, but only modify records they created
+bool record_writable(const RecordValue *record) {
+    size_t owner = parallel_task_owner();
+    return owner == 0 || record->owner == owner;
+}
@@ -0,0 +1,22 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Creation
+RecordType *record_type_new(const char *name, char **field_names,
+                            const size_t *field_ids, size_t field_count);
+RecordValue *record_new(const RecordType *type);
+
+// Fields
+bool record_find_slot(const RecordType *type, size_t field_id, int hint,
+                      size_t *slot);
+bool record_find_named_slot(const RecordType *type, const char *name,
+                            size_t *slot);
+
+// Mutation
+bool record_writable(const RecordValue *record);
+
+#endif
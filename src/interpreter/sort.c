@@ -0,0 +1,508 @@
+#include "sort.h"
+#include "../shared/data_types.h"
+#include "array_ops.h"
+#include "flavor_string.h"
+#include "parallel.h"
+#include "utils.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef int (*SortCompare)(const void *left, const void *right);
+typedef void (*SortRun)(char *base, size_t count, size_t size,
+                        SortCompare compare);
+
+// What `sort_by()` sorts: each element's key & original position
+typedef struct {
+    LiteralValue key;
+    size_t index;
+} SortRecord;
+
+#define SORT_MAX_ELEMENT_SIZE sizeof(SortRecord)
+
+// ==================================================
+// COMPARISONS
+// ==================================================
+
+static int compare_ints(const void *left, const void *right) {
+    INT_SIZE l = *(const INT_SIZE *)left, r = *(const INT_SIZE *)right;
+    return (l > r) - (l < r);
+}
+
+static int compare_floats(const void *left, const void *right) {
+    FLOAT_SIZE l = *(const FLOAT_SIZE *)left, r = *(const FLOAT_SIZE *)right;
+    return (l > r) - (l < r);
+}
+
+static int compare_strings(const void *left, const void *right) {
+    return fl_string_compare(*(FlavorString *const *)left,
+                             *(FlavorString *const *)right);
+}
+
+static int compare_boxed_numbers(const void *left, const void *right) {
+    return compare_numbers(*(const LiteralValue *)left,
+                           *(const LiteralValue *)right);
+}
+
+// Keys are all numbers or all strings; ties keep the original order
+static int compare_records(const void *left, const void *right) {
+    const SortRecord *l = left, *r = right;
+    int order = l->key.type == TYPE_STRING
+                    ? fl_string_compare(l->key.data.string, r->key.data.string)
+                    : compare_numbers(l->key, r->key);
+    if (order != 0) {
+        return order;
+    }
+    return (l->index > r->index) - (l->index < r->index);
+}
+
+// ==================================================
+// SEQUENTIAL SORTS
+// ==================================================
+
+static void swap_elements(char *a, char *b, size_t size) {
+    char tmp[SORT_MAX_ELEMENT_SIZE];
+    memcpy(tmp, a, size);
+    memcpy(a, b, size);
+    memcpy(b, tmp, size);
+}
+
+static void insertion_sort(char *base, size_t count, size_t size,
+                           SortCompare compare) {
+    char tmp[SORT_MAX_ELEMENT_SIZE];
+    for (size_t i = 1; i < count; i++) {
+        memcpy(tmp, base + i * size, size);
+        size_t j = i;
+        while (j > 0 && compare(base + (j - 1) * size, tmp) > 0) {
+            memcpy(base + j * size, base + (j - 1) * size, size);
+            j--;
+        }
+        memcpy(base + j * size, tmp, size);
+    }
+}
+
+static void sift_down(char *base, size_t root, size_t count, size_t size,
+                      SortCompare compare) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= count) {
+            return;
+        }
+        if (child + 1 < count &&
+            compare(base + child * size, base + (child + 1) * size) < 0) {
+            child++;
+        }
+        if (compare(base + root * size, base + child * size) >= 0) {
+            return;
+        }
+        swap_elements(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+static void heap_sort(char *base, size_t count, size_t size,
+                      SortCompare compare) {
+    for (size_t i = count / 2; i > 0; i--) {
+        sift_down(base, i - 1, count, size, compare);
+    }
+    for (size_t end = count; end > 1; end--) {
+        swap_elements(base, base + (end - 1) * size, size);
+        sift_down(base, 0, end - 1, size, compare);
+    }
+}
+
+/**
+ * @brief Quicksort (median-of-three pivots, Hoare partitioning) that switches
+ * to heapsort once it recurses too deep, so the worst case stays
+ * O(n log n), & finishes small partitions with insertion sort.
+ */
+static void introsort_loop(char *base, size_t count, size_t size,
+                           SortCompare compare, size_t depth) {
+    char pivot[SORT_MAX_ELEMENT_SIZE];
+    while (count > SORT_INSERTION_THRESHOLD) {
+        if (depth == 0) {
+            heap_sort(base, count, size, compare);
+            return;
+        }
+        depth--;
+
+        char *first = base;
+        char *middle = base + (count / 2) * size;
+        char *last = base + (count - 1) * size;
+        if (compare(middle, first) < 0) {
+            swap_elements(middle, first, size);
+        }
+        if (compare(last, middle) < 0) {
+            swap_elements(last, middle, size);
+            if (compare(middle, first) < 0) {
+                swap_elements(middle, first, size);
+            }
+        }
+        memcpy(pivot, middle, size);
+
+        ptrdiff_t i = -1, j = (ptrdiff_t)count;
+        for (;;) {
+            do {
+                i++;
+            } while (compare(base + i * size, pivot) < 0);
+            do {
+                j--;
+            } while (compare(base + j * size, pivot) > 0);
+            if (i >= j) {
+                break;
+            }
+            swap_elements(base + i * size, base + j * size, size);
+        }
+
+        // Recurse into the smaller side & loop on the larger one, which
+        // bounds the stack depth
+        size_t split = (size_t)j + 1;
+        if (split < count - split) {
+            introsort_loop(base, split, size, compare, depth);
+            base += split * size;
+            count -= split;
+        } else {
+            introsort_loop(base + split * size, count - split, size, compare,
+                           depth);
+            count = split;
+        }
+    }
+    insertion_sort(base, count, size, compare);
+}
+
+static void introsort(char *base, size_t count, size_t size,
+                      SortCompare compare) {
+    size_t depth = 0;
+    for (size_t n = count; n > 1; n >>= 1) {
+        depth += 2;
+    }
+    introsort_loop(base, count, size, compare, depth);
+}
+
+// Flipping the sign bit makes negative numbers order before positive ones
+static unsigned radix_digit(INT_SIZE value, unsigned shift) {
+    unsigned long long key =
+        (unsigned long long)value ^
+        (1ULL << (sizeof(INT_SIZE) * CHAR_BIT - 1));
+    return (unsigned)(key >> shift) & 0xFF;
+}
+
+/**
+ * @brief Sorts integers with a least-significant-digit radix sort (one byte
+ * per pass), skipping passes where every element has the same digit.
+ */
+static void radix_sort(char *base, size_t count, size_t size,
+                       SortCompare compare) {
+    (void)size;    // always sizeof(INT_SIZE)
+    (void)compare; // not needed
+    if (count < SORT_INSERTION_THRESHOLD) {
+        insertion_sort(base, count, sizeof(INT_SIZE), compare_ints);
+        return;
+    }
+
+    INT_SIZE *src = (INT_SIZE *)base;
+    INT_SIZE *dst = malloc(count * sizeof(INT_SIZE));
+    if (!dst) {
+        fatal_error("Memory allocation failed while sorting.\n");
+    }
+    INT_SIZE *scratch = dst;
+
+    for (unsigned shift = 0; shift < sizeof(INT_SIZE) * CHAR_BIT; shift += 8) {
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < count; i++) {
+            offsets[radix_digit(src[i], shift)]++;
+        }
+        if (offsets[radix_digit(src[0], shift)] == count) {
+            continue;
+        }
+
+        size_t total = 0;
+        for (size_t digit = 0; digit < 256; digit++) {
+            size_t digit_count = offsets[digit];
+            offsets[digit] = total;
+            total += digit_count;
+        }
+        for (size_t i = 0; i < count; i++) {
+            dst[offsets[radix_digit(src[i], shift)]++] = src[i];
+        }
+
+        INT_SIZE *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != (INT_SIZE *)base) {
+        memcpy(base, src, count * sizeof(INT_SIZE));
+    }
+    free(scratch);
+}
+
+// ==================================================
+// PARALLEL MERGE SORT
+// ==================================================
+
+typedef struct {
+    SortRun sort_run;
+    SortCompare compare;
+    size_t size;
+
+    // Sorting a run
+    char *base;
+    size_t count;
+
+    // Merging two adjacent sorted runs into `out`
+    const char *left;
+    size_t left_count;
+    const char *right;
+    size_t right_count;
+    char *out;
+} SortJob;
+
+static void *sort_run_job(void *arg) {
+    SortJob *job = arg;
+    job->sort_run(job->base, job->count, job->size, job->compare);
+    return NULL;
+}
+
+// Stable: on ties, elements from the left run come first
+static void *merge_job(void *arg) {
+    SortJob *job = arg;
+    const char *left = job->left, *right = job->right;
+    const char *left_end = left + job->left_count * job->size;
+    const char *right_end = right + job->right_count * job->size;
+    char *out = job->out;
+
+    while (left < left_end && right < right_end) {
+        if (job->compare(left, right) <= 0) {
+            memcpy(out, left, job->size);
+            left += job->size;
+        } else {
+            memcpy(out, right, job->size);
+            right += job->size;
+        }
+        out += job->size;
+    }
+    memcpy(out, left, (size_t)(left_end - left));
+    out += left_end - left;
+    memcpy(out, right, (size_t)(right_end - right));
+    return NULL;
+}
+
+// Runs every job on its own thread (the first on the calling thread),
+// falling back to running a job inline if its thread can't be started
+static void run_jobs(SortJob *jobs, size_t count, void *(*work)(void *)) {
+    pthread_t threads[SORT_MAX_THREADS];
+    bool started[SORT_MAX_THREADS] = {false};
+
+    for (size_t i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, work, &jobs[i]) == 0;
+        if (!started[i]) {
+            work(&jobs[i]);
+        }
+    }
+    work(&jobs[0]);
+    for (size_t i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+// Follows `--threads`, capped since each run's merge needs its own buffer
+static size_t sort_thread_count(void) {
+    size_t threads = parallel_thread_count();
+    return threads < SORT_MAX_THREADS ? threads : SORT_MAX_THREADS;
+}
+
+/**
+ * @brief Sorts `count` elements of `size` bytes. Large inputs are split into
+ * one run per thread, each sorted with `sort_run` in parallel, then merged
+ * pairwise (each round's merges also running in parallel).
+ *
+ * Workers only touch the raw element bytes: they never allocate GC objects
+ * or run interpreter code.
+ */
+static void sort_elements(char *base, size_t count, size_t size,
+                          SortCompare compare, SortRun sort_run) {
+    size_t threads = sort_thread_count();
+    if (count < SORT_PARALLEL_THRESHOLD || threads < 2) {
+        sort_run(base, count, size, compare);
+        return;
+    }
+
+    SortJob jobs[SORT_MAX_THREADS];
+    size_t bounds[SORT_MAX_THREADS + 1];
+    for (size_t t = 0; t <= threads; t++) {
+        bounds[t] = count * t / threads;
+    }
+    for (size_t t = 0; t < threads; t++) {
+        jobs[t] = (SortJob){.sort_run = sort_run,
+                            .compare = compare,
+                            .size = size,
+                            .base = base + bounds[t] * size,
+                            .count = bounds[t + 1] - bounds[t]};
+    }
+    run_jobs(jobs, threads, sort_run_job);
+
+    char *scratch = malloc(count * size);
+    if (!scratch) {
+        fatal_error("Memory allocation failed while sorting.\n");
+    }
+    char *src = base, *dst = scratch;
+    size_t runs = threads;
+    while (runs > 1) {
+        size_t merged = 0;
+        for (size_t r = 0; r < runs; r += 2) {
+            // An odd run out is just copied across
+            size_t right_end = r + 1 < runs ? bounds[r + 2] : bounds[r + 1];
+            jobs[merged] =
+                (SortJob){.compare = compare,
+                          .size = size,
+                          .left = src + bounds[r] * size,
+                          .left_count = bounds[r + 1] - bounds[r],
+                          .right = src + bounds[r + 1] * size,
+                          .right_count = right_end - bounds[r + 1],
+                          .out = dst + bounds[r] * size};
+            bounds[merged++] = bounds[r];
+        }
+        bounds[merged] = count;
+        run_jobs(jobs, merged, merge_job);
+        runs = merged;
+
+        char *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != base) {
+        memcpy(base, src, count * size);
+    }
+    free(scratch);
+}
+
+// ==================================================
+// ARRAYS
+// ==================================================
+
+/**
+ * @brief Sorts an array of numbers or strings into a new array (of the same
+ * element kind), in ascending order.
+ */
+bool array_sort(const ArrayValue *array, ArrayValue *out) {
+    size_t count = array->count;
+    ArrayKind kind = array_kind(array);
+
+    // Typed arrays are sorted directly in the result's storage
+    if (kind == ARRAY_INT || kind == ARRAY_FLOAT) {
+        *out = array_new_typed(kind, count);
+        for (size_t i = 0; i < count; i++) {
+            array_push(out, array_get(array, i));
+        }
+        char *items = (char *)out->buffer->items;
+        if (kind == ARRAY_INT) {
+            sort_elements(items, count, sizeof(INT_SIZE), compare_ints,
+                          radix_sort);
+        } else {
+            sort_elements(items, count, sizeof(FLOAT_SIZE), compare_floats,
+                          introsort);
+        }
+        return true;
+    }
+    if (count == 0) {
+        *out = kind == ARRAY_BOXED ? array_new(0) : array_new_typed(kind, 0);
+        return true;
+    }
+    if (kind == ARRAY_BOOL) {
+        return false;
+    }
+
+    bool all_ints = true, all_numbers = true, all_strings = true;
+    for (size_t i = 0; i < count; i++) {
+        LiteralType type = array_get(array, i).type;
+        all_ints = all_ints && type == TYPE_INTEGER;
+        all_numbers = all_numbers && literal_is_number(array_get(array, i));
+        all_strings = all_strings && type == TYPE_STRING;
+    }
+    if (!all_numbers && !all_strings) {
+        return false;
+    }
+
+    *out = array_new(count);
+    LiteralValue *items = out->buffer->items;
+    for (size_t i = 0; i < count; i++) {
+        items[i] = array_get(array, i);
+    }
+    out->count = count;
+
+    if (all_numbers && !all_ints) {
+        sort_elements((char *)items, count, sizeof(LiteralValue),
+                      compare_boxed_numbers, introsort);
+        return true;
+    }
+
+    // Integers & strings are sorted as plain keys, then boxed again
+    size_t key_size = all_ints ? sizeof(INT_SIZE) : sizeof(FlavorString *);
+    char *keys = malloc(count * key_size);
+    if (!keys) {
+        fatal_error("Memory allocation failed while sorting.\n");
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (all_ints) {
+            ((INT_SIZE *)keys)[i] = items[i].data.integer;
+        } else {
+            ((FlavorString **)keys)[i] = items[i].data.string;
+        }
+    }
+    if (all_ints) {
+        sort_elements(keys, count, key_size, compare_ints, radix_sort);
+    } else {
+        sort_elements(keys, count, key_size, compare_strings, introsort);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (all_ints) {
+            items[i].data.integer = ((INT_SIZE *)keys)[i];
+        } else {
+            items[i].data.string = ((FlavorString **)keys)[i];
+        }
+    }
+    free(keys);
+    return true;
+}
+
+/**
+ * @brief Sorts an array by precomputed keys (one per element), into a new
+ * array of the same element kind. Elements with equal keys keep their order.
+ */
+bool array_sort_by_keys(const ArrayValue *array, const ArrayValue *keys,
+                        ArrayValue *out) {
+    size_t count = array->count;
+    bool all_numbers = true, all_strings = true;
+    for (size_t i = 0; i < count; i++) {
+        LiteralValue key = array_get(keys, i);
+        all_numbers = all_numbers && literal_is_number(key);
+        all_strings = all_strings && key.type == TYPE_STRING;
+    }
+    if (!all_numbers && !all_strings) {
+        return false;
+    }
+
+    SortRecord *records = malloc((count ? count : 1) * sizeof(SortRecord));
+    if (!records) {
+        fatal_error("Memory allocation failed while sorting.\n");
+    }
+    for (size_t i = 0; i < count; i++) {
+        records[i].key = array_get(keys, i);
+        records[i].index = i;
+    }
+    sort_elements((char *)records, count, sizeof(SortRecord), compare_records,
+                  introsort);
+
+    ArrayKind kind = array_kind(array);
+    *out = kind == ARRAY_BOXED ? array_new(count) : array_new_typed(kind, count);
+    for (size_t i = 0; i < count; i++) {
+        array_push(out, array_get(array, records[i].index));
+    }
+    free(records);
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "array.h"
+#include "interpreter_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Arrays at least this long are sorted in parallel (if there's more than one
+// CPU)
+#define SORT_PARALLEL_THRESHOLD 100000
+#define SORT_MAX_THREADS 8
+
+// Below this many elements, sorting falls back to insertion sort
+#define SORT_INSERTION_THRESHOLD 16
+
+// Both return false if the elements (or keys) can't be ordered together:
+// they must be all numbers or all strings
+bool array_sort(const ArrayValue *array, ArrayValue *out);
+bool array_sort_by_keys(const ArrayValue *array, const ArrayValue *keys,
+                        ArrayValue *out);
+
+#endif
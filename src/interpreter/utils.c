@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "memo.h"
 
 InterpretResult raise_error(const char *format, ...) {
     char error_message[1024];
@@ -15,13 +16,7 @@ InterpretResult raise_error(const char *format, ...) {
     // Create an error LiteralValue
     LiteralValue error_value;
     error_value.type = TYPE_ERROR;
-    error_value.data.string = strdup(error_message);
-
-    if (!error_value.data.string) {
-        fprintf(stderr,
-                "Error: Failed to allocate memory for error message.\n");
-        exit(1);
-    }
+    error_value.data.string = fl_string_new(error_message);
 
     InterpretResult res = {.value = error_value,
                            .did_return = false,
@@ -41,18 +36,15 @@ void fatal_error(const char *format, ...) {
     exit(1);
 }
 
-void initialize_builtin_function(Environment *env, const char *name) {
+void initialize_builtin_function(Environment *env, const BuiltinSpec *spec) {
+    const char *name = spec->name;
     Function func;
     memset(&func, 0, sizeof(Function)); // Zero out for safety
     func.name = safe_strdup(name);
     func.parameters = NULL;
     func.body = NULL;
     func.is_builtin = true;
-    if (strcmp(name, "cimport") == 0) {
-        func.c_function = builtin_cimport;
-    } else {
-        func.c_function = NULL;
-    }
+    func.builtin = spec;
     add_function(env, func);
 
     // Add a variable referencing this built-in function by name
@@ -70,15 +62,8 @@ void initialize_builtin_function(Environment *env, const char *name) {
 }
 
 void initialize_all_builtin_functions(Environment *env) {
-    const char *builtin_functions[] = {
-        "string",       "float",  "int",      "sample",     "serve",
-        "burn",         "random", "get_time", "taste_file", "plate_file",
-        "garnish_file", "length", "sleep",    "cimport",    "floor",
-        "ceil",         "round",  "abs"};
-
-    for (size_t i = 0;
-         i < sizeof(builtin_functions) / sizeof(builtin_functions[0]); i++) {
-        initialize_builtin_function(env, builtin_functions[i]);
+    for (size_t i = 0; i < builtin_spec_count; i++) {
+        initialize_builtin_function(env, &builtin_specs[i]);
     }
 }
 
@@ -107,6 +92,8 @@ void init_environment(Environment *env) {
     env->exported_count = 0;
     env->exported_capacity = 0;
 
+    gc_register_environment(env);
+
     // Initialize built-in functions ONLY for the GLOBAL environment
     initialize_all_builtin_functions(env);
 }
@@ -136,18 +123,21 @@ void init_environment_with_parent(Environment *env, Environment *parent) {
     env->exported_count = 0;
     env->exported_capacity = 0;
 
+    gc_register_environment(env);
+
     // Do NOT initialize built-in functions in local environments
 }
 
 // Free the environment and its resources
 void free_environment(Environment *env) {
-    // Free variables
+    gc_unregister_environment(env);
+    if (env->function_count > 0) {
+        functions_changed();
+    }
+
+    // Free variables (string & array values belong to the GC heap)
     for (size_t i = 0; i < env->variable_count; i++) {
         free(env->variables[i].variable_name);
-        if (env->variables[i].value.type == TYPE_STRING &&
-            env->variables[i].value.data.string) {
-            free(env->variables[i].value.data.string);
-        }
     }
     free(env->variables);
 
@@ -156,6 +146,8 @@ void free_environment(Environment *env) {
         // Free function name and parameters
         free(env->functions[i].name);
         free_parameter_list(env->functions[i].parameters);
+        memo_free(env->functions[i].memo);
+        free_names_free(env->functions[i].free_names);
         // Only free the AST if you’re completely done with it!
         if (!env->functions[i].is_builtin && env->functions[i].body) {
             free(env->functions[i].body);
@@ -257,6 +249,33 @@ ASTCaseNode *copy_ast_case_node(ASTCaseNode *case_node) {
     return new_head;
 }
 
+// Helper function for copying a parallel loop's ASTReduction linked list
+ASTReduction *copy_reductions(ASTReduction *reductions) {
+    ASTReduction *new_head = NULL, *new_tail = NULL;
+
+    while (reductions) {
+        ASTReduction *new_reduction = malloc(sizeof(ASTReduction));
+        if (!new_reduction) {
+            fatal_error("Memory allocation failed for ASTReduction.\n");
+        }
+
+        new_reduction->kind = reductions->kind;
+        new_reduction->variable_name = safe_strdup(reductions->variable_name);
+        new_reduction->next = NULL;
+
+        if (!new_head) {
+            new_head = new_tail = new_reduction;
+        } else {
+            new_tail->next = new_reduction;
+            new_tail = new_reduction;
+        }
+
+        reductions = reductions->next;
+    }
+
+    return new_head;
+}
+
 ASTNode *copy_ast_node(ASTNode *node) {
     if (!node) {
         return NULL;
@@ -265,6 +284,13 @@ ASTNode *copy_ast_node(ASTNode *node) {
     debug_print_int("Copying ASTNode of type %d at %p\n", node->type,
                     (void *)node);
 
+    // Copies start out unoptimized, so loop-invariant wrappers are dropped
+    if (node->type == AST_INVARIANT) {
+        ASTNode *expression = copy_ast_node(node->invariant.expression);
+        expression->next = copy_ast_node(node->next);
+        return expression;
+    }
+
     ASTNode *new_node = calloc(1, sizeof(ASTNode));
     if (!new_node) {
         fatal_error("Memory allocation failed in `copy_ast_node`\n");
@@ -369,6 +395,12 @@ ASTNode *copy_ast_node(ASTNode *node) {
         new_node->for_loop.end_expr = copy_ast_node(node->for_loop.end_expr);
         new_node->for_loop.inclusive = node->for_loop.inclusive;
         new_node->for_loop.step_expr = copy_ast_node(node->for_loop.step_expr);
+        new_node->for_loop.is_parallel = node->for_loop.is_parallel;
+        new_node->for_loop.reductions =
+            copy_reductions(node->for_loop.reductions);
+        new_node->for_loop.is_iterable_loop = node->for_loop.is_iterable_loop;
+        new_node->for_loop.collection_expr =
+            copy_ast_node(node->for_loop.collection_expr);
         new_node->for_loop.body = copy_ast_node(node->for_loop.body);
         break;
 
@@ -428,6 +460,53 @@ ASTNode *copy_ast_node(ASTNode *node) {
         }
         break;
 
+    case AST_MAP_LITERAL:
+        new_node->map_literal.count = node->map_literal.count;
+        new_node->map_literal.keys =
+            malloc(sizeof(ASTNode *) * (node->map_literal.count + 1));
+        new_node->map_literal.values =
+            malloc(sizeof(ASTNode *) * (node->map_literal.count + 1));
+        if (!new_node->map_literal.keys || !new_node->map_literal.values) {
+            fatal_error("Memory allocation failed for map literal entries.\n");
+        }
+        for (size_t i = 0; i < node->map_literal.count; i++) {
+            new_node->map_literal.keys[i] =
+                copy_ast_node(node->map_literal.keys[i]);
+            new_node->map_literal.values[i] =
+                copy_ast_node(node->map_literal.values[i]);
+        }
+        break;
+
+    case AST_RECORD_DECLARATION: {
+        size_t count = node->record_declaration.field_count;
+        new_node->record_declaration.name =
+            safe_strdup(node->record_declaration.name);
+        new_node->record_declaration.field_count = count;
+        new_node->record_declaration.field_names =
+            malloc(sizeof(char *) * (count + 1));
+        new_node->record_declaration.field_ids =
+            malloc(sizeof(size_t) * (count + 1));
+        if (!new_node->record_declaration.field_names ||
+            !new_node->record_declaration.field_ids) {
+            fatal_error("Memory allocation failed for record fields.\n");
+        }
+        for (size_t i = 0; i < count; i++) {
+            new_node->record_declaration.field_names[i] =
+                safe_strdup(node->record_declaration.field_names[i]);
+            new_node->record_declaration.field_ids[i] =
+                node->record_declaration.field_ids[i];
+        }
+        break;
+    }
+
+    case AST_FIELD_ACCESS:
+        new_node->field_access.object = copy_ast_node(node->field_access.object);
+        new_node->field_access.field_name =
+            safe_strdup(node->field_access.field_name);
+        new_node->field_access.field_id = node->field_access.field_id;
+        new_node->field_access.slot = node->field_access.slot;
+        break;
+
     case AST_ARRAY_OPERATION:
         new_node->array_operation.operator=
             safe_strdup(node->array_operation.operator);
@@ -442,6 +521,8 @@ ASTNode *copy_ast_node(ASTNode *node) {
             copy_ast_node(node->array_index_access.array);
         new_node->array_index_access.index =
             copy_ast_node(node->array_index_access.index);
+        new_node->array_index_access.column =
+            copy_ast_node(node->array_index_access.column);
         break;
 
     case AST_ARRAY_SLICE_ACCESS:
@@ -530,15 +611,35 @@ void add_function(Environment *env, Function func) {
     stored_func->body = copy_ast_node(func.body);
     stored_func->is_builtin = func.is_builtin;
     stored_func->c_function = func.c_function;
+    stored_func->builtin = func.builtin;
+    stored_func->record = func.record;
+    stored_func->memo = NULL; // Each declaration starts unmemoized
+    stored_func->free_names = NULL;
 
     stored_func->name = strdup(func.name);
     if (!stored_func->name) {
         fatal_error("Memory allocation failed for function name.\n");
     }
 
+    functions_changed();
     debug_print_int("Function `%s` added successfully.\n", stored_func->name);
 }
 
+// Counts changes to the set of declared functions (starting at 1, so a
+// zeroed call site cache never matches). Call sites cache the `Function *`
+// they resolved to along with this, since a new or freed function may change
+// what a name resolves to & moves or frees the other functions in its scope.
+static size_t functions_version = 1;
+
+size_t function_version(void) {
+    return __atomic_load_n(&functions_version, __ATOMIC_RELAXED);
+}
+
+// Invalidates every call site cache
+void functions_changed(void) {
+    __atomic_add_fetch(&functions_version, 1, __ATOMIC_RELAXED);
+}
+
 /**
  * Function to retrieve a function by name, traversing the environment chain.
  */
@@ -555,16 +656,6 @@ Function *get_function(Environment *env, const char *name) {
     return NULL;
 }
 
-// A helper to wrap `LiteralValue` in `InterpretResult`
-InterpretResult make_result(LiteralValue val, bool did_return, bool did_break) {
-    InterpretResult r;
-    r.value = val;
-    r.did_return = did_return;
-    r.did_break = did_break;
-    r.is_error = false;
-    return r;
-}
-
 bool is_valid_int(const char *str, INT_SIZE *out) {
     char *endptr;
     errno = 0;
@@ -579,7 +670,7 @@ bool is_valid_int(const char *str, INT_SIZE *out) {
 bool is_valid_float(const char *str, FLOAT_SIZE *out) {
     char *endptr;
     errno = 0;
-    long double val = strtold(str, &endptr);
+    FLOAT_SIZE val = FLOAT_PARSE(str, &endptr);
     if (errno != 0 || *endptr != '\0') {
         return false;
     }
@@ -605,10 +696,24 @@ const char *literal_type_to_string(LiteralType type) {
         return "boolean";
     case TYPE_STRING:
         return "string";
+    case TYPE_ARRAY:
+        return "array";
     case TYPE_FUNCTION:
         return "function";
     case TYPE_ERROR:
         return "error";
+    case TYPE_BUILDER:
+        return "builder";
+    case TYPE_MAP:
+        return "map";
+    case TYPE_HEAP:
+        return "heap";
+    case TYPE_RECORD:
+        return "record";
+    case TYPE_MATRIX:
+        return "matrix";
+    case TYPE_BITSET:
+        return "bitset";
     default:
         return "unknown";
     }
@@ -30,13 +30,49 @@ copy_function_parameters(ASTFunctionParameter *param_list);
 ASTNode *copy_ast_node(ASTNode *node);
 void add_function(Environment *env, Function func);
 Function *get_function(Environment *env, const char *name);
+size_t function_version(void);
+void functions_changed(void);
 
 // Helpers
-InterpretResult make_result(LiteralValue val, bool did_return, bool did_break);
 ASTCatchNode *copy_catch_node(ASTCatchNode *catch_node);
 ASTCaseNode *copy_ast_case_node(ASTCaseNode *case_node);
+ASTReduction *copy_reductions(ASTReduction *reductions);
 char *safe_strdup(const char *str);
 
+// Results (small enough to inline into every call site)
+// Wraps a `LiteralValue` in an `InterpretResult`
+static inline InterpretResult make_result(LiteralValue val, bool did_return,
+                                          bool did_break) {
+    InterpretResult r = {.value = val,
+                         .did_return = did_return,
+                         .did_break = did_break,
+                         .is_error = false};
+    return r;
+}
+
+// Unpacks an `InterpretResult` (from a built-in, say) into a result slot
+static inline ControlFlow result_to_flow(InterpretResult res,
+                                         LiteralValue *out) {
+    *out = res.value;
+    if (res.is_error) {
+        return FLOW_ERROR;
+    }
+    if (res.did_return) {
+        return FLOW_RETURN;
+    }
+    return res.did_break ? FLOW_BREAK : FLOW_NORMAL;
+}
+
+// Packs a status & its slot back into an `InterpretResult`
+static inline InterpretResult flow_to_result(ControlFlow flow,
+                                             LiteralValue value) {
+    InterpretResult r = {.value = value,
+                         .did_return = flow == FLOW_RETURN,
+                         .did_break = flow == FLOW_BREAK,
+                         .is_error = flow == FLOW_ERROR};
+    return r;
+}
+
 // Type Helpers
 bool is_numeric_type(LiteralType type);
 bool is_boolean_type(LiteralType type);
@@ -2,31 +2,33 @@
 #include <string.h>
 
 const char *KEYWORDS[] = {
-    "let",     // variable declaration
-    "const",   // constant declaration
-    "if",      // if
-    "elif",    // else if
-    "else",    // else
-    "for",     // for
-    "in",      // for in
-    "by",      // for in by
-    "while",   // while
-    "check",   // switch
-    "is",      // case
-    "break",   // break
-    "create",  // function
-    "deliver", // return
-    "try",     // try block
-    "rescue",  // catch block
-    "finish",  // finally block
-    "plate",   // write file
-    "garnish", // append file
-    "taste",   // read file
-    "True",    // Boolean True
-    "False",   // Boolean False
-    "import",  // Import `.flv` script
-    "export",  // Export identifiers in `.flv` script
-    NULL       // sentinel value
+    "let",      // variable declaration
+    "const",    // constant declaration
+    "if",       // if
+    "elif",     // else if
+    "else",     // else
+    "for",      // for
+    "in",       // for in
+    "by",       // for in by
+    "parallel", // for in parallel
+    "while",    // while
+    "check",    // switch
+    "is",       // case
+    "break",    // break
+    "create",   // function
+    "record",   // record (struct) declaration
+    "deliver",  // return
+    "try",      // try block
+    "rescue",   // catch block
+    "finish",   // finally block
+    "plate",    // write file
+    "garnish",  // append file
+    "taste",    // read file
+    "True",     // Boolean True
+    "False",    // Boolean False
+    "import",   // Import `.flv` script
+    "export",   // Export identifiers in `.flv` script
+    NULL        // sentinel value
 };
 
 const size_t KEYWORDS_COUNT =
@@ -34,7 +36,8 @@ const size_t KEYWORDS_COUNT =
 
 const char *OPERATORS[] = {
     "=", "==", "!=", "+",  "-",  "*",   "**", "/",  "//", "%",
-    "<", ">",  ">=", "<=", "..", "..=", "&&", "||", "!",  NULL // sentinel value
+    "<", ">",  ">=", "<=", "..", "..=", "&&", "||", "!",  "&",
+    "|", "^",  "~",  "<<", ">>", NULL // sentinel value
 };
 
 const size_t OPERATORS_COUNT =
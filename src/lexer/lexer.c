@@ -86,7 +86,7 @@ Token *tokenize(const char *source) {
         }
 
         // Operator
-        if (strchr("=+-*/<>!.%&|?:", c)) {
+        if (strchr("=+-*/<>!.%&|^~?:", c)) {
             scan_operator(&state, &tokens, &token_count, &capacity);
             continue;
         }
@@ -233,6 +233,20 @@ void scan_array(ScannerState *state, Token **tokens, size_t *token_count,
                 continue;
             }
 
+            // Handle braces (map literals, e.g. `[{"a": 1}]`)
+            if (inner_c == '{') {
+                append_token(tokens, token_count, capacity, TOKEN_BRACE_OPEN,
+                             "{", state->line);
+                state->pos++;
+                continue;
+            }
+            if (inner_c == '}') {
+                append_token(tokens, token_count, capacity, TOKEN_BRACE_CLOSE,
+                             "}", state->line);
+                state->pos++;
+                continue;
+            }
+
             // Handle separators `,`
             if (inner_c == ',') {
                 append_token(tokens, token_count, capacity, TOKEN_DELIMITER,
@@ -249,6 +263,12 @@ void scan_array(ScannerState *state, Token **tokens, size_t *token_count,
                 continue;
             }
 
+            // Handle the remaining operators (e.g. `bits[i >> 6]`)
+            if (strchr("=<>!*/%.?&|~", inner_c)) {
+                scan_operator(state, tokens, token_count, capacity);
+                continue;
+            }
+
             // Unexpected character
             fprintf(stderr,
                     "Unexpected character `%c` at position %zu (line %d)\n",
@@ -426,7 +446,9 @@ void scan_operator(ScannerState *state, Token **tokens, size_t *token_count,
             (first_char == '/' && second_char == '/') || // //
             (first_char == '*' && second_char == '*') || // **
             (first_char == '&' && second_char == '&') || // &&
-            (first_char == '|' && second_char == '|')) { // ||
+            (first_char == '|' && second_char == '|') || // ||
+            (first_char == '<' && second_char == '<') || // <<
+            (first_char == '>' && second_char == '>')) { // >>
             int length =
                 (third_char == '=' ? 3 : 2); // determine operator length
             char *lexeme = strndup(&state->source[state->pos], length);
@@ -439,7 +461,7 @@ void scan_operator(ScannerState *state, Token **tokens, size_t *token_count,
     }
 
     // Handle single-character operators
-    if (strchr("=<>!+-*/%.?", first_char)) {
+    if (strchr("=<>!+-*/%.?&|^~", first_char)) {
         char lexeme[2] = {first_char, '\0'};
         append_token(tokens, token_count, capacity, TOKEN_OPERATOR, lexeme,
                      state->line);
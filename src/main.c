@@ -3,6 +3,13 @@
 // Global variable to store the resolved plugin path
 char resolved_plugin_path[PATH_MAX] = {0};
 
+// Plugins must see the same float profile as the interpreter
+#ifdef FLAVOR_LONG_DOUBLE
+#define PLUGIN_PROFILE_FLAGS "-DFLAVOR_LONG_DOUBLE "
+#else
+#define PLUGIN_PROFILE_FLAGS ""
+#endif
+
 // Declare the embedded archive (generated by `xxd`)
 extern unsigned char headers_tar_gz[];
 extern unsigned int headers_tar_gz_len;
@@ -88,6 +95,15 @@ void print_usage(const char *prog_name) {
     printf("  <file.flv>       Run a FlavorLang script\n");
     printf("    --debug        Debug mode (verbose )\n");
     printf("    --minify       Minify a script (no --debug)\n");
+    printf("    --gc-stats     Print garbage collector stats on exit\n");
+    printf("    --gc-threshold <KiB>\n");
+    printf("                   Heap size that triggers a collection\n");
+    printf("    --threads <n>  Threads used by parallel built-ins\n");
+    printf("    --max-depth <n>\n");
+    printf("                   Deepest nesting of function calls (100000)\n");
+    printf("    --inline-size <n>\n");
+    printf("                   Largest function inlined (0 = off)\n");
+    printf("    --no-hoist     Don't hoist loop-invariant code\n");
     printf("\n");
     printf("  <file.c>         Build a C plugin\n");
     printf("    --make-plugin  Compile shared library\n");
@@ -118,6 +134,12 @@ void handle_cli_args(int argc, char *argv[], Options *options) {
     options->minify = false;
     options->make_plugin = false;
     options->filename = NULL;
+    options->gc_stats = false;
+    options->gc_threshold = GC_DEFAULT_THRESHOLD;
+    options->threads = 0;
+    options->max_depth = CALL_STACK_DEFAULT_DEPTH;
+    options->inline_size = INLINER_DEFAULT_SIZE;
+    options->hoist = true;
 
     // Process each argument
     for (int i = 1; i < argc; i++) {
@@ -157,6 +179,70 @@ void handle_cli_args(int argc, char *argv[], Options *options) {
                 exit(EXIT_FAILURE);
             }
             options->make_plugin = true;
+        } else if (strcmp(argv[i], "--gc-stats") == 0) {
+            options->gc_stats = true;
+        } else if (strcmp(argv[i], "--gc-threshold") == 0) {
+            char *end = NULL;
+            if (i + 1 >= argc || argv[i + 1][0] == '-') {
+                fprintf(stderr, "Error: --gc-threshold requires a size in "
+                                "KiB.\n");
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            unsigned long long kib = strtoull(argv[++i], &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Error: Invalid --gc-threshold '%s'.\n",
+                        argv[i]);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            options->gc_threshold = (size_t)kib * 1024;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            char *end = NULL;
+            if (i + 1 >= argc || argv[i + 1][0] == '-') {
+                fprintf(stderr, "Error: --threads requires a count.\n");
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            unsigned long long threads = strtoull(argv[++i], &end, 10);
+            if (*end != '\0' || threads == 0) {
+                fprintf(stderr, "Error: Invalid --threads '%s'.\n", argv[i]);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            options->threads = (size_t)threads;
+        } else if (strcmp(argv[i], "--max-depth") == 0) {
+            char *end = NULL;
+            if (i + 1 >= argc || argv[i + 1][0] == '-') {
+                fprintf(stderr, "Error: --max-depth requires a count.\n");
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            unsigned long long depth = strtoull(argv[++i], &end, 10);
+            if (*end != '\0' || depth == 0) {
+                fprintf(stderr, "Error: Invalid --max-depth '%s'.\n", argv[i]);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            options->max_depth = (size_t)depth;
+        } else if (strcmp(argv[i], "--inline-size") == 0) {
+            char *end = NULL;
+            if (i + 1 >= argc || argv[i + 1][0] == '-') {
+                fprintf(stderr, "Error: --inline-size requires a node "
+                                "count.\n");
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            unsigned long long size = strtoull(argv[++i], &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Error: Invalid --inline-size '%s'.\n",
+                        argv[i]);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            options->inline_size = (size_t)size;
+        } else if (strcmp(argv[i], "--no-hoist") == 0) {
+            options->hoist = false;
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "Error: Unknown option '%s'.\n", argv[i]);
             print_usage(argv[0]);
@@ -330,6 +416,20 @@ void open_url(const char *url) {
 #endif
 }
 
+// Interprets a parsed script in a fresh global environment
+void *run_script(void *arg) {
+    ScriptRun *run = arg;
+    Environment env;
+    init_environment(&env);
+    env.script_dir = strdup(run->script_dir);
+    interpret_program(run->ast, &env);
+    debug_print_basic("Execution complete!\n\n");
+
+    free_environment(&env);
+    gc_release_thread();
+    return NULL;
+}
+
 int main(int argc, char **argv) {
     Options options;
     handle_cli_args(argc, argv, &options);
@@ -378,7 +478,7 @@ int main(int argc, char **argv) {
         snprintf(
             command, sizeof(command),
             "gcc -fPIC -Wall -Wextra -O2 -shared -undefined dynamic_lookup "
-            "-I%s -I%s/shared -I%s/interpreter -I%s/lexer -I%s/parser "
+            PLUGIN_PROFILE_FLAGS "-I%s -I%s/shared -I%s/interpreter -I%s/lexer -I%s/parser "
             "-I%s/debug "
             "-o %s %s",
             temp_header_dir, temp_header_dir, temp_header_dir, temp_header_dir,
@@ -414,17 +514,28 @@ int main(int argc, char **argv) {
         debug_print_basic("Tokenization complete!\n\n");
         ASTNode *ast = parse_program(tokens);
         debug_print_basic("Parsing complete!\n\n");
-        Environment env;
-        init_environment(&env);
-        env.script_dir = strdup(script_dir);
-        interpret_program(ast, &env);
-        debug_print_basic("Execution complete!\n\n");
+        gc_configure(options.gc_threshold, options.gc_stats);
+        parallel_configure(options.threads);
+        call_stack_configure(options.max_depth);
+        inliner_configure(options.inline_size);
+        hoist_configure(options.hoist);
+
+        // Run on a thread with room for `--max-depth` nested calls (or on
+        // this one, if that can't be started, checking calls against what
+        // stack it has)
+        ScriptRun run = {.ast = ast, .script_dir = script_dir};
+        if (!call_stack_run(run_script, &run)) {
+            call_stack_attach_main();
+            run_script(&run);
+        }
 
         // Clean up memory
         free(tokens);
         free(source);
-        free_environment(&env);
         free_ast(ast);
+        parallel_shutdown();
+        gc_shutdown();
+        bindings_shutdown();
         debug_print_basic("Memory cleared!\n\n");
 
         return EXIT_SUCCESS;
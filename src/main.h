@@ -20,8 +20,20 @@ typedef struct {
     bool minify;
     char *filename;
     bool make_plugin;
+    bool gc_stats;
+    size_t gc_threshold; // in bytes
+    size_t threads;      // 0 = one per CPU
+    size_t max_depth;    // deepest nesting of function calls
+    size_t inline_size;  // largest function body inlined (0 = none)
+    bool hoist;          // hoist loop-invariant expressions
 } Options;
 
+// What the interpreter's thread needs to run a parsed script
+typedef struct {
+    ASTNode *ast;
+    const char *script_dir;
+} ScriptRun;
+
 void write_header_to_disk(const char *header_name, const char *content,
                           const char *output_dir);
 void extract_embedded_headers(const char *output_dir);
@@ -32,6 +44,7 @@ void minify_tokens(Token *tokens, const char *output_file);
 void print_logo(void);
 void print_about(void);
 void open_url(const char *url);
+void *run_script(void *arg);
 
 // Logo
 const char *FLAVOR_LOGO[] = {
@@ -157,6 +157,13 @@ ASTNode *parse_index_access(ASTNode *array, ParserState *state) {
         node->array_index_access.array = array;
         node->array_index_access.index = parse_expression(state);
 
+        // A second index (`m[i, j]`) picks a matrix element
+        if (get_current_token(state)->type == TOKEN_DELIMITER &&
+            strcmp(get_current_token(state)->lexeme, ",") == 0) {
+            advance_token(state);
+            node->array_index_access.column = parse_expression(state);
+        }
+
         // Expect and consume `]`
         expect_token(state, TOKEN_SQ_BRACKET_CLOSE,
                      "Expected `]` to close index expression");
@@ -0,0 +1,68 @@
+#include "map_parser.h"
+
+// Parses `{key: value, ...}` (keys & values are any expressions)
+ASTNode *parse_map_literal(ParserState *state) {
+    ASTNode *node = calloc(1, sizeof(ASTNode));
+    if (!node) {
+        parser_error("Memory allocation failed for map literal",
+                     get_current_token(state));
+    }
+    node->type = AST_MAP_LITERAL;
+    node->map_literal.count = 0;
+    node->next = NULL;
+
+    expect_token(state, TOKEN_BRACE_OPEN, "Expected `{` to start map literal");
+
+    // Initialize dynamic arrays for entries
+    size_t capacity = 4; // initial capacity
+    node->map_literal.keys = malloc(sizeof(ASTNode *) * capacity);
+    node->map_literal.values = malloc(sizeof(ASTNode *) * capacity);
+    if (!node->map_literal.keys || !node->map_literal.values) {
+        parser_error("Memory allocation failed for map entries",
+                     get_current_token(state));
+    }
+
+    while (get_current_token(state)->type != TOKEN_BRACE_CLOSE) {
+        ASTNode *key = parse_expression(state);
+        if (!key) {
+            parser_error("Failed to parse map key", get_current_token(state));
+        }
+        expect_token(state, TOKEN_COLON, "Expected `:` after map key");
+        ASTNode *value = parse_expression(state);
+        if (!value) {
+            parser_error("Failed to parse map value",
+                         get_current_token(state));
+        }
+
+        // Add the entry to the map
+        if (node->map_literal.count >= capacity) {
+            capacity *= 2;
+            ASTNode **new_keys =
+                realloc(node->map_literal.keys, sizeof(ASTNode *) * capacity);
+            ASTNode **new_values = realloc(node->map_literal.values,
+                                           sizeof(ASTNode *) * capacity);
+            if (!new_keys || !new_values) {
+                parser_error(
+                    "Memory allocation failed while resizing map entries",
+                    get_current_token(state));
+            }
+            node->map_literal.keys = new_keys;
+            node->map_literal.values = new_values;
+        }
+        node->map_literal.keys[node->map_literal.count] = key;
+        node->map_literal.values[node->map_literal.count] = value;
+        node->map_literal.count++;
+
+        // Check for comma `,` separator (a trailing one is allowed)
+        if (get_current_token(state)->type == TOKEN_DELIMITER &&
+            strcmp(get_current_token(state)->lexeme, ",") == 0) {
+            advance_token(state); // consume comma `,`
+        } else {
+            break;
+        }
+    }
+
+    expect_token(state, TOKEN_BRACE_CLOSE, "Expected `}` to close map literal");
+
+    return node;
+}
@@ -0,0 +1,12 @@
+#ifndef MAP_PARSER_H
+#define MAP_PARSER_H
+
+#include "../shared/ast_types.h"
+#include "../shared/token_types.h"
+#include "parser.h"
+#include "parser_state.h"
+#include "utils.h"
+
+ASTNode *parse_map_literal(ParserState *state);
+
+#endif
@@ -6,7 +6,9 @@
 
 #include "../shared/ast_types.h"
 #include "array_parser.h"
+#include "map_parser.h"
 #include "parser_state.h"
+#include "record_parser.h"
 
 // Implementation of the main expression parser
 ASTNode *parse_operator_expression(ParserState *state) {
@@ -83,7 +85,7 @@ ASTNode *parse_equality(ParserState *state) {
 
 // Comparison Operators: <, >, <=, >=
 ASTNode *parse_comparison(ParserState *state) {
-    ASTNode *node = parse_term(state);
+    ASTNode *node = parse_bitwise_or(state);
 
     while (match_operator(state, "<") || match_operator(state, ">") ||
            match_operator(state, "<=") || match_operator(state, ">=")) {
@@ -92,6 +94,75 @@ ASTNode *parse_comparison(ParserState *state) {
             parser_error("Memory allocation failed for operator",
                          state->current);
         }
+        ASTNode *right = parse_bitwise_or(state);
+        node = create_binary_op_node(operator, node, right);
+    }
+
+    return node;
+}
+
+// Bitwise OR: | (bitwise operators bind tighter than comparisons, so
+// `flags & MASK == 0` tests the masked bits)
+ASTNode *parse_bitwise_or(ParserState *state) {
+    ASTNode *node = parse_bitwise_xor(state);
+
+    while (match_operator(state, "|")) {
+        char *operator= strdup(state->previous->lexeme);
+        if (!operator) {
+            parser_error("Memory allocation failed for operator",
+                         state->current);
+        }
+        ASTNode *right = parse_bitwise_xor(state);
+        node = create_binary_op_node(operator, node, right);
+    }
+
+    return node;
+}
+
+// Bitwise XOR: ^
+ASTNode *parse_bitwise_xor(ParserState *state) {
+    ASTNode *node = parse_bitwise_and(state);
+
+    while (match_operator(state, "^")) {
+        char *operator= strdup(state->previous->lexeme);
+        if (!operator) {
+            parser_error("Memory allocation failed for operator",
+                         state->current);
+        }
+        ASTNode *right = parse_bitwise_and(state);
+        node = create_binary_op_node(operator, node, right);
+    }
+
+    return node;
+}
+
+// Bitwise AND: &
+ASTNode *parse_bitwise_and(ParserState *state) {
+    ASTNode *node = parse_shift(state);
+
+    while (match_operator(state, "&")) {
+        char *operator= strdup(state->previous->lexeme);
+        if (!operator) {
+            parser_error("Memory allocation failed for operator",
+                         state->current);
+        }
+        ASTNode *right = parse_shift(state);
+        node = create_binary_op_node(operator, node, right);
+    }
+
+    return node;
+}
+
+// Shift Operators: <<, >>
+ASTNode *parse_shift(ParserState *state) {
+    ASTNode *node = parse_term(state);
+
+    while (match_operator(state, "<<") || match_operator(state, ">>")) {
+        char *operator= strdup(state->previous->lexeme);
+        if (!operator) {
+            parser_error("Memory allocation failed for operator",
+                         state->current);
+        }
         ASTNode *right = parse_term(state);
         node = create_binary_op_node(operator, node, right);
     }
@@ -151,10 +222,10 @@ ASTNode *parse_power(ParserState *state) {
     return node;
 }
 
-// Unary Operators: -, +, !
+// Unary Operators: -, +, !, ~
 ASTNode *parse_unary(ParserState *state) {
     if (match_operator(state, "-") || match_operator(state, "+") ||
-        match_operator(state, "!")) {
+        match_operator(state, "!") || match_operator(state, "~")) {
         char *operator= strdup(state->previous->lexeme);
         if (!operator) {
             parser_error("Memory allocation failed for operator",
@@ -225,13 +296,23 @@ ASTNode *parse_primary(ParserState *state) {
     } else if (current->type == TOKEN_SQ_BRACKET_OPEN) {
         node = parse_array_literal(state);
         node->type = AST_ARRAY_LITERAL;
+    } else if (current->type == TOKEN_BRACE_OPEN) {
+        node = parse_map_literal(state);
     } else {
         parser_error("Expected expression", current);
     }
 
-    // Handle chained indexing/slicing
-    while (get_current_token(state)->type == TOKEN_SQ_BRACKET_OPEN) {
-        node = parse_index_access(node, state);
+    // Handle chained indexing/slicing & field access
+    for (;;) {
+        Token *postfix = get_current_token(state);
+        if (postfix->type == TOKEN_SQ_BRACKET_OPEN) {
+            node = parse_index_access(node, state);
+        } else if (postfix->type == TOKEN_OPERATOR &&
+                   strcmp(postfix->lexeme, ".") == 0) {
+            node = parse_field_access(node, state);
+        } else {
+            break;
+        }
     }
 
     // Handle chained function calls
@@ -341,7 +422,7 @@ ASTNode *create_literal_node(Token *token) {
         break;
     case TOKEN_FLOAT:
         node->literal.type = LITERAL_FLOAT;
-        node->literal.value.floating_point = atof(token->lexeme);
+        node->literal.value.floating_point = FLOAT_PARSE(token->lexeme, NULL);
         break;
     case TOKEN_STRING:
         node->literal.type = LITERAL_STRING;
@@ -12,6 +12,10 @@ ASTNode *parse_logical(ParserState *state);
 ASTNode *parse_ternary(ParserState *state);
 ASTNode *parse_equality(ParserState *state);
 ASTNode *parse_comparison(ParserState *state);
+ASTNode *parse_bitwise_or(ParserState *state);
+ASTNode *parse_bitwise_xor(ParserState *state);
+ASTNode *parse_bitwise_and(ParserState *state);
+ASTNode *parse_shift(ParserState *state);
 ASTNode *parse_term(ParserState *state);
 ASTNode *parse_factor(ParserState *state);
 ASTNode *parse_power(ParserState *state);
@@ -47,6 +47,8 @@ ASTNode *parse_statement(ParserState *state) {
         return parse_switch_block(state);
     if (match_token(state, "create"))
         return parse_function_declaration(state);
+    if (match_token(state, "record"))
+        return parse_record_declaration(state);
     if (match_token(state, "break"))
         return parse_break_statement(state);
     if (match_token(state, "deliver"))
@@ -239,7 +241,7 @@ ASTNode *parse_literal_or_identifier(ParserState *state) {
 
             if (next->type == TOKEN_FLOAT) {
                 node->literal.type = LITERAL_FLOAT;
-                node->literal.value.floating_point = -atof(next->lexeme);
+                node->literal.value.floating_point = -FLOAT_PARSE(next->lexeme, NULL);
             } else {
                 node->literal.type = LITERAL_INTEGER;
                 node->literal.value.integer = -atoi(next->lexeme);
@@ -267,7 +269,7 @@ ASTNode *parse_literal_or_identifier(ParserState *state) {
 
         if (current->type == TOKEN_FLOAT) {
             node->literal.type = LITERAL_FLOAT;
-            node->literal.value.floating_point = atof(current->lexeme);
+            node->literal.value.floating_point = FLOAT_PARSE(current->lexeme, NULL);
         } else if (current->type == TOKEN_INTEGER) {
             node->literal.type = LITERAL_INTEGER;
             node->literal.value.integer = atoi(current->lexeme);
@@ -550,6 +552,18 @@ ASTNode *parse_for_loop(ParserState *state) {
             debug_print_par("Parsed step expression\n");
         }
 
+        // Optional: parse `parallel` & its reductions
+        bool is_parallel = false;
+        ASTReduction *reductions = NULL;
+        Token *maybe_parallel = get_current_token(state);
+        if (maybe_parallel->type == TOKEN_KEYWORD &&
+            strcmp(maybe_parallel->lexeme, "parallel") == 0) {
+            debug_print_par("Found `parallel` keyword\n");
+            advance_token(state); // consume `parallel`
+            is_parallel = true;
+            reductions = parse_reductions(state);
+        }
+
         // Parse loop body
         expect_token(state, TOKEN_BRACE_OPEN,
                      "Expected `{` delimiter to start loop body");
@@ -568,6 +582,8 @@ ASTNode *parse_for_loop(ParserState *state) {
         node->for_loop.end_expr = end_expr;
         node->for_loop.inclusive = inclusive;
         node->for_loop.step_expr = step_expr;
+        node->for_loop.is_parallel = is_parallel;
+        node->for_loop.reductions = reductions;
         node->for_loop.body = body;
     } else {
         // ---------------------------
@@ -583,6 +599,13 @@ ASTNode *parse_for_loop(ParserState *state) {
         }
         debug_print_par("Parsed collection expression for iterable loop\n");
 
+        Token *maybe_parallel = get_current_token(state);
+        if (maybe_parallel->type == TOKEN_KEYWORD &&
+            strcmp(maybe_parallel->lexeme, "parallel") == 0) {
+            parser_error("Parallel `for` loops must iterate over a range",
+                         maybe_parallel);
+        }
+
         // Parse loop body
         expect_token(state, TOKEN_BRACE_OPEN,
                      "Expected `{` delimiter to start loop body");
@@ -606,6 +629,66 @@ ASTNode *parse_for_loop(ParserState *state) {
     return node;
 }
 
+// Parses a parallel loop's reductions, e.g. `sum(total), max(best)`
+ASTReduction *parse_reductions(ParserState *state) {
+    ASTReduction *head = NULL;
+    ASTReduction *tail = NULL;
+
+    while (get_current_token(state)->type != TOKEN_BRACE_OPEN) {
+        Token *kind_token = get_current_token(state);
+        ReductionKind kind;
+        if (strcmp(kind_token->lexeme, "sum") == 0) {
+            kind = REDUCE_SUM;
+        } else if (strcmp(kind_token->lexeme, "min") == 0) {
+            kind = REDUCE_MIN;
+        } else if (strcmp(kind_token->lexeme, "max") == 0) {
+            kind = REDUCE_MAX;
+        } else if (strcmp(kind_token->lexeme, "append") == 0) {
+            kind = REDUCE_APPEND;
+        } else {
+            parser_error("Expected `sum`, `min`, `max` or `append` reduction",
+                         kind_token);
+        }
+        advance_token(state); // consume reduction kind
+
+        expect_token(state, TOKEN_PAREN_OPEN, "Expected `(` after reduction");
+        Token *name = get_current_token(state);
+        if (name->type != TOKEN_IDENTIFIER) {
+            parser_error("Expected variable name in reduction", name);
+        }
+
+        ASTReduction *reduction = calloc(1, sizeof(ASTReduction));
+        if (!reduction) {
+            parser_error("Memory allocation failed for reduction", name);
+        }
+        reduction->kind = kind;
+        reduction->variable_name = strdup(name->lexeme);
+        if (!reduction->variable_name) {
+            parser_error("Memory allocation failed for reduction variable",
+                         name);
+        }
+        debug_print_par("Reduction variable: %s\n", reduction->variable_name);
+        advance_token(state); // consume variable name
+        expect_token(state, TOKEN_PAREN_CLOSE,
+                     "Expected `)` after reduction variable");
+
+        if (!head) {
+            head = reduction;
+        } else {
+            tail->next = reduction;
+        }
+        tail = reduction;
+
+        // Check for comma (indicates another reduction)
+        if (get_current_token(state)->type == TOKEN_DELIMITER &&
+            strcmp(get_current_token(state)->lexeme, ",") == 0) {
+            advance_token(state); // consume `,`
+        }
+    }
+
+    return head;
+}
+
 ASTNode *parse_break_statement(ParserState *state) {
     expect_token(state, TOKEN_KEYWORD, "Expected `break` keyword");
     expect_token(state, TOKEN_DELIMITER, "Expected `;` after break");
@@ -997,6 +1080,7 @@ Token *peek_ahead(ParserState *state, size_t n) {
  * An assignment can be:
  * - identifier = expression
  * - identifier [ array_operator ] = expression
+ * - identifier . field = expression (mixed with indices, e.g. `a[0].x = 1`)
  *
  * @param state The current parser state.
  * @return `true` if it's an assignment, `false` otherwise.
@@ -1010,8 +1094,17 @@ bool is_assignment(ParserState *state) {
     size_t temp_token = state->current_token + 1;
     Token *tokens = state->tokens;
 
-    // Traverse any number of `[ expression ]` sequences
-    while (tokens[temp_token].type == TOKEN_SQ_BRACKET_OPEN) {
+    // Traverse any number of `[ expression ]` & `.field` sequences
+    while (tokens[temp_token].type == TOKEN_SQ_BRACKET_OPEN ||
+           (tokens[temp_token].type == TOKEN_OPERATOR &&
+            strcmp(tokens[temp_token].lexeme, ".") == 0)) {
+        if (tokens[temp_token].type == TOKEN_OPERATOR) {
+            if (tokens[temp_token + 1].type != TOKEN_IDENTIFIER) {
+                return false;
+            }
+            temp_token += 2; // consume `.` & field name
+            continue;
+        }
         temp_token++; // consume `[`
 
         // Traverse tokens until `]` is found
@@ -1071,9 +1164,13 @@ ASTNode *parse_export_statement(ParserState *state) {
     } else if (current->type == TOKEN_KEYWORD &&
                strcmp(current->lexeme, "create") == 0) {
         decl = parse_function_declaration(state);
+    } else if (current->type == TOKEN_KEYWORD &&
+               strcmp(current->lexeme, "record") == 0) {
+        decl = parse_record_declaration(state);
     } else {
-        parser_error("Expected `let`, `const`, or `create` after `export`",
-                     current);
+        parser_error(
+            "Expected `let`, `const`, `create` or `record` after `export`",
+            current);
     }
 
     // Wrap declaration in AST_EXPORT
@@ -5,6 +5,7 @@
 #include "array_parser.h"
 #include "operator_parser.h"
 #include "parser_state.h"
+#include "record_parser.h"
 
 // Main parsing functions
 ASTNode *parse_program(Token *tokens);
@@ -21,6 +22,7 @@ ASTNode *parse_variable_assignment(ParserState *state);
 ASTNode *parse_conditional_block(ParserState *state);
 ASTNode *parse_while_loop(ParserState *state);
 ASTNode *parse_for_loop(ParserState *state);
+ASTReduction *parse_reductions(ParserState *state);
 ASTNode *parse_break_statement(ParserState *state);
 ASTNode *parse_switch_block(ParserState *state);
 ASTNode *parse_function_declaration(ParserState *state);
@@ -0,0 +1,191 @@
+#include "record_parser.h"
+
+// Every field name the parser sees gets an id, shared by all records, so the
+// interpreter can match fields by comparing integers
+static char **field_names = NULL;
+static size_t field_name_count = 0;
+static size_t field_name_capacity = 0;
+
+// Layouts of the records declared so far, used to resolve field slots
+typedef struct {
+    size_t *field_ids;
+    size_t field_count;
+} RecordLayout;
+
+static RecordLayout *layouts = NULL;
+static size_t layout_count = 0;
+static size_t layout_capacity = 0;
+
+size_t record_field_id(const char *name) {
+    for (size_t i = 0; i < field_name_count; i++) {
+        if (strcmp(field_names[i], name) == 0) {
+            return i;
+        }
+    }
+
+    if (field_name_count == field_name_capacity) {
+        size_t new_capacity = field_name_capacity ? field_name_capacity * 2 : 16;
+        char **grown = realloc(field_names, new_capacity * sizeof(char *));
+        if (!grown) {
+            parser_error("Memory allocation failed for field names", NULL);
+        }
+        field_names = grown;
+        field_name_capacity = new_capacity;
+    }
+    field_names[field_name_count] = strdup(name);
+    if (!field_names[field_name_count]) {
+        parser_error("Memory allocation failed for field name", NULL);
+    }
+    return field_name_count++;
+}
+
+void record_register_layout(const size_t *field_ids, size_t field_count) {
+    if (layout_count == layout_capacity) {
+        size_t new_capacity = layout_capacity ? layout_capacity * 2 : 8;
+        RecordLayout *grown =
+            realloc(layouts, new_capacity * sizeof(RecordLayout));
+        if (!grown) {
+            parser_error("Memory allocation failed for record layouts", NULL);
+        }
+        layouts = grown;
+        layout_capacity = new_capacity;
+    }
+
+    RecordLayout *layout = &layouts[layout_count++];
+    layout->field_ids = malloc(sizeof(size_t) * (field_count + 1));
+    if (!layout->field_ids) {
+        parser_error("Memory allocation failed for record layout", NULL);
+    }
+    memcpy(layout->field_ids, field_ids, sizeof(size_t) * field_count);
+    layout->field_count = field_count;
+}
+
+/**
+ * @brief Resolves the slot of a field at parse time.
+ *
+ * @param field_id The field name's id.
+ * @return int The slot the field has in every record declared so far that
+ * has it, or -1 if no record has it or records disagree (the interpreter
+ * then looks it up by id).
+ */
+int record_field_slot(size_t field_id) {
+    int slot = -1;
+    for (size_t i = 0; i < layout_count; i++) {
+        for (size_t j = 0; j < layouts[i].field_count; j++) {
+            if (layouts[i].field_ids[j] != field_id) {
+                continue;
+            }
+            if (slot != -1 && slot != (int)j) {
+                return -1;
+            }
+            slot = (int)j;
+        }
+    }
+    return slot;
+}
+
+// Parses `record Name { field, ... }`
+ASTNode *parse_record_declaration(ParserState *state) {
+    expect_token(state, TOKEN_KEYWORD, "Expected `record` keyword");
+
+    Token *name = get_current_token(state);
+    if (name->type != TOKEN_IDENTIFIER) {
+        parser_error("Expected record name after `record`", name);
+    }
+
+    ASTNode *node = calloc(1, sizeof(ASTNode));
+    if (!node) {
+        parser_error("Memory allocation failed for record declaration", name);
+    }
+    node->type = AST_RECORD_DECLARATION;
+    node->record_declaration.name = strdup(name->lexeme);
+    node->next = NULL;
+    advance_token(state); // consume name
+
+    expect_token(state, TOKEN_BRACE_OPEN, "Expected `{` after record name");
+
+    size_t capacity = 4; // initial capacity
+    char **names = malloc(sizeof(char *) * capacity);
+    size_t *ids = malloc(sizeof(size_t) * capacity);
+    size_t count = 0;
+    if (!node->record_declaration.name || !names || !ids) {
+        parser_error("Memory allocation failed for record fields", name);
+    }
+
+    while (get_current_token(state)->type != TOKEN_BRACE_CLOSE) {
+        Token *field = get_current_token(state);
+        if (field->type != TOKEN_IDENTIFIER) {
+            parser_error("Expected field name in record declaration", field);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(names[i], field->lexeme) == 0) {
+                parser_error("Duplicate field in record declaration", field);
+            }
+        }
+
+        if (count >= capacity) {
+            capacity *= 2;
+            char **new_names = realloc(names, sizeof(char *) * capacity);
+            size_t *new_ids = realloc(ids, sizeof(size_t) * capacity);
+            if (!new_names || !new_ids) {
+                parser_error("Memory allocation failed while resizing record "
+                             "fields",
+                             field);
+            }
+            names = new_names;
+            ids = new_ids;
+        }
+        names[count] = strdup(field->lexeme);
+        ids[count] = record_field_id(field->lexeme);
+        count++;
+        advance_token(state); // consume field name
+
+        // Check for comma `,` separator (a trailing one is allowed)
+        if (get_current_token(state)->type == TOKEN_DELIMITER &&
+            strcmp(get_current_token(state)->lexeme, ",") == 0) {
+            advance_token(state); // consume comma `,`
+        } else {
+            break;
+        }
+    }
+
+    expect_token(state, TOKEN_BRACE_CLOSE,
+                 "Expected `}` to close record declaration");
+    if (count == 0) {
+        parser_error("Records need at least one field", name);
+    }
+
+    node->record_declaration.field_names = names;
+    node->record_declaration.field_ids = ids;
+    node->record_declaration.field_count = count;
+    record_register_layout(ids, count);
+
+    return node;
+}
+
+// Parses `.field` after `object`
+ASTNode *parse_field_access(ASTNode *object, ParserState *state) {
+    advance_token(state); // consume `.`
+
+    Token *field = get_current_token(state);
+    if (field->type != TOKEN_IDENTIFIER) {
+        parser_error("Expected field name after `.`", field);
+    }
+
+    ASTNode *node = calloc(1, sizeof(ASTNode));
+    if (!node) {
+        parser_error("Memory allocation failed for field access", field);
+    }
+    node->type = AST_FIELD_ACCESS;
+    node->field_access.object = object;
+    node->field_access.field_name = strdup(field->lexeme);
+    if (!node->field_access.field_name) {
+        parser_error("Memory allocation failed for field name", field);
+    }
+    node->field_access.field_id = record_field_id(field->lexeme);
+    node->field_access.slot = record_field_slot(node->field_access.field_id);
+    node->next = NULL;
+    advance_token(state); // consume field name
+
+    return node;
+}
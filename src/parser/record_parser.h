@@ -0,0 +1,18 @@
+#ifndef RECORD_PARSER_H
+#define RECORD_PARSER_H
+
+#include "../shared/ast_types.h"
+#include "../shared/token_types.h"
+#include "parser.h"
+#include "parser_state.h"
+#include "utils.h"
+
+ASTNode *parse_record_declaration(ParserState *state);
+ASTNode *parse_field_access(ASTNode *object, ParserState *state);
+
+// Field layouts
+size_t record_field_id(const char *name);
+void record_register_layout(const size_t *field_ids, size_t field_count);
+int record_field_slot(size_t field_id);
+
+#endif
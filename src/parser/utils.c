@@ -43,7 +43,17 @@ void free_ast(ASTNode *node) {
             free_ast(node->for_loop.start_expr);
             free_ast(node->for_loop.end_expr);
             free_ast(node->for_loop.step_expr);
+            free_ast(node->for_loop.collection_expr);
             free_ast(node->for_loop.body);
+            {
+                ASTReduction *reduction = node->for_loop.reductions;
+                while (reduction) {
+                    ASTReduction *next = reduction->next;
+                    free(reduction->variable_name);
+                    free(reduction);
+                    reduction = next;
+                }
+            }
             break;
 
         case AST_VAR_DECLARATION:
@@ -75,6 +85,7 @@ void free_ast(ASTNode *node) {
             if (node->function_call.arguments) {
                 free_ast(node->function_call.arguments);
             }
+            free_ast(node->function_call.inlined_body);
             break;
 
         case AST_FUNCTION_RETURN:
@@ -128,6 +139,29 @@ void free_ast(ASTNode *node) {
             free(node->array_literal.elements);
             break;
 
+        case AST_MAP_LITERAL:
+            for (size_t i = 0; i < node->map_literal.count; i++) {
+                free_ast(node->map_literal.keys[i]);
+                free_ast(node->map_literal.values[i]);
+            }
+            free(node->map_literal.keys);
+            free(node->map_literal.values);
+            break;
+
+        case AST_RECORD_DECLARATION:
+            free(node->record_declaration.name);
+            for (size_t i = 0; i < node->record_declaration.field_count; i++) {
+                free(node->record_declaration.field_names[i]);
+            }
+            free(node->record_declaration.field_names);
+            free(node->record_declaration.field_ids);
+            break;
+
+        case AST_FIELD_ACCESS:
+            free_ast(node->field_access.object);
+            free(node->field_access.field_name);
+            break;
+
         case AST_ARRAY_OPERATION:
             free(node->array_operation.operator);
             free_ast(node->array_operation.array);
@@ -136,6 +170,7 @@ void free_ast(ASTNode *node) {
         case AST_ARRAY_INDEX_ACCESS:
             free_ast(node->array_index_access.array);
             free_ast(node->array_index_access.index);
+            free_ast(node->array_index_access.column);
             break;
 
         case AST_ARRAY_SLICE_ACCESS:
@@ -150,6 +185,7 @@ void free_ast(ASTNode *node) {
         case AST_FINALLY:
         case AST_VARIABLE_REFERENCE:
         case AST_BREAK:
+        case AST_INLINE_ARGUMENT:
             // No dynamic memory to free
             break;
 
@@ -161,6 +197,10 @@ void free_ast(ASTNode *node) {
             free_ast(node->export.decl);
             break;
 
+        case AST_INVARIANT:
+            free_ast(node->invariant.expression);
+            break;
+
         default:
             fprintf(stderr, "Unknown ASTNode type `%d` in free_ast.\n",
                     node->type);
@@ -172,6 +212,133 @@ void free_ast(ASTNode *node) {
     }
 }
 
+// Visits every node of a list (a block's statements, say). Each node is
+// reached through the slot pointing at it, so the visitor can swap it out as
+// long as the replacement keeps its `next`.
+static void ast_visit_list(ASTNode **slot, ASTChildVisitor visit,
+                           void *context) {
+    while (*slot) {
+        visit(slot, context);
+        slot = &(*slot)->next;
+    }
+}
+
+/**
+ * @brief Calls `visit` on each child of `node`: its expressions & every
+ * statement of its blocks. `node->next` isn't visited.
+ *
+ * @param node    The parent node.
+ * @param visit   Called with the slot holding each child.
+ * @param context Passed through to `visit`.
+ */
+void ast_for_each_child(ASTNode *node, ASTChildVisitor visit, void *context) {
+    switch (node->type) {
+    case AST_VAR_DECLARATION:
+        ast_visit_list(&node->var_declaration.initializer, visit, context);
+        break;
+    case AST_CONST_DECLARATION:
+        ast_visit_list(&node->const_declaration.initializer, visit, context);
+        break;
+    case AST_ASSIGNMENT:
+        ast_visit_list(&node->assignment.lhs, visit, context);
+        ast_visit_list(&node->assignment.rhs, visit, context);
+        break;
+    case AST_FUNCTION_DECLARATION:
+        ast_visit_list(&node->function_declaration.body, visit, context);
+        break;
+    case AST_FUNCTION_CALL:
+        ast_visit_list(&node->function_call.function_ref, visit, context);
+        ast_visit_list(&node->function_call.arguments, visit, context);
+        break;
+    case AST_FUNCTION_RETURN:
+        ast_visit_list(&node->function_return.return_data, visit, context);
+        break;
+    case AST_CONDITIONAL:
+        ast_visit_list(&node->conditional.condition, visit, context);
+        ast_visit_list(&node->conditional.body, visit, context);
+        ast_visit_list(&node->conditional.else_branch, visit, context);
+        break;
+    case AST_UNARY_OP:
+        ast_visit_list(&node->unary_op.operand, visit, context);
+        break;
+    case AST_BINARY_OP:
+        ast_visit_list(&node->binary_op.left, visit, context);
+        ast_visit_list(&node->binary_op.right, visit, context);
+        break;
+    case AST_WHILE_LOOP:
+        ast_visit_list(&node->while_loop.condition, visit, context);
+        ast_visit_list(&node->while_loop.body, visit, context);
+        break;
+    case AST_FOR_LOOP:
+        ast_visit_list(&node->for_loop.start_expr, visit, context);
+        ast_visit_list(&node->for_loop.end_expr, visit, context);
+        ast_visit_list(&node->for_loop.step_expr, visit, context);
+        ast_visit_list(&node->for_loop.collection_expr, visit, context);
+        ast_visit_list(&node->for_loop.body, visit, context);
+        break;
+    case AST_SWITCH:
+        ast_visit_list(&node->switch_case.expression, visit, context);
+        for (ASTCaseNode *case_node = node->switch_case.cases; case_node;
+             case_node = case_node->next) {
+            ast_visit_list(&case_node->condition, visit, context);
+            ast_visit_list(&case_node->body, visit, context);
+        }
+        break;
+    case AST_TERNARY:
+        ast_visit_list(&node->ternary.condition, visit, context);
+        ast_visit_list(&node->ternary.true_expr, visit, context);
+        ast_visit_list(&node->ternary.false_expr, visit, context);
+        break;
+    case AST_TRY:
+        ast_visit_list(&node->try_block.try_block, visit, context);
+        for (ASTCatchNode *catch_node = node->try_block.catch_blocks;
+             catch_node; catch_node = catch_node->next) {
+            ast_visit_list(&catch_node->body, visit, context);
+        }
+        ast_visit_list(&node->try_block.finally_block, visit, context);
+        break;
+    case AST_ARRAY_LITERAL:
+        // Elements are held in an array, so each is visited on its own
+        for (size_t i = 0; i < node->array_literal.count; i++) {
+            visit(&node->array_literal.elements[i], context);
+        }
+        break;
+    case AST_ARRAY_OPERATION:
+        ast_visit_list(&node->array_operation.array, visit, context);
+        ast_visit_list(&node->array_operation.operand, visit, context);
+        break;
+    case AST_ARRAY_INDEX_ACCESS:
+        ast_visit_list(&node->array_index_access.array, visit, context);
+        ast_visit_list(&node->array_index_access.index, visit, context);
+        ast_visit_list(&node->array_index_access.column, visit, context);
+        break;
+    case AST_ARRAY_SLICE_ACCESS:
+        ast_visit_list(&node->array_slice_access.array, visit, context);
+        ast_visit_list(&node->array_slice_access.start, visit, context);
+        ast_visit_list(&node->array_slice_access.end, visit, context);
+        ast_visit_list(&node->array_slice_access.step, visit, context);
+        break;
+    case AST_MAP_LITERAL:
+        for (size_t i = 0; i < node->map_literal.count; i++) {
+            visit(&node->map_literal.keys[i], context);
+            visit(&node->map_literal.values[i], context);
+        }
+        break;
+    case AST_FIELD_ACCESS:
+        ast_visit_list(&node->field_access.object, visit, context);
+        break;
+    case AST_EXPORT:
+        ast_visit_list(&node->export.decl, visit, context);
+        break;
+    case AST_INVARIANT:
+        ast_visit_list(&node->invariant.expression, visit, context);
+        break;
+    default:
+        // Literals, references, `break`, imports & record declarations
+        break;
+    }
+}
+
 // Print indentation based on depth
 void print_indent(int depth) {
     for (int i = 0; i < depth; i++) {
@@ -344,6 +511,15 @@ void print_ast(ASTNode *node, int depth) {
                     printf("Step Expression:\n");
                     print_ast(node->for_loop.step_expr, depth + 2);
                 }
+                if (node->for_loop.is_parallel) {
+                    print_indent(depth + 1);
+                    printf("Parallel: true\n");
+                    for (ASTReduction *reduction = node->for_loop.reductions;
+                         reduction; reduction = reduction->next) {
+                        print_indent(depth + 2);
+                        printf("Reduction: %s\n", reduction->variable_name);
+                    }
+                }
                 print_indent(depth + 1);
                 printf("Body:\n");
                 print_ast(node->for_loop.body, depth + 2);
@@ -429,6 +605,39 @@ void print_ast(ASTNode *node, int depth) {
                 printf("]\n");
                 break;
 
+            case AST_MAP_LITERAL:
+                printf("Map Literal: {\n");
+                for (size_t i = 0; i < node->map_literal.count; i++) {
+                    print_indent(depth + 1);
+                    printf("Key:\n");
+                    print_ast(node->map_literal.keys[i], depth + 2);
+                    print_indent(depth + 1);
+                    printf("Value:\n");
+                    print_ast(node->map_literal.values[i], depth + 2);
+                }
+                print_indent(depth);
+                printf("}\n");
+                break;
+
+            case AST_RECORD_DECLARATION:
+                printf("Record Declaration: %s\n",
+                       node->record_declaration.name);
+                for (size_t i = 0; i < node->record_declaration.field_count;
+                     i++) {
+                    print_indent(depth + 1);
+                    printf("Field %zu: %s\n", i,
+                           node->record_declaration.field_names[i]);
+                }
+                break;
+
+            case AST_FIELD_ACCESS:
+                printf("Field Access: %s (slot %d)\n",
+                       node->field_access.field_name, node->field_access.slot);
+                print_indent(depth + 1);
+                printf("Record:\n");
+                print_ast(node->field_access.object, depth + 2);
+                break;
+
             case AST_ARRAY_OPERATION:
                 printf("Array Operation: %s\n", node->array_operation.operator);
                 print_indent(depth + 1);
@@ -444,6 +653,11 @@ void print_ast(ASTNode *node, int depth) {
                 print_indent(depth + 1);
                 printf("Index:\n");
                 print_ast(node->array_index_access.index, depth + 2);
+                if (node->array_index_access.column) {
+                    print_indent(depth + 1);
+                    printf("Column:\n");
+                    print_ast(node->array_index_access.column, depth + 2);
+                }
                 break;
 
             case AST_ARRAY_SLICE_ACCESS:
@@ -481,6 +695,15 @@ void print_ast(ASTNode *node, int depth) {
                 printf("Variable Reference: %s\n", node->variable_name);
                 break;
 
+            case AST_INLINE_ARGUMENT:
+                printf("Inlined Argument: %zu\n", node->inline_argument);
+                break;
+
+            case AST_INVARIANT:
+                printf("Loop Invariant (slot %zu):\n", node->invariant.slot);
+                print_ast(node->invariant.expression, depth + 1);
+                break;
+
             case AST_IMPORT:
                 printf("Import Statement:\n");
                 print_indent(depth + 1);
@@ -7,6 +7,10 @@
 
 void free_ast(ASTNode *node);
 
+// Traversal (a visitor may replace the node in the slot it's given)
+typedef void (*ASTChildVisitor)(ASTNode **slot, void *context);
+void ast_for_each_child(ASTNode *node, ASTChildVisitor visit, void *context);
+
 // Print indentation based on depth
 void print_indent(int depth);
 
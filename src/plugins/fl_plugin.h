@@ -7,6 +7,7 @@ extern "C" {
 
 // Relative paths aren't used since these reference header files
 // from within the tarball that gets generated via the Makefile
+#include "interpreter/flavor_string.h"     // string values
 #include "interpreter/interpreter_types.h" // internal types
 #include "interpreter/utils.h"
 #include "shared/ast_types.h" // for ASTNode, etc.
@@ -29,9 +29,14 @@ typedef enum {
     AST_ARRAY_OPERATION,
     AST_ARRAY_INDEX_ACCESS,
     AST_ARRAY_SLICE_ACCESS,
+    AST_MAP_LITERAL,
+    AST_RECORD_DECLARATION,
+    AST_FIELD_ACCESS,
     AST_VARIABLE_REFERENCE,
     AST_IMPORT,
-    AST_EXPORT
+    AST_EXPORT,
+    AST_INLINE_ARGUMENT, // Only in inlined copies of function bodies
+    AST_INVARIANT        // Wraps a loop-invariant expression (see hoist.c)
 } ASTNodeType;
 
 // Literal Node
@@ -88,8 +93,27 @@ typedef struct {
     struct ASTNode *condition;
     int re_evaluate_condition;
     struct ASTNode *body;
+
+    // Set once the loop's invariant expressions have been wrapped in
+    // `AST_INVARIANT` nodes (`hoist_enter()`), `hoisted_count` of them
+    bool hoist_analyzed;
+    size_t hoisted_count;
 } ASTWhileLoop;
 
+// Reduction declared by a parallel `for` loop (e.g. `sum(total)`)
+typedef enum {
+    REDUCE_SUM,
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_APPEND
+} ReductionKind;
+
+typedef struct ASTReduction {
+    ReductionKind kind;
+    char *variable_name;
+    struct ASTReduction *next;
+} ASTReduction;
+
 // AST For Loop Node
 typedef struct {
     char *loop_variable;
@@ -99,12 +123,18 @@ typedef struct {
     struct ASTNode *end_expr;
     bool inclusive;
     struct ASTNode *step_expr;
+    bool is_parallel;         // `for i in 0..n parallel sum(total) { ... }`
+    ASTReduction *reductions; // Linked list, may be NULL
 
     // Iterables
     bool is_iterable_loop;           // true if `for X in Y`
     struct ASTNode *collection_expr; // e.g. `recipes` or any expression
 
     struct ASTNode *body;
+
+    // As for `while` loops
+    bool hoist_analyzed;
+    size_t hoisted_count;
 } ASTForLoop;
 
 // AST Function Parameter
@@ -124,6 +154,21 @@ typedef struct {
 typedef struct {
     struct ASTNode *function_ref; // Expression representing the function
     struct ASTNode *arguments;    // Function call arguments
+
+    // The function this call resolved to last time, trusted while no function
+    // has been declared or freed since (`cached_version`). If nothing but
+    // functions is named like the callee (`cached_direct`), the name isn't
+    // even looked up again.
+    struct Function *cached_function;
+    size_t cached_version;
+    bool cached_direct;
+
+    // `inlined_function`'s `deliver` expression, inlined for this call site
+    // (NULL if it can't be), valid while it's still the cached function &
+    // `inlined_version` matches the cache (`inlined_call_body()`)
+    struct ASTNode *inlined_body;
+    struct Function *inlined_function;
+    size_t inlined_version;
 } ASTFunctionCall;
 
 // AST Function Return Node
@@ -158,10 +203,34 @@ typedef struct {
     size_t count;              // Number of elements
 } ASTArrayLiteral;
 
+// AST Map Literal Node
+typedef struct {
+    struct ASTNode **keys;   // Array of key expressions
+    struct ASTNode **values; // Array of value expressions
+    size_t count;            // Number of entries
+} ASTMapLiteral;
+
+// AST Record Declaration Node
+typedef struct {
+    char *name;
+    char **field_names; // In slot order
+    size_t *field_ids;  // Parser-wide id of each field name
+    size_t field_count;
+} ASTRecordDeclaration;
+
+// AST Field Access Node (`record.field`)
+typedef struct {
+    struct ASTNode *object; // The record expression
+    char *field_name;
+    size_t field_id; // Parser-wide id of `field_name`
+    int slot;        // Slot resolved at parse time, or -1 if ambiguous
+} ASTFieldAccess;
+
 // AST Index Access Node
 typedef struct {
-    struct ASTNode *array; // The array expression
-    struct ASTNode *index; // The index expression
+    struct ASTNode *array;  // The array expression
+    struct ASTNode *index;  // The index expression
+    struct ASTNode *column; // Second index for matrices (`m[i, j]`), or NULL
 } ASTArrayIndexAccess;
 
 // AST Slice Access Node
@@ -186,6 +255,18 @@ typedef struct {
     struct ASTNode *decl; // Declaration node that's being exported
 } ASTExport;
 
+// AST Loop-Invariant Expression Node
+typedef struct {
+    struct ASTNode *expression; // The wrapped expression (its `next` is the
+                                // wrapper's)
+    struct ASTNode *loop;       // The loop it doesn't change in
+    size_t slot;                // Where the loop keeps its value
+
+    // Set if the loop modifies arrays, maps or records in place: the value is
+    // then only kept if the expression reads none
+    bool guarded;
+} ASTInvariant;
+
 // AST Node Structure
 typedef struct ASTNode {
     ASTNodeType type;
@@ -231,13 +312,24 @@ typedef struct ASTNode {
         ASTArrayIndexAccess array_index_access;
         ASTArraySliceAccess array_slice_access;
 
+        // Map Nodes
+        ASTMapLiteral map_literal;
+
+        // Record Nodes
+        ASTRecordDeclaration record_declaration;
+        ASTFieldAccess field_access;
+
         // Literal and Reference
         LiteralNode literal;
-        char *variable_name; // For AST_VARIABLE_REFERENCE
+        char *variable_name;    // For AST_VARIABLE_REFERENCE
+        size_t inline_argument; // For AST_INLINE_ARGUMENT (parameter index)
 
         // Import & Export
         ASTImport import;
         ASTExport export;
+
+        // Loop Optimization
+        ASTInvariant invariant;
     };
 
     struct ASTNode *next;
@@ -1,10 +1,36 @@
 #ifndef DATA_TYPES_H
 #define DATA_TYPES_H
 
-typedef long double FLOAT_SIZE; // 64-bit to 128-bit
-typedef long long int INT_SIZE; // 64-bit
+// Floats are IEEE 754 doubles by default. Building with
+// `-DFLAVOR_LONG_DOUBLE` (`make FLOAT_PROFILE=long`) uses `long double`
+// instead, which is x87 extended precision on x86 but is slower & makes
+// every value twice as big.
+#ifdef FLAVOR_LONG_DOUBLE
+typedef long double FLOAT_SIZE; // 80-bit (or 128-bit) extended
 
 #define FLOAT_FORMAT "%Lf"
+#define FLOAT_PARSE strtold
+#define FLOAT_FLOOR floorl
+#define FLOAT_CEIL ceill
+#define FLOAT_ROUND roundl
+#define FLOAT_ABS fabsl
+#define FLOAT_MOD fmodl
+#define FLOAT_POW powl
+#else
+typedef double FLOAT_SIZE; // 64-bit
+
+#define FLOAT_FORMAT "%f"
+#define FLOAT_PARSE strtod
+#define FLOAT_FLOOR floor
+#define FLOAT_CEIL ceil
+#define FLOAT_ROUND round
+#define FLOAT_ABS fabs
+#define FLOAT_MOD fmod
+#define FLOAT_POW pow
+#endif
+
+typedef long long int INT_SIZE; // 64-bit
+
 #define INT_FORMAT "%lld"
 
 #endif